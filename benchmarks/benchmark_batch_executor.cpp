@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/batch_executor.h"
+
+namespace benchmark_batch_executor {
+
+using std::cout;
+using BatchExecutor = batch_executor::BatchExecutor<double>;
+using CostModel = BatchExecutor::CostModel;
+using Solver = BatchExecutor::Solver;
+using DynamicMatrix = BatchExecutor::DynamicMatrix;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_sizes[] = {100, 200, 400};
+// Sizes of the jobs of the batch, submitted smallest first.
+constexpr const int batch_sizes[] = {50, 50, 100, 100, 100, 150, 200, 300};
+
+// Predicted and measured time of single jobs after calibration.
+void run_predictions(const CostModel& model) {
+  for (Solver solver : {Solver::kSchurDecomposition,
+                        Solver::kSymmetricSchurDecomposition}) {
+    for (int size : matrix_sizes) {
+      BatchExecutor executor(input_precision, model, 1);
+      DynamicMatrix data = DynamicMatrix::Random(size, size);
+      data += data.transpose().eval();
+      int job = executor.submit(data, solver, true);
+      executor.run();
+      const BatchExecutor::Result& result = executor.get_result(job);
+      cout << metrics_registry::solver_name(solver) << "\tsize " << size
+           << "\tpredicted: " << result.estimate.seconds
+           << " s\tmeasured: " << result.seconds << " s\n";
+    }
+  }
+}
+
+void run_batch(const CostModel& model) {
+  int threads = std::max(2, batch_executor::default_number_of_threads());
+  BatchExecutor executor(input_precision, model, threads);
+  for (int size : batch_sizes) {
+    executor.submit(DynamicMatrix::Random(size, size),
+                    Solver::kSchurDecomposition, true);
+  }
+  double predicted = executor.predict_seconds();
+  Clock::time_point start = Clock::now();
+  executor.run();
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  cout << "batch of " << std::size(batch_sizes) << " jobs on " << threads
+       << " threads\tpredicted: " << predicted
+       << " s\tmeasured: " << elapsed.count() << " s\n";
+}
+
+void run() {
+  cout << "Batch executor benchmark\n";
+  std::srand(0);
+  CostModel model;
+  model.calibrate(input_precision);
+  run_predictions(model);
+  run_batch(model);
+  cout << "\n";
+}
+
+}  // namespace benchmark_batch_executor
@@ -0,0 +1,3 @@
+namespace benchmark_batch_executor {
+void run();
+}  // namespace benchmark_batch_executor
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/diagonal_plus_low_rank.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+
+namespace benchmark_diagonal_plus_low_rank {
+
+using std::cout;
+using DiagonalPlusLowRank = diagonal_plus_low_rank::DiagonalPlusLowRank<double>;
+using LowRankEigenbasis = DiagonalPlusLowRank::LowRankEigenbasis;
+using DynamicMatrix = DiagonalPlusLowRank::DynamicMatrix;
+using DynamicVector = DiagonalPlusLowRank::DynamicVector;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-14;
+constexpr const int matrix_sizes[] = {200, 400, 800};
+constexpr const int ranks[] = {1, 4, 16};
+
+double measure_dense(const DynamicVector& diagonal,
+                     const DynamicMatrix& factor) {
+  Clock::time_point start = Clock::now();
+  DynamicMatrix data = diagonal.asDiagonal();
+  data += factor * factor.transpose();
+  DynamicVector eigenvalues;
+  DynamicMatrix unitary;
+  schur_decomposition_symmetric::SchurDecomposition<double>(input_precision)
+      .run_in_place(&data, &eigenvalues, &unitary);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+double measure_low_rank(const DynamicVector& diagonal,
+                        const DynamicMatrix& factor) {
+  Clock::time_point start = Clock::now();
+  DynamicVector eigenvalues;
+  LowRankEigenbasis basis;
+  DiagonalPlusLowRank(input_precision)
+      .run(diagonal, factor, &eigenvalues, &basis);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+void run() {
+  cout << "Diagonal plus low rank benchmark\n";
+  std::srand(0);
+  for (int size : matrix_sizes) {
+    DynamicVector diagonal = DynamicVector::Random(size);
+    cout << "size " << size << "\tdense: "
+         << measure_dense(diagonal, DynamicMatrix::Random(size, 1)) << " s\n";
+    for (int rank : ranks) {
+      cout << "\trank " << rank << "\tsecular equation: "
+           << measure_low_rank(diagonal, DynamicMatrix::Random(size, rank))
+           << " s\n";
+    }
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_diagonal_plus_low_rank
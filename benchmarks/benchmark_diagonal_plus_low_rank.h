@@ -0,0 +1,3 @@
+namespace benchmark_diagonal_plus_low_rank {
+void run();
+}  // namespace benchmark_diagonal_plus_low_rank
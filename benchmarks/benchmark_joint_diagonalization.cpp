@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/joint_diagonalization.h"
+
+namespace benchmark_joint_diagonalization {
+
+using std::cout;
+using JointDiagonalization =
+    joint_diagonalization::JointDiagonalization<double>;
+using DynamicMatrix = JointDiagonalization::DynamicMatrix;
+using DynamicVector = Eigen::Matrix<double, -1, 1>;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-14;
+constexpr const int matrix_sizes[] = {32, 64, 128};
+constexpr const int number_of_matrices = 64;
+
+std::vector<DynamicMatrix> generate_matrices(int size) {
+  DynamicMatrix common =
+      DynamicMatrix::Random(size, size).householderQr().householderQ();
+  std::vector<DynamicMatrix> matrices;
+  for (int index = 0; index < number_of_matrices; ++index) {
+    DynamicVector diagonal = DynamicVector::Random(size);
+    matrices.push_back(common * diagonal.asDiagonal() * common.transpose());
+  }
+  return matrices;
+}
+
+void run_size(int size, int threads) {
+  std::vector<DynamicMatrix> matrices = generate_matrices(size);
+  DynamicMatrix basis;
+  JointDiagonalization algorithm(input_precision, 100, threads);
+  Clock::time_point start = Clock::now();
+  algorithm.run(&matrices, &basis);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  cout << "size " << size << "\t" << number_of_matrices << " matrices\t"
+       << threads << " threads\tsweeps: " << algorithm.get_sweeps()
+       << "\ttime: " << elapsed.count() << " s\n";
+}
+
+void run() {
+  cout << "Joint diagonalization benchmark\n";
+  std::srand(0);
+  int threads = joint_diagonalization::default_number_of_threads();
+  for (int size : matrix_sizes) {
+    run_size(size, 1);
+    if (threads > 1) {
+      run_size(size, threads);
+    }
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_joint_diagonalization
@@ -0,0 +1,3 @@
+namespace benchmark_joint_diagonalization {
+void run();
+}  // namespace benchmark_joint_diagonalization
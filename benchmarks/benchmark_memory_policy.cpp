@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/memory_policy.h"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+#include "perf_counter.h"
+
+namespace benchmark_memory_policy {
+
+using std::cout;
+using DefaultAllocator = memory_policy::DefaultAllocator<double>;
+using HugePageAllocator = memory_policy::HugePageAllocator<double>;
+using DynamicMatrix = DefaultAllocator::DynamicMatrix;
+using DynamicVector = Eigen::Matrix<double, -1, 1>;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_sizes[] = {128, 256, 512};
+
+struct Measurement {
+  double seconds;
+  std::uint64_t tlb_misses;
+};
+
+template <class Algorithm, class Output>
+Measurement measure(Algorithm* algorithm, const DynamicMatrix& data) {
+  perf_counter::TlbMissCounter counter;
+  Output result;
+  DynamicMatrix unitary;
+  Clock::time_point start = Clock::now();
+  counter.start();
+  algorithm->run(data, &result, &unitary);
+  std::uint64_t misses = counter.stop();
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return {elapsed.count(), misses};
+}
+
+void print_row(const char* name, int size, const Measurement& base,
+               const Measurement& huge, bool counters_available) {
+  cout << name << "\tsize " << size << "\t4K pages: " << base.seconds
+       << " s\t2M pages: " << huge.seconds << " s";
+  if (counters_available) {
+    cout << "\tdTLB misses: " << base.tlb_misses << " -> " << huge.tlb_misses;
+    if (base.tlb_misses > 0) {
+      cout << " (" << 100. * (1. - double(huge.tlb_misses) / base.tlb_misses)
+           << "% fewer)";
+    }
+  }
+  cout << "\n";
+}
+
+void run_nonsymmetric(int size, bool counters_available) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  schur_decomposition::SchurDecomposition<double, DefaultAllocator> base(
+      input_precision);
+  schur_decomposition::SchurDecomposition<double, HugePageAllocator> huge(
+      input_precision);
+  print_row("SchurDecomposition", size,
+            measure<decltype(base), DynamicMatrix>(&base, data),
+            measure<decltype(huge), DynamicMatrix>(&huge, data),
+            counters_available);
+}
+
+void run_symmetric(int size, bool counters_available) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += (DynamicMatrix)data.transpose();
+  schur_decomposition_symmetric::SchurDecomposition<double, DefaultAllocator>
+      base(input_precision);
+  schur_decomposition_symmetric::SchurDecomposition<double, HugePageAllocator>
+      huge(input_precision);
+  print_row("SchurDecomposition (symmetric)", size,
+            measure<decltype(base), DynamicVector>(&base, data),
+            measure<decltype(huge), DynamicVector>(&huge, data),
+            counters_available);
+}
+
+void run() {
+  bool counters_available = perf_counter::TlbMissCounter().is_available();
+  cout << "Memory policy benchmark (default vs huge page allocator)\n";
+  if (!counters_available) {
+    cout << "dTLB miss counters are not available, reporting time only\n";
+  }
+  for (int size : matrix_sizes) {
+    std::srand(size);
+    run_nonsymmetric(size, counters_available);
+    run_symmetric(size, counters_available);
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_memory_policy
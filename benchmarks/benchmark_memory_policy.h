@@ -0,0 +1,3 @@
+namespace benchmark_memory_policy {
+void run();
+}  // namespace benchmark_memory_policy
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/quadratic_eigenvalue.h"
+
+namespace benchmark_quadratic_eigenvalue {
+
+using std::cout;
+using QuadraticEigensolver =
+    quadratic_eigenvalue::QuadraticEigensolver<double>;
+using DynamicMatrix = QuadraticEigensolver::DynamicMatrix;
+using ComplexVector = QuadraticEigensolver::ComplexVector;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-14;
+constexpr const int matrix_sizes[] = {50, 100, 200};
+
+// The 2n x 2n pencil (A, B) of the first companion form with QZ, the
+// approach the solver replaces.
+double measure_pencil(const DynamicMatrix& mass, const DynamicMatrix& damping,
+                      const DynamicMatrix& stiffness) {
+  int size = mass.rows();
+  Clock::time_point start = Clock::now();
+  DynamicMatrix first = DynamicMatrix::Zero(2 * size, 2 * size);
+  DynamicMatrix second = DynamicMatrix::Identity(2 * size, 2 * size);
+  first.topRightCorner(size, size).setIdentity();
+  first.bottomLeftCorner(size, size) = -stiffness;
+  first.bottomRightCorner(size, size) = -damping;
+  second.bottomRightCorner(size, size) = mass;
+  Eigen::RealQZ<DynamicMatrix> qz(first, second, false);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+double measure_solver(const DynamicMatrix& mass, const DynamicMatrix& damping,
+                      const DynamicMatrix& stiffness) {
+  Clock::time_point start = Clock::now();
+  ComplexVector eigenvalues;
+  QuadraticEigensolver(input_precision)
+      .run(mass, damping, stiffness, &eigenvalues);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+void run() {
+  cout << "Quadratic eigenvalue benchmark\n";
+  std::srand(0);
+  for (int size : matrix_sizes) {
+    DynamicMatrix mass = DynamicMatrix::Random(size, size);
+    DynamicMatrix damping = DynamicMatrix::Random(size, size);
+    DynamicMatrix stiffness = DynamicMatrix::Random(size, size);
+    cout << "size " << size << "\tpencil with QZ: "
+         << measure_pencil(mass, damping, stiffness)
+         << " s\tstructured linearization: "
+         << measure_solver(mass, damping, stiffness) << " s\n";
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_quadratic_eigenvalue
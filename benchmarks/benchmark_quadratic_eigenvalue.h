@@ -0,0 +1,3 @@
+namespace benchmark_quadratic_eigenvalue {
+void run();
+}  // namespace benchmark_quadratic_eigenvalue
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_dispatcher.h"
+
+namespace benchmark_schur_dispatcher {
+
+using std::cout;
+using Path = schur_dispatcher::Path;
+using Thresholds = schur_dispatcher::Thresholds;
+using SchurDispatcher = schur_dispatcher::SchurDispatcher<double>;
+using DynamicMatrix = SchurDispatcher::DynamicMatrix;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_sizes[] = {3, 4, 16, 64, 128, 256, 384, 512};
+constexpr const int repetitions = 3;
+
+// Thresholds under which choose_path() picks path for the given size, if
+// the path applies to it at all.
+Thresholds force(Path path, int size) {
+  Thresholds thresholds;
+  thresholds.fixed_size_max = path == Path::kFixedSize ? size : 0;
+  thresholds.aggressive_size_min = path == Path::kAggressiveDeflation
+                                       ? 0
+                                       : std::numeric_limits<int>::max();
+  return thresholds;
+}
+
+double measure(const DynamicMatrix& data, Path path) {
+  SchurDispatcher dispatcher(input_precision, force(path, data.rows()));
+  DynamicMatrix schur_form;
+  DynamicMatrix unitary;
+  double best = 0;
+  for (int repetition = 0; repetition < repetitions; ++repetition) {
+    Clock::time_point start = Clock::now();
+    dispatcher.run(data, &schur_form, &unitary);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (repetition == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+void run_size(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  cout << "size " << size;
+  for (Path path : {Path::kFixedSize, Path::kDoubleShift,
+                    Path::kAggressiveDeflation}) {
+    if (path == Path::kFixedSize && size > schur_dispatcher::fixed_size_limit) {
+      continue;
+    }
+    cout << "\t" << schur_dispatcher::path_name(path) << ": "
+         << measure(data, path) << " s";
+  }
+  SchurDispatcher dispatcher(input_precision);
+  cout << "\t-> " << schur_dispatcher::path_name(dispatcher.choose_path(size))
+       << "\n";
+}
+
+void run() {
+  cout << "Schur dispatcher benchmark (best of " << repetitions
+       << " runs)\n";
+  for (int size : matrix_sizes) {
+    std::srand(size);
+    run_size(size);
+  }
+  Thresholds tuned = SchurDispatcher::tune(input_precision);
+  cout << "tuned: fixed_size_max " << tuned.fixed_size_max
+       << ", aggressive_size_min " << tuned.aggressive_size_min << "\n\n";
+}
+
+}  // namespace benchmark_schur_dispatcher
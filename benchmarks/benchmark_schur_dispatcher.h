@@ -0,0 +1,3 @@
+namespace benchmark_schur_dispatcher {
+void run();
+}  // namespace benchmark_schur_dispatcher
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../eigen/Eigen/Sparse"
+#include "../schur_decomposition/shift_invert.h"
+
+namespace benchmark_shift_invert {
+
+using std::cout;
+using ShiftInvertSolver = shift_invert::ShiftInvertSolver<double>;
+using SparseMatrix = ShiftInvertSolver::SparseMatrix;
+using DynamicMatrix = ShiftInvertSolver::DynamicMatrix;
+using DynamicVector = ShiftInvertSolver::DynamicVector;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int grid_sizes[] = {15, 20, 30};
+constexpr const int count = 6;
+constexpr const double shift = 1.;
+
+// The 5-point Laplacian on a grid x grid mesh.
+SparseMatrix generate_laplacian(int grid) {
+  std::vector<Eigen::Triplet<double>> entries;
+  for (int row = 0; row < grid; ++row) {
+    for (int col = 0; col < grid; ++col) {
+      int index = row * grid + col;
+      entries.emplace_back(index, index, 4.);
+      if (col + 1 < grid) {
+        entries.emplace_back(index, index + 1, -1.);
+        entries.emplace_back(index + 1, index, -1.);
+      }
+      if (row + 1 < grid) {
+        entries.emplace_back(index, index + grid, -1.);
+        entries.emplace_back(index + grid, index, -1.);
+      }
+    }
+  }
+  SparseMatrix data(grid * grid, grid * grid);
+  data.setFromTriplets(entries.begin(), entries.end());
+  return data;
+}
+
+double measure_dense(const SparseMatrix& data) {
+  Clock::time_point start = Clock::now();
+  DynamicMatrix dense = data;
+  Eigen::SelfAdjointEigenSolver<DynamicMatrix> solver(dense);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+double measure_shift_invert(const SparseMatrix& data) {
+  Clock::time_point start = Clock::now();
+  DynamicVector eigenvalues;
+  DynamicMatrix eigenvectors;
+  ShiftInvertSolver(input_precision)
+      .run_symmetric(data, shift, count, &eigenvalues, &eigenvectors);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+void run() {
+  cout << "Shift-invert benchmark, " << count << " eigenpairs near "
+       << shift << "\n";
+  for (int grid : grid_sizes) {
+    SparseMatrix data = generate_laplacian(grid);
+    cout << "size " << grid * grid << "\tdense: " << measure_dense(data)
+         << " s\tshift-invert: " << measure_shift_invert(data) << " s\n";
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_shift_invert
@@ -0,0 +1,3 @@
+namespace benchmark_shift_invert {
+void run();
+}  // namespace benchmark_shift_invert
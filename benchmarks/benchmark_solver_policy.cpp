@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/givens_rotation.h"
+#include "../schur_decomposition/hessenberg_reduction.h"
+#include "../schur_decomposition/householder_reflection.h"
+#include "../schur_decomposition/memory_policy.h"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+#include "../schur_decomposition/solver_policy.h"
+#include "../schur_decomposition/tridiagonal_symmetric.h"
+
+namespace benchmark_solver_policy {
+
+using std::cout;
+using DefaultAllocator = memory_policy::DefaultAllocator<double>;
+using Algorithm = schur_decomposition::SchurDecomposition<double>;
+using EigenvaluesAlgorithm =
+    schur_decomposition::SchurDecomposition<double, DefaultAllocator,
+                                            solver_policy::SkipUnitary>;
+using SymmetricAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<double>;
+using SymmetricEigenvaluesAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<
+        double, DefaultAllocator, solver_policy::SkipUnitary>;
+using HessenbergReduction = hessenberg_reduction::HessenbergReduction<double>;
+using HouseholderReflector =
+    householder_reflection::HouseholderReflector<double>;
+using Rotator = givens_rotation::GivensRotator<double>;
+using TridiagonalSymmetric =
+    tridiagonal_symmetric::TridiagonalSymmetric<double>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
+using Vector3 = Algorithm::Vector3;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_sizes[] = {64, 128, 256};
+constexpr const int repetitions = 5;
+
+// The eigenvalues-only solvers written out by hand, with the Francis double
+// shift, the Wilkinson shift and the neighbour deflation inlined. They make
+// the same operations as the policy-based solvers, so the outputs agree
+// bitwise and any difference in time is the cost of the policies.
+void hand_written_schur_form(const DynamicMatrix& data,
+                             DynamicMatrix* schur_form) {
+  DynamicMatrix& h = *schur_form;
+  h = data;
+  HessenbergReduction().run(&h, nullptr);
+  int size = h.rows();
+  int last = size - 1;
+  auto is_negligible = [&](int index) {
+    return std::abs(h(index, index - 1)) <=
+           input_precision *
+               (std::abs(h(index - 1, index - 1)) + std::abs(h(index, index)));
+  };
+  auto deflate = [&] {
+    while (last >= 1) {
+      if (is_negligible(last)) {
+        h(last, last - 1) = 0;
+        last -= 1;
+      } else if (last >= 2 && is_negligible(last - 1)) {
+        h(last - 1, last - 2) = 0;
+        last -= 2;
+      } else {
+        break;
+      }
+    }
+  };
+  auto reflect = [&](const HouseholderReflector& reflector, int step,
+                     int length) {
+    int first = std::max(step, 0);
+    reflector.reflect_left(h.block(step + 1, first, length, size - first));
+    reflector.reflect_right(
+        h.block(0, step + 1, std::min(last, step + 4) + 1, length));
+  };
+  if (last >= 2) {
+    deflate();
+  }
+  while (last >= 2) {
+    auto corner = h.block(last - 1, last - 1, 2, 2);
+    double trace = corner.trace();
+    double det = corner.determinant();
+    Vector3 column;
+    column(0) = h(0, 0) * h(0, 0) + h(0, 1) * h(1, 0) - trace * h(0, 0) + det;
+    column(1) = h(1, 0) * (h(0, 0) + h(1, 1) - trace);
+    column(2) = h(1, 0) * h(2, 1);
+    reflect(HouseholderReflector(column), -1, 3);
+    int step = 0;
+    for (; step <= last - 3; ++step) {
+      DynamicVector bulge = h.block(step + 1, step, 3, 1);
+      reflect(HouseholderReflector(bulge), step, 3);
+    }
+    DynamicVector bulge = h.block(step + 1, step, 2, 1);
+    reflect(HouseholderReflector(bulge), step, 2);
+    deflate();
+  }
+}
+
+void hand_written_eigenvalues(const DynamicMatrix& data,
+                              DynamicVector* eigenvalues) {
+  DynamicMatrix hessenberg_form = data;
+  HessenbergReduction().run(&hessenberg_form, nullptr);
+  TridiagonalSymmetric diagonals =
+      TridiagonalSymmetric::extract_diagonals(hessenberg_form);
+  DynamicVector& major = diagonals.get_major_diagonal();
+  DynamicVector& side = diagonals.get_side_diagonal();
+  double bulge = 0;
+  int begin = 0;
+  auto is_negligible = [&](int index) {
+    return std::abs(side(index - 1)) <=
+           input_precision *
+               (std::abs(major(index - 1)) + std::abs(major(index)));
+  };
+  auto rotate = [&](const Rotator& rotator, int step) {
+    DynamicMatrix square(2, 2);
+    square << major(step), side(step), side(step), major(step + 1);
+    rotator.rotate_left(&square);
+    rotator.rotate_right(&square);
+    major(step) = square(0, 0);
+    major(step + 1) = square(1, 1);
+    side(step) = square(0, 1);
+    if (step > begin) {
+      side(step - 1) *= rotator.cos();
+      side(step - 1) += rotator.sin() * bulge;
+    }
+  };
+  int last = diagonals.get_size() - 1;
+  while (last >= 1 && is_negligible(last)) {
+    --last;
+  }
+  while (last >= 1) {
+    for (begin = last - 1; begin > 0 && !is_negligible(begin); --begin) {
+    }
+    if (begin > 0) {
+      side(begin - 1) = 0;
+    }
+    double shift = solver_policy::WilkinsonShift<double>::find_shift(
+        major, side, last, input_precision);
+    Rotator rotator(major(begin) - shift, side(begin));
+    rotate(rotator, begin);
+    if (last > begin + 1) {
+      bulge = side(begin + 1) * rotator.sin();
+      side(begin + 1) *= rotator.cos();
+    }
+    for (int step = begin + 1; step <= last - 1; ++step) {
+      rotator = Rotator(side(step - 1), bulge);
+      rotate(rotator, step);
+      if (step != last - 1) {
+        bulge = side(step + 1) * rotator.sin();
+        side(step + 1) *= rotator.cos();
+      }
+    }
+    while (last >= 1 && is_negligible(last)) {
+      --last;
+    }
+  }
+  *eigenvalues = major;
+}
+
+template <class Run>
+double measure(Run run) {
+  double best = 0;
+  for (int repetition = 0; repetition < repetitions; ++repetition) {
+    Clock::time_point start = Clock::now();
+    run();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (repetition == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+void print_row(const char* name, int size, double runtime, double policy,
+               double hand_written, bool identical) {
+  cout << name << "\tsize " << size << "\tnullptr unitary: " << runtime
+       << " s\tSkipUnitary: " << policy << " s\thand-written: "
+       << hand_written << " s\t(" << 100. * (policy / hand_written - 1.)
+       << "% overhead, outputs " << (identical ? "identical" : "differ")
+       << ")\n";
+}
+
+void run_nonsymmetric(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  DynamicMatrix runtime_result;
+  DynamicMatrix policy_result;
+  DynamicMatrix hand_written_result;
+  Algorithm algorithm(input_precision);
+  EigenvaluesAlgorithm eigenvalues_algorithm(input_precision);
+  double runtime = measure([&] { algorithm.run(data, &runtime_result); });
+  double policy = measure(
+      [&] { eigenvalues_algorithm.run(data, &policy_result); });
+  double hand_written = measure(
+      [&] { hand_written_schur_form(data, &hand_written_result); });
+  print_row("SchurDecomposition", size, runtime, policy, hand_written,
+            policy_result == hand_written_result &&
+                runtime_result == hand_written_result);
+}
+
+void run_symmetric(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += data.transpose().eval();
+  DynamicVector runtime_result;
+  DynamicVector policy_result;
+  DynamicVector hand_written_result;
+  SymmetricAlgorithm algorithm(input_precision);
+  SymmetricEigenvaluesAlgorithm eigenvalues_algorithm(input_precision);
+  double runtime = measure([&] { algorithm.run(data, &runtime_result); });
+  double policy = measure(
+      [&] { eigenvalues_algorithm.run(data, &policy_result); });
+  double hand_written = measure(
+      [&] { hand_written_eigenvalues(data, &hand_written_result); });
+  print_row("SchurDecomposition (symmetric)", size, runtime, policy,
+            hand_written,
+            policy_result == hand_written_result &&
+                runtime_result == hand_written_result);
+}
+
+void run() {
+  cout << "Solver policy benchmark (eigenvalues only, best of "
+       << repetitions << " runs)\n";
+  for (int size : matrix_sizes) {
+    std::srand(size);
+    run_nonsymmetric(size);
+    run_symmetric(size);
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_solver_policy
@@ -0,0 +1,3 @@
+namespace benchmark_solver_policy {
+void run();
+}  // namespace benchmark_solver_policy
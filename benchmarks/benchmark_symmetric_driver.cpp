@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/symmetric_driver.h"
+
+namespace benchmark_symmetric_driver {
+
+using std::cout;
+using Crossovers = symmetric_driver::Crossovers;
+using Engine = symmetric_driver::Engine;
+using SymmetricDriver = symmetric_driver::SymmetricDriver<double>;
+using DynamicMatrix = SymmetricDriver::DynamicMatrix;
+using DynamicVector = SymmetricDriver::DynamicVector;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_sizes[] = {4, 6, 8, 12, 16, 32, 64, 128, 256};
+// Parts of the spectrum requested, as a fraction of the size.
+constexpr const double fractions[] = {0.1, 0.25, 0.5, 1.};
+constexpr const int repetitions = 3;
+
+// Crossovers under which choose_engine() picks engine for any request of
+// the matching kind.
+Crossovers force(Engine engine) {
+  Crossovers crossovers;
+  crossovers.jacobi_size_max = engine == Engine::kJacobi ? 1 << 30 : 0;
+  crossovers.jacobi_offdiagonal_ratio = 0;
+  crossovers.bisection_fraction = engine == Engine::kBisection ? 1 : -1;
+  crossovers.compact_fraction = engine == Engine::kCompactQR ? 1 : -1;
+  crossovers.pipelined_size_min =
+      engine == Engine::kPipelinedQR ? 0 : 1 << 30;
+  return crossovers;
+}
+
+double measure(const DynamicMatrix& data, Engine engine, int count,
+               bool vectors) {
+  // The pipelined QR needs two threads even on a single core.
+  SymmetricDriver driver(
+      input_precision, force(engine),
+      std::max(2, symmetric_driver::default_number_of_threads()));
+  DynamicVector eigenvalues;
+  DynamicMatrix eigenvectors;
+  double best = 0;
+  for (int repetition = 0; repetition < repetitions; ++repetition) {
+    Clock::time_point start = Clock::now();
+    driver.run(data, &eigenvalues, vectors ? &eigenvectors : nullptr, 0,
+               count);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (repetition == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+void run_size(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += data.transpose().eval();
+  for (double fraction : fractions) {
+    int count = std::max(1, int(fraction * size));
+    for (bool vectors : {false, true}) {
+      Engine engines[] = {Engine::kJacobi, Engine::kImplicitQR,
+                          vectors ? Engine::kCompactQR : Engine::kBisection,
+                          Engine::kPipelinedQR};
+      cout << "size " << size << "\tcount " << count
+           << (vectors ? "\tvectors" : "\tvalues ");
+      for (Engine engine : engines) {
+        cout << "\t" << symmetric_driver::engine_name(engine) << ": "
+             << measure(data, engine, count, vectors) << " s";
+      }
+      SymmetricDriver driver(input_precision);
+      cout << "\t-> " << symmetric_driver::engine_name(driver.choose_engine(
+                             data, count, vectors))
+           << "\n";
+    }
+  }
+}
+
+void run() {
+  cout << "Symmetric driver benchmark (best of " << repetitions
+       << " runs, " << symmetric_driver::default_number_of_threads()
+       << " threads)\n";
+  for (int size : matrix_sizes) {
+    std::srand(size);
+    run_size(size);
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_symmetric_driver
@@ -0,0 +1,3 @@
+namespace benchmark_symmetric_driver {
+void run();
+}  // namespace benchmark_symmetric_driver
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/tridiagonal_nonsymmetric.h"
+
+namespace benchmark_tridiagonal_nonsymmetric {
+
+using std::cout;
+using AberthSolver = tridiagonal_nonsymmetric::AberthSolver<double>;
+using TridiagonalNonsymmetric = AberthSolver::TridiagonalNonsymmetric;
+using DenseAlgorithm = schur_decomposition::SchurDecomposition<double>;
+using DynamicMatrix = TridiagonalNonsymmetric::DynamicMatrix;
+using ComplexVector = AberthSolver::ComplexVector;
+using Clock = std::chrono::steady_clock;
+
+constexpr const double input_precision = 1e-14;
+constexpr const int matrix_sizes[] = {64, 128, 256, 512, 1024, 2048};
+// The dense solver is skipped above this size.
+constexpr const int dense_size_max = 512;
+
+TridiagonalNonsymmetric make_matrix(int size) {
+  std::mt19937 gen(size);
+  std::uniform_real_distribution<double> entries(-1, 1);
+  TridiagonalNonsymmetric data(size);
+  for (int index = 0; index < size; ++index) {
+    data.get_major_diagonal()(index) = entries(gen);
+  }
+  for (int index = 0; index + 1 < size; ++index) {
+    data.get_upper_diagonal()(index) = entries(gen);
+    data.get_lower_diagonal()(index) = entries(gen);
+  }
+  return data;
+}
+
+template <class Work>
+double measure(const Work& work) {
+  Clock::time_point start = Clock::now();
+  work();
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+void run_size(int size) {
+  TridiagonalNonsymmetric data = make_matrix(size);
+  AberthSolver solver(input_precision);
+  ComplexVector eigenvalues;
+  double aberth = measure([&]() { solver.run(data, &eigenvalues); });
+  cout << "size " << size << "\taberth: " << aberth << " s ("
+       << solver.get_iterations() << " iterations)";
+  if (size <= dense_size_max) {
+    DynamicMatrix dense = data.to_dense();
+    DynamicMatrix schur_form;
+    double schur = measure([&]() {
+      DenseAlgorithm(input_precision).run(dense, &schur_form);
+      DenseAlgorithm::extract_eigenvalues(schur_form, &eigenvalues);
+    });
+    cout << "\tdense schur: " << schur << " s";
+  }
+  cout << "\n";
+}
+
+void run() {
+  cout << "Nonsymmetric tridiagonal eigenvalues benchmark\n";
+  for (int size : matrix_sizes) {
+    run_size(size);
+  }
+  cout << "\n";
+}
+
+}  // namespace benchmark_tridiagonal_nonsymmetric
@@ -0,0 +1,3 @@
+namespace benchmark_tridiagonal_nonsymmetric {
+void run();
+}  // namespace benchmark_tridiagonal_nonsymmetric
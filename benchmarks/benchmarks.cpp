@@ -0,0 +1,39 @@
+#include <fstream>
+#include <iostream>
+
+#include "../schur_decomposition/trace_recorder.h"
+#include "benchmark_batch_executor.h"
+#include "benchmark_diagonal_plus_low_rank.h"
+#include "benchmark_joint_diagonalization.h"
+#include "benchmark_memory_policy.h"
+#include "benchmark_quadratic_eigenvalue.h"
+#include "benchmark_schur_dispatcher.h"
+#include "benchmark_shift_invert.h"
+#include "benchmark_solver_policy.h"
+#include "benchmark_symmetric_driver.h"
+#include "benchmark_tridiagonal_nonsymmetric.h"
+
+// Usage: bench [trace.json]
+// With an argument, the solver spans of all benchmarks are exported to the
+// given file in the Chrome trace format.
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    trace_recorder::TraceRecorder::instance().enable();
+  }
+  benchmark_memory_policy::run();
+  benchmark_solver_policy::run();
+  benchmark_symmetric_driver::run();
+  benchmark_schur_dispatcher::run();
+  benchmark_tridiagonal_nonsymmetric::run();
+  benchmark_batch_executor::run();
+  benchmark_joint_diagonalization::run();
+  benchmark_quadratic_eigenvalue::run();
+  benchmark_diagonal_plus_low_rank::run();
+  benchmark_shift_invert::run();
+  if (argc > 1) {
+    std::ofstream out(argv[1]);
+    trace_recorder::TraceRecorder::instance().export_chrome_trace(out);
+    std::cout << "Trace written to " << argv[1] << "\n";
+  }
+  return 0;
+}
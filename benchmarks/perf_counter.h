@@ -0,0 +1,82 @@
+#ifndef _BENCHMARKS_PERF_COUNTER_H
+#define _BENCHMARKS_PERF_COUNTER_H
+
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace perf_counter {
+
+// Counts data TLB load misses of the calling thread. Counting silently stays
+// unavailable when the kernel or the sandbox does not expose the hardware
+// event (see is_available()).
+class TlbMissCounter {
+ public:
+  TlbMissCounter() { open_counter(); }
+
+  TlbMissCounter(const TlbMissCounter&) = delete;
+  TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+  ~TlbMissCounter() {
+#if defined(__linux__)
+    if (is_available()) {
+      close(file_descriptor_);
+    }
+#endif
+  }
+
+  bool is_available() const { return file_descriptor_ >= 0; }
+
+  void start() {
+#if defined(__linux__)
+    if (is_available()) {
+      ioctl(file_descriptor_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(file_descriptor_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  std::uint64_t stop() {
+    std::uint64_t misses = 0;
+#if defined(__linux__)
+    if (is_available()) {
+      ioctl(file_descriptor_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(file_descriptor_, &misses, sizeof(misses)) != sizeof(misses)) {
+        misses = 0;
+      }
+    }
+#endif
+    return misses;
+  }
+
+ private:
+  void open_counter() {
+#if defined(__linux__)
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HW_CACHE;
+    attributes.config = PERF_COUNT_HW_CACHE_DTLB |
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    file_descriptor_ = static_cast<int>(
+        syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+  }
+
+  int file_descriptor_ = -1;
+};
+
+}  // namespace perf_counter
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef _SCHUR_DECOMPOSITION_BATCH_EXECUTOR_H
+#define _SCHUR_DECOMPOSITION_BATCH_EXECUTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "cost_model.h"
+#include "hessenberg_reduction.h"
+#include "schur_decomposition.h"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+
+namespace batch_executor {
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs a batch of independent decompositions on a pool of threads, one job
+// per thread at a time.
+//
+// Jobs start in decreasing order of the time predicted by the cost model,
+// the largest-first rule of list scheduling: a long job that started last
+// would leave the other threads idle while it finishes. Every job owns its
+// matrix, so the solvers work in place and a job's peak memory is that of
+// the in-place variant.
+template <typename Scalar>
+class BatchExecutor {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using CostModel = cost_model::CostModel<Scalar>;
+  using Estimate = cost_model::Estimate;
+  using Solver = cost_model::Solver;
+  using Variant = cost_model::Variant;
+  using DynamicMatrix = CostModel::DynamicMatrix;
+  using DynamicVector = CostModel::DynamicVector;
+  using Clock = std::chrono::steady_clock;
+
+  struct Result {
+    // Schur form for kSchurDecomposition, Hessenberg form for
+    // kHessenbergReduction, empty for kSymmetricSchurDecomposition.
+    DynamicMatrix schur_form;
+    // Eigenvalues for kSymmetricSchurDecomposition only.
+    DynamicVector eigenvalues;
+    // Empty unless the job asked for it.
+    DynamicMatrix unitary;
+    Estimate estimate;
+    double seconds = 0;
+  };
+
+  BatchExecutor(Precision precision, CostModel cost_model = CostModel(),
+                int number_of_threads = default_number_of_threads())
+      : precision_(precision),
+        cost_model_(std::move(cost_model)),
+        number_of_threads_(number_of_threads) {
+    assert(precision >= 0);
+    assert(number_of_threads >= 1);
+  }
+
+  // Returns the index of the job, by which its result is read after run().
+  int submit(DynamicMatrix data, Solver solver, bool need_unitary) {
+    assert(data.rows() == data.cols());
+    Job job;
+    job.solver = solver;
+    job.need_unitary = need_unitary;
+    job.estimate = cost_model_.estimate(
+        solver, data.rows(),
+        need_unitary ? Variant::kInPlace : Variant::kInPlaceEigenvaluesOnly);
+    job.data = std::move(data);
+    jobs_.push_back(std::move(job));
+    results_.emplace_back();
+    return jobs_.size() - 1;
+  }
+
+  // Runs the jobs submitted since the previous run().
+  void run() {
+    trace_recorder::TraceSpan span("batch", "batch_executor",
+                                   jobs_.size() - first_pending_);
+    order_ = schedule();
+    std::atomic<int> next = 0;
+    auto work = [&]() {
+      for (int position = next++; position < int(order_.size());
+           position = next++) {
+        run_job(order_[position]);
+      }
+    };
+    int threads = std::min<int>(number_of_threads_, order_.size());
+    std::vector<std::thread> workers;
+    for (int thread = 1; thread < threads; ++thread) {
+      workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    first_pending_ = jobs_.size();
+  }
+
+  // Predicted wall time of the pending jobs when run() starts them in its
+  // order on the threads.
+  double predict_seconds() const {
+    std::vector<double> finish_times(number_of_threads_, 0.);
+    for (int job : schedule()) {
+      auto earliest =
+          std::min_element(finish_times.begin(), finish_times.end());
+      *earliest += jobs_[job].estimate.seconds;
+    }
+    return *std::max_element(finish_times.begin(), finish_times.end());
+  }
+
+  const Result& get_result(int job) const {
+    assert(job >= 0 && job < first_pending_);
+    return results_[job];
+  }
+
+  // Jobs of the last run() in the order they started.
+  const std::vector<int>& get_order() const { return order_; }
+
+  const CostModel& get_cost_model() const { return cost_model_; }
+
+  int get_number_of_threads() const { return number_of_threads_; }
+
+ private:
+  struct Job {
+    DynamicMatrix data;
+    Solver solver;
+    bool need_unitary;
+    Estimate estimate;
+  };
+
+  // Pending jobs by decreasing predicted time, ties in submission order.
+  std::vector<int> schedule() const {
+    std::vector<int> order(jobs_.size() - first_pending_);
+    std::iota(order.begin(), order.end(), first_pending_);
+    std::stable_sort(order.begin(), order.end(), [&](int left, int right) {
+      return jobs_[left].estimate.seconds > jobs_[right].estimate.seconds;
+    });
+    return order;
+  }
+
+  void run_job(int index) {
+    Job& job = jobs_[index];
+    Result& result = results_[index];
+    DynamicMatrix* unitary = job.need_unitary ? &result.unitary : nullptr;
+    Clock::time_point start = Clock::now();
+    switch (job.solver) {
+      case Solver::kSchurDecomposition:
+        schur_decomposition::SchurDecomposition<Scalar>(precision_)
+            .run_in_place(&job.data, unitary);
+        result.schur_form = std::move(job.data);
+        break;
+      case Solver::kSymmetricSchurDecomposition:
+        schur_decomposition_symmetric::SchurDecomposition<Scalar>(precision_)
+            .run_in_place(&job.data, &result.eigenvalues, unitary);
+        job.data.resize(0, 0);
+        break;
+      case Solver::kHessenbergReduction:
+        hessenberg_reduction::HessenbergReduction<Scalar>().run(&job.data,
+                                                                unitary);
+        result.schur_form = std::move(job.data);
+        break;
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    result.estimate = job.estimate;
+    result.seconds = elapsed.count();
+  }
+
+  Precision precision_;
+  CostModel cost_model_;
+  int number_of_threads_;
+  std::vector<Job> jobs_;
+  std::vector<Result> results_;
+  std::vector<int> order_;
+  int first_pending_ = 0;
+};
+
+}  // namespace batch_executor
+
+#endif
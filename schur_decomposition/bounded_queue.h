@@ -0,0 +1,60 @@
+#ifndef _SCHUR_DECOMPOSITION_BOUNDED_QUEUE_H
+#define _SCHUR_DECOMPOSITION_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace bounded_queue {
+
+// Queue between one producer and one consumer thread that holds at most
+// capacity items, so that a producer reading input ahead of the consumer
+// keeps a bounded amount of it in memory.
+template <class Item>
+class BoundedQueue {
+ public:
+  BoundedQueue(int capacity) : capacity_(capacity) { assert(capacity >= 1); }
+
+  // Blocks while the queue is full.
+  void push(Item item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&]() { return int(items_.size()) < capacity_; });
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  // No item is pushed after close().
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_closed_ = true;
+    not_empty_.notify_one();
+  }
+
+  // Blocks while the queue is empty and open; returns false once it is
+  // empty and closed.
+  bool pop(Item* item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [&]() { return !items_.empty() || is_closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    *item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  int get_capacity() const { return capacity_; }
+
+ private:
+  int capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Item> items_;
+  bool is_closed_ = false;
+};
+
+}  // namespace bounded_queue
+
+#endif
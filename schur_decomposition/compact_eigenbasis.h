@@ -0,0 +1,162 @@
+#ifndef _SCHUR_DECOMPOSITION_COMPACT_EIGENBASIS_H
+#define _SCHUR_DECOMPOSITION_COMPACT_EIGENBASIS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "givens_rotation.h"
+#include "householder_reflection.h"
+
+namespace compact_eigenbasis {
+
+// Eigenbasis of the symmetric solver kept as the factors it is made of:
+// V = P_0 P_1 ... P_{n-3} G_1 G_2 ... G_m, where P_k is the reflector of the
+// tridiagonalization acting on the indices k + 1, ... and every QR sweep
+// contributes the rotations G of its bulge chase, which act on the indices
+// (step, step + 1) for step = first, first + 1, ... in order, where first is
+// the top of the unreduced block the sweep runs on.
+//
+// Recording costs O(n) per sweep instead of the O(n^2) update of a dense
+// basis, and V is applied to an n x k block in O(k (n^2 + rotations)).
+// Each rotation keeps its cosine and sine, so the storage is proportional to
+// the number of rotations, which for a full spectrum is a small multiple of
+// n^2; the dense basis is formed only on request.
+template <typename Scalar>
+class CompactEigenbasis {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using HouseholderReflector =
+      householder_reflection::HouseholderReflector<Scalar>;
+  using Rotator = givens_rotation::GivensRotator<Scalar>;
+  using DynamicMatrix = HouseholderReflector::DynamicMatrix;
+  using DynamicVector = HouseholderReflector::DynamicVector;
+
+  struct Rotation {
+    Scalar cos;
+    Scalar sin;
+  };
+
+  void reset(int size) {
+    assert(size >= 0);
+    size_ = size;
+    reflectors_.clear();
+    rotations_.clear();
+    sweep_lengths_.clear();
+    sweep_starts_.clear();
+  }
+
+  void set_reflectors(std::vector<HouseholderReflector> reflectors) {
+    assert(int(reflectors.size()) <= std::max(size_ - 2, 0));
+    reflectors_ = std::move(reflectors);
+  }
+
+  void start_sweep(int first_step = 0) {
+    assert(first_step >= 0 && first_step + 1 < size_);
+    sweep_lengths_.push_back(0);
+    sweep_starts_.push_back(first_step);
+  }
+
+  // Rotations must come in the order of the chase, starting from the first
+  // step of the sweep.
+  void add_rotation(const Rotator& rotator) {
+    assert(!sweep_lengths_.empty());
+    assert(sweep_starts_.back() + sweep_lengths_.back() + 1 < size_);
+    rotations_.push_back({rotator.cos(), rotator.sin()});
+    ++sweep_lengths_.back();
+  }
+
+  // block = V * block.
+  void apply(DynamicMatrix* block) const {
+    assert(block);
+    assert(block->rows() == size_);
+    DynamicMatrix rows = block->transpose();
+    std::size_t end = rotations_.size();
+    for (int sweep = int(sweep_lengths_.size()) - 1; sweep >= 0; --sweep) {
+      std::size_t begin = end - sweep_lengths_[sweep];
+      for (int step = sweep_lengths_[sweep] - 1; step >= 0; --step) {
+        const Rotation& rotation = rotations_[begin + step];
+        rotate(rotation.cos, -rotation.sin, sweep_starts_[sweep] + step,
+               &rows);
+      }
+      end = begin;
+    }
+    *block = rows.transpose();
+    for (int index = int(reflectors_.size()) - 1; index >= 0; --index) {
+      reflect(index, block);
+    }
+  }
+
+  // block = V^T * block.
+  void apply_transpose(DynamicMatrix* block) const {
+    assert(block);
+    assert(block->rows() == size_);
+    for (int index = 0; index < int(reflectors_.size()); ++index) {
+      reflect(index, block);
+    }
+    DynamicMatrix rows = block->transpose();
+    std::size_t begin = 0;
+    for (int sweep = 0; sweep < int(sweep_lengths_.size()); ++sweep) {
+      for (int step = 0; step < sweep_lengths_[sweep]; ++step) {
+        const Rotation& rotation = rotations_[begin + step];
+        rotate(rotation.cos, rotation.sin, sweep_starts_[sweep] + step,
+               &rows);
+      }
+      begin += sweep_lengths_[sweep];
+    }
+    *block = rows.transpose();
+  }
+
+  void materialize(DynamicMatrix* unitary) const {
+    assert(unitary);
+    *unitary = DynamicMatrix::Identity(size_, size_);
+    apply(unitary);
+  }
+
+  int get_size() const { return size_; }
+
+  int get_sweeps_count() const { return sweep_lengths_.size(); }
+
+  std::size_t get_rotations_count() const { return rotations_.size(); }
+
+  std::size_t get_storage_bytes() const {
+    std::size_t bytes = rotations_.size() * sizeof(Rotation) +
+                        2 * sweep_lengths_.size() * sizeof(int);
+    for (const HouseholderReflector& reflector : reflectors_) {
+      bytes += reflector.direction().size() * sizeof(Scalar);
+    }
+    return bytes;
+  }
+
+ private:
+  void reflect(int index, DynamicMatrix* block) const {
+    int length = size_ - index - 1;
+    reflectors_[index].reflect_left(block->bottomRows(length));
+  }
+
+  // Rows of the block are the columns of its transpose, so each rotation
+  // works on two contiguous columns:
+  // (x, y) = (cos x + sin y, -sin x + cos y).
+  static void rotate(Scalar cos, Scalar sin, int step, DynamicMatrix* rows) {
+    auto first = rows->col(step);
+    auto second = rows->col(step + 1);
+    for (int index = 0; index < rows->rows(); ++index) {
+      Scalar x = first(index);
+      Scalar y = second(index);
+      first(index) = cos * x + sin * y;
+      second(index) = cos * y - sin * x;
+    }
+  }
+
+  int size_ = 0;
+  std::vector<HouseholderReflector> reflectors_;
+  std::vector<Rotation> rotations_;
+  std::vector<int> sweep_lengths_;
+  std::vector<int> sweep_starts_;
+};
+
+}  // namespace compact_eigenbasis
+
+#endif
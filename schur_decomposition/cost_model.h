@@ -0,0 +1,170 @@
+#ifndef _SCHUR_DECOMPOSITION_COST_MODEL_H
+#define _SCHUR_DECOMPOSITION_COST_MODEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+
+#include "../eigen/Eigen/Dense"
+#include "hessenberg_reduction.h"
+#include "memory_budget.h"
+#include "metrics_registry.h"
+#include "schur_decomposition.h"
+#include "schur_decomposition_symmetric.h"
+
+namespace cost_model {
+
+using Solver = metrics_registry::Solver;
+using Variant = memory_budget::Variant;
+
+struct Estimate {
+  double flops = 0;
+  double bytes_moved = 0;
+  std::size_t peak_bytes = 0;
+  double seconds = 0;
+};
+
+inline bool has_unitary(Variant variant) {
+  return variant == Variant::kFull || variant == Variant::kInPlace;
+}
+
+// Leading terms of the flop counts in Golub and Van Loan, Matrix
+// Computations, 4th ed., table 7.5.2 and section 8.3.
+inline double count_flops(Solver solver, int size, bool unitary) {
+  double cube = double(size) * size * size;
+  switch (solver) {
+    case Solver::kSchurDecomposition:
+      return (unitary ? 25. : 10.) * cube;
+    case Solver::kSymmetricSchurDecomposition:
+      return (unitary ? 9. : 4. / 3) * cube;
+    case Solver::kHessenbergReduction:
+      return (unitary ? 14. / 3 : 10. / 3) * cube;
+  }
+  return 0;
+}
+
+// Time, traffic and memory of one decomposition predicted from its size.
+//
+// The kernels are unblocked, so every multiply-add reads and writes one
+// matrix entry and the bytes moved are sizeof(Scalar) per flop. The wall
+// time is flops / rate with one rate per solver and per presence of the
+// unitary; the default rates are rough, and calibrate() measures them on
+// the current machine. The peak memory is memory_budget's prediction.
+template <typename Scalar>
+class CostModel {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+  using DynamicVector = Eigen::Matrix<Scalar, -1, 1>;
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr const double default_flop_rate = 1e9;
+
+  CostModel() {
+    for (auto& rates : flop_rates_) {
+      for (double& rate : rates) {
+        rate = default_flop_rate;
+      }
+    }
+  }
+
+  Estimate estimate(Solver solver, int size, Variant variant) const {
+    assert(size >= 0);
+    bool unitary = has_unitary(variant);
+    Estimate estimate;
+    estimate.flops = count_flops(solver, size, unitary);
+    estimate.bytes_moved = estimate.flops * sizeof(Scalar);
+    estimate.peak_bytes =
+        memory_budget::predict_peak_bytes<Scalar>(variant, size);
+    estimate.seconds = estimate.flops / get_flop_rate(solver, unitary);
+    return estimate;
+  }
+
+  double get_flop_rate(Solver solver, bool unitary) const {
+    return flop_rates_[int(solver)][unitary];
+  }
+
+  void set_flop_rate(Solver solver, bool unitary, double rate) {
+    assert(rate > 0);
+    flop_rates_[int(solver)][unitary] = rate;
+  }
+
+  // Times every solver with and without unitary on random matrices of the
+  // given sizes and sets each rate to the total flops over the total time,
+  // so that the largest sizes weigh the most.
+  void calibrate(Precision precision,
+                 std::initializer_list<int> sizes = {64, 128, 256},
+                 int repetitions = 2) {
+    assert(repetitions >= 1);
+    for (Solver solver : {Solver::kSchurDecomposition,
+                          Solver::kSymmetricSchurDecomposition,
+                          Solver::kHessenbergReduction}) {
+      for (bool unitary : {false, true}) {
+        double flops = 0;
+        double seconds = 0;
+        for (int size : sizes) {
+          flops += count_flops(solver, size, unitary);
+          seconds += measure(precision, solver, size, unitary, repetitions);
+        }
+        if (seconds > 0) {
+          set_flop_rate(solver, unitary, flops / seconds);
+        }
+      }
+    }
+  }
+
+ private:
+  static double measure(Precision precision, Solver solver, int size,
+                        bool unitary, int repetitions) {
+    DynamicMatrix data = DynamicMatrix::Random(size, size);
+    if (solver == Solver::kSymmetricSchurDecomposition) {
+      data += data.transpose().eval();
+    }
+    double best = 0;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+      Clock::time_point start = Clock::now();
+      run(precision, solver, data, unitary);
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+      if (repetition == 0 || elapsed.count() < best) {
+        best = elapsed.count();
+      }
+    }
+    return best;
+  }
+
+  static void run(Precision precision, Solver solver,
+                  const DynamicMatrix& data, bool unitary) {
+    DynamicMatrix result;
+    DynamicMatrix transform;
+    if (solver == Solver::kSchurDecomposition) {
+      schur_decomposition::SchurDecomposition<Scalar> algorithm(precision);
+      if (unitary) {
+        algorithm.run(data, &result, &transform);
+      } else {
+        algorithm.run(data, &result);
+      }
+    } else if (solver == Solver::kSymmetricSchurDecomposition) {
+      schur_decomposition_symmetric::SchurDecomposition<Scalar> algorithm(
+          precision);
+      DynamicVector eigenvalues;
+      if (unitary) {
+        algorithm.run(data, &eigenvalues, &transform);
+      } else {
+        algorithm.run(data, &eigenvalues);
+      }
+    } else {
+      result = data;
+      hessenberg_reduction::HessenbergReduction<Scalar>().run(
+          &result, unitary ? &transform : nullptr);
+    }
+  }
+
+  double flop_rates_[metrics_registry::solvers_count][2];
+};
+
+}  // namespace cost_model
+
+#endif
@@ -0,0 +1,546 @@
+#ifndef _SCHUR_DECOMPOSITION_DIAGONAL_PLUS_LOW_RANK_H
+#define _SCHUR_DECOMPOSITION_DIAGONAL_PLUS_LOW_RANK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "trace_recorder.h"
+
+namespace diagonal_plus_low_rank {
+
+// Eigenbasis of D + U U^T kept as the factors it is made of:
+// V = P_0 S_1 S_2 ... S_r, where P_0 sorts D and the step S_j of the rank
+// one update by the column j of U is S_j = G E P: the rotations G of the
+// deflation, the Cauchy-like matrix E of the eigenvectors of the updated
+// (non-deflated) part and the permutation P that sorts the new
+// eigenvalues.
+//
+// E is not stored: its entries w_k / (d_k - mu_i) / |column i| are formed
+// from the O(n) numbers of the step in panels of panel_size columns while
+// it is applied, so V costs O(r n) memory and is applied to an n x k block
+// in O(r k n^2).
+template <typename Scalar>
+class LowRankEigenbasis {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+  using DynamicVector = Eigen::Matrix<Scalar, -1, 1>;
+
+  // The rotation of the indices (first, second) that zeroes the weight of
+  // first: (x_first, x_second) = (cos x_first - sin x_second,
+  // sin x_first + cos x_second) on the weights.
+  struct Rotation {
+    int first;
+    int second;
+    Scalar cos;
+    Scalar sin;
+  };
+
+  struct Step {
+    std::vector<Rotation> rotations;
+    // Indices of the updated eigenvalues, in increasing order.
+    std::vector<int> updated;
+    // The poles d_k, the old updated eigenvalues, and the recomputed
+    // weights w_k of the secular equation.
+    DynamicVector poles;
+    DynamicVector weights;
+    // The new eigenvalue i is poles(origins[i]) + offsets(i); the
+    // differences d_k - mu_i are formed from these without cancellation.
+    std::vector<int> origins;
+    DynamicVector offsets;
+    DynamicVector inverse_norms;
+    // Sorted position -> index before sorting.
+    std::vector<int> order;
+  };
+
+  static constexpr const int panel_size = 64;
+
+  void reset(std::vector<int> order) {
+    order_ = std::move(order);
+    steps_.clear();
+  }
+
+  void add_step(Step step) {
+    assert(int(step.order.size()) == get_size());
+    steps_.push_back(std::move(step));
+  }
+
+  // block = V * block.
+  void apply(DynamicMatrix* block) const {
+    assert(block);
+    assert(block->rows() == get_size());
+    for (int index = int(steps_.size()) - 1; index >= 0; --index) {
+      apply_step(steps_[index], block);
+    }
+    scatter(order_, block);
+  }
+
+  // block = V^T * block.
+  void apply_transpose(DynamicMatrix* block) const {
+    assert(block);
+    assert(block->rows() == get_size());
+    gather(order_, block);
+    for (const Step& step : steps_) {
+      apply_step_transpose(step, block);
+    }
+  }
+
+  // out receives the eigenvectors first, ..., first + count - 1 in the
+  // order of the eigenvalues.
+  void get_eigenvectors(int first, int count, DynamicMatrix* out) const {
+    assert(out);
+    assert(first >= 0 && count >= 0 && first + count <= get_size());
+    out->setZero(get_size(), count);
+    out->middleRows(first, count).setIdentity();
+    apply(out);
+  }
+
+  void materialize(DynamicMatrix* unitary) const {
+    get_eigenvectors(0, get_size(), unitary);
+  }
+
+  int get_size() const { return order_.size(); }
+
+  int get_steps_count() const { return steps_.size(); }
+
+  std::size_t get_storage_bytes() const {
+    std::size_t bytes = order_.size() * sizeof(int);
+    for (const Step& step : steps_) {
+      bytes += step.rotations.size() * sizeof(Rotation) +
+               (step.updated.size() + step.origins.size() +
+                step.order.size()) *
+                   sizeof(int) +
+               (step.poles.size() + step.weights.size() +
+                step.offsets.size() + step.inverse_norms.size()) *
+                   sizeof(Scalar);
+    }
+    return bytes;
+  }
+
+  // block = S * block for the factor S of step.
+  static void apply_step(const Step& step, DynamicMatrix* block) {
+    scatter(step.order, block);
+    int updated = step.updated.size();
+    if (updated > 0) {
+      DynamicMatrix rows = gather_rows(step.updated, *block);
+      DynamicMatrix result = DynamicMatrix::Zero(updated, block->cols());
+      for (int first = 0; first < updated; first += panel_size) {
+        int count = std::min(panel_size, updated - first);
+        result.noalias() +=
+            cauchy_panel(step, first, count) * rows.middleRows(first, count);
+      }
+      scatter_rows(step.updated, result, block);
+    }
+    for (auto it = step.rotations.rbegin(); it != step.rotations.rend();
+         ++it) {
+      rotate(it->cos, it->sin, it->first, it->second, block);
+    }
+  }
+
+  // block = S^T * block for the factor S of step.
+  static void apply_step_transpose(const Step& step, DynamicMatrix* block) {
+    for (const Rotation& rotation : step.rotations) {
+      rotate(rotation.cos, -rotation.sin, rotation.first, rotation.second,
+             block);
+    }
+    int updated = step.updated.size();
+    if (updated > 0) {
+      DynamicMatrix rows = gather_rows(step.updated, *block);
+      DynamicMatrix result(updated, block->cols());
+      for (int first = 0; first < updated; first += panel_size) {
+        int count = std::min(panel_size, updated - first);
+        result.middleRows(first, count).noalias() =
+            cauchy_panel(step, first, count).transpose() * rows;
+      }
+      scatter_rows(step.updated, result, block);
+    }
+    gather(step.order, block);
+  }
+
+ private:
+  // Columns first, ..., first + count - 1 of E.
+  static DynamicMatrix cauchy_panel(const Step& step, int first, int count) {
+    int updated = step.updated.size();
+    DynamicMatrix panel(updated, count);
+    for (int column = 0; column < count; ++column) {
+      int root = first + column;
+      Scalar origin = step.poles(step.origins[root]);
+      for (int row = 0; row < updated; ++row) {
+        panel(row, column) = step.weights(row) /
+                             ((step.poles(row) - origin) - step.offsets(root)) *
+                             step.inverse_norms(root);
+      }
+    }
+    return panel;
+  }
+
+  // (x_first, x_second) = (cos x_first + sin x_second,
+  // -sin x_first + cos x_second) on the rows of block.
+  static void rotate(Scalar cos, Scalar sin, int first, int second,
+                     DynamicMatrix* block) {
+    for (int column = 0; column < block->cols(); ++column) {
+      Scalar x = (*block)(first, column);
+      Scalar y = (*block)(second, column);
+      (*block)(first, column) = cos * x + sin * y;
+      (*block)(second, column) = cos * y - sin * x;
+    }
+  }
+
+  static DynamicMatrix gather_rows(const std::vector<int>& indices,
+                                   const DynamicMatrix& block) {
+    DynamicMatrix rows(indices.size(), block.cols());
+    for (int index = 0; index < int(indices.size()); ++index) {
+      rows.row(index) = block.row(indices[index]);
+    }
+    return rows;
+  }
+
+  static void scatter_rows(const std::vector<int>& indices,
+                           const DynamicMatrix& rows, DynamicMatrix* block) {
+    for (int index = 0; index < int(indices.size()); ++index) {
+      block->row(indices[index]) = rows.row(index);
+    }
+  }
+
+  // Row position of block moves to row order[position].
+  static void scatter(const std::vector<int>& order, DynamicMatrix* block) {
+    DynamicMatrix rows = *block;
+    scatter_rows(order, rows, block);
+  }
+
+  // Row order[position] of block moves to row position.
+  static void gather(const std::vector<int>& order, DynamicMatrix* block) {
+    *block = gather_rows(order, *block);
+  }
+
+  std::vector<int> order_;
+  std::vector<Step> steps_;
+};
+
+// Eigenvalues and eigenvectors of A = D + U U^T for a diagonal D and an
+// n x r factor U with r << n, without forming A.
+//
+// The columns of U are added one at a time. With the eigendecomposition
+// Q L Q^T of the matrix so far, adding u u^T leaves L + z z^T for
+// z = Q^T u, whose eigenvalues are the roots of the secular equation
+// 1 + sum_k z_k^2 / (l_k - mu) = 0, one between every two poles and one
+// above the largest. Before that the eigenvalues with a negligible z_k,
+// and one of two close poles after a rotation zeroes one of their weights,
+// are deflated: they are eigenvalues of the update already. Each root is
+// found by the rational two-pole iteration of Bunch, Nielsen and Sorensen
+// with bisection as a safeguard, in coordinates relative to its nearest
+// pole; the weights are then recomputed from the roots as in Gu and
+// Eisenstat, which makes the eigenvectors z_k / (l_k - mu) orthogonal to
+// working precision.
+//
+// A step costs O(n^2) for the roots and O(n^2) per column of U still to be
+// added, which is brought to the new basis, so O(r^2 n^2) in all instead of
+// the O(n^3) of the dense solver.
+template <typename Scalar>
+class DiagonalPlusLowRank {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using LowRankEigenbasis = diagonal_plus_low_rank::LowRankEigenbasis<Scalar>;
+  using Step = LowRankEigenbasis::Step;
+  using Rotation = LowRankEigenbasis::Rotation;
+  using DynamicMatrix = LowRankEigenbasis::DynamicMatrix;
+  using DynamicVector = LowRankEigenbasis::DynamicVector;
+
+  DiagonalPlusLowRank(Precision precision, int max_iterations = 200)
+      : precision_(precision), max_iterations_(max_iterations) {
+    assert(precision > 0);
+    assert(max_iterations >= 1);
+  }
+
+  // eigenvalues receives the eigenvalues in increasing order and basis, when
+  // not nullptr, the eigenvectors in the same order.
+  void run(const DynamicVector& diagonal, const DynamicMatrix& factor,
+           DynamicVector* eigenvalues, LowRankEigenbasis* basis = nullptr) {
+    assert(eigenvalues);
+    assert(factor.rows() == diagonal.rows());
+    int size = diagonal.rows();
+    trace_recorder::TraceSpan span("diagonal plus low rank",
+                                   "diagonal_plus_low_rank", size);
+    std::vector<int> order = sort_order(diagonal);
+    DynamicVector values(size);
+    DynamicMatrix remaining(size, factor.cols());
+    for (int position = 0; position < size; ++position) {
+      values(position) = diagonal(order[position]);
+      remaining.row(position) = factor.row(order[position]);
+    }
+    if (basis) {
+      basis->reset(std::move(order));
+    }
+    deflated_ = 0;
+    iterations_ = 0;
+    is_converged_ = true;
+    while (remaining.cols() > 0) {
+      Step step = update(remaining.col(0), &values);
+      remaining = remaining.rightCols(remaining.cols() - 1).eval();
+      LowRankEigenbasis::apply_step_transpose(step, &remaining);
+      if (basis) {
+        basis->add_step(std::move(step));
+      }
+    }
+    *eigenvalues = std::move(values);
+  }
+
+  // Eigenvalues deflated over all the steps of the last run().
+  int get_deflated() const { return deflated_; }
+
+  // Largest number of iterations taken by a root in the last run().
+  int get_iterations() const { return iterations_; }
+
+  // False when a root of the last run() stopped at max_iterations.
+  bool is_converged() const { return is_converged_; }
+
+ private:
+  static std::vector<int> sort_order(const DynamicVector& values) {
+    std::vector<int> order(values.rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int left, int right) {
+      return values(left) < values(right);
+    });
+    return order;
+  }
+
+  // Adds z z^T to the sorted eigenvalues values, which receive the sorted
+  // eigenvalues of the sum.
+  Step update(DynamicVector weights, DynamicVector* p_values) {
+    DynamicVector& values = *p_values;
+    int size = values.rows();
+    Step step;
+    Scalar norm = weights.norm();
+    Scalar scale = std::max(size > 0 ? values.cwiseAbs().maxCoeff() : 0,
+                            norm * norm);
+    Scalar tolerance = precision_ * scale;
+    int previous = -1;
+    for (int index = 0; index < size; ++index) {
+      // z_k e_k z^T is below the tolerance: the pair is an eigenpair.
+      if (std::abs(weights(index)) * norm <= tolerance) {
+        ++deflated_;
+        continue;
+      }
+      if (previous >= 0) {
+        Scalar length = std::hypot(weights(previous), weights(index));
+        Scalar cos = weights(index) / length;
+        Scalar sin = weights(previous) / length;
+        // The rotation that moves the weight of previous to index couples
+        // the two poles by cos sin (l_index - l_previous).
+        if (std::abs(cos * sin * (values(index) - values(previous))) <=
+            tolerance) {
+          Scalar first = values(previous);
+          Scalar second = values(index);
+          values(previous) = cos * cos * first + sin * sin * second;
+          values(index) = sin * sin * first + cos * cos * second;
+          weights(previous) = 0;
+          weights(index) = length;
+          step.rotations.push_back({previous, index, cos, sin});
+          step.updated.pop_back();
+          ++deflated_;
+        }
+      }
+      step.updated.push_back(index);
+      previous = index;
+    }
+    solve_secular_equation(values, weights, &step);
+    for (int root = 0; root < int(step.updated.size()); ++root) {
+      values(step.updated[root]) =
+          step.poles(step.origins[root]) + step.offsets(root);
+    }
+    step.order = sort_order(values);
+    DynamicVector sorted(size);
+    for (int position = 0; position < size; ++position) {
+      sorted(position) = values(step.order[position]);
+    }
+    values = std::move(sorted);
+    return step;
+  }
+
+  void solve_secular_equation(const DynamicVector& values,
+                              const DynamicVector& weights, Step* step) {
+    int updated = step->updated.size();
+    step->poles.resize(updated);
+    DynamicVector squares(updated);
+    for (int index = 0; index < updated; ++index) {
+      step->poles(index) = values(step->updated[index]);
+      squares(index) = weights(step->updated[index]) *
+                       weights(step->updated[index]);
+    }
+    step->origins.resize(updated);
+    step->offsets.resize(updated);
+    for (int root = 0; root < updated; ++root) {
+      find_root(step->poles, squares, root, &step->origins[root],
+                &step->offsets(root));
+    }
+    recompute_weights(weights, step);
+  }
+
+  // The root in (d_root, d_root+1), or above d_root for the last one, as
+  // d_origin + offset for the pole d_origin closer to it.
+  void find_root(const DynamicVector& poles, const DynamicVector& squares,
+                 int root, int* origin, Scalar* offset) {
+    int updated = poles.rows();
+    bool is_last = root + 1 == updated;
+    Scalar low = 0;
+    Scalar high = squares.sum();
+    *origin = root;
+    if (!is_last) {
+      Scalar half_gap = (poles(root + 1) - poles(root)) / 2;
+      DynamicVector shifted = poles.array() - poles(root);
+      if (evaluate(shifted, squares, root, half_gap).value < 0) {
+        *origin = root + 1;
+        low = (poles(root) - poles(root + 1)) / 2;
+        high = 0;
+      } else {
+        high = half_gap;
+      }
+    }
+    DynamicVector shifted = poles.array() - poles(*origin);
+    Scalar point = (low + high) / 2;
+    Scalar epsilon = std::numeric_limits<Scalar>::epsilon();
+    int iteration = 0;
+    for (; iteration < max_iterations_; ++iteration) {
+      Evaluation value = evaluate(shifted, squares, root, point);
+      if (std::abs(value.value) <= updated * epsilon * value.magnitude) {
+        break;
+      }
+      // f increases between the poles.
+      if (value.value > 0) {
+        high = point;
+      } else {
+        low = point;
+      }
+      if (high - low <= 2 * epsilon * std::max(std::abs(low), std::abs(high))) {
+        break;
+      }
+      Scalar next = point + model_step(shifted, root, is_last, point, value);
+      // A step out of the bracket, and every fourth step, bisects.
+      if (!(next > low && next < high) || iteration % 4 == 3) {
+        next = (low + high) / 2;
+      }
+      point = next;
+    }
+    iterations_ = std::max(iterations_, iteration);
+    is_converged_ = is_converged_ && iteration < max_iterations_;
+    *offset = point;
+  }
+
+  struct Evaluation {
+    // f = 1 + psi + phi, where psi sums the poles up to root and phi the
+    // poles above it.
+    Scalar value;
+    Scalar psi;
+    Scalar psi_derivative;
+    Scalar phi;
+    Scalar phi_derivative;
+    // Bound on the terms of f, for the rounding error of its evaluation.
+    Scalar magnitude;
+  };
+
+  static Evaluation evaluate(const DynamicVector& shifted,
+                             const DynamicVector& squares, int root,
+                             Scalar point) {
+    Evaluation result{0, 0, 0, 0, 0, 1};
+    for (int index = 0; index < shifted.rows(); ++index) {
+      Scalar inverse = 1 / (shifted(index) - point);
+      Scalar term = squares(index) * inverse;
+      if (index <= root) {
+        result.psi += term;
+        result.psi_derivative += term * inverse;
+      } else {
+        result.phi += term;
+        result.phi_derivative += term * inverse;
+      }
+      result.magnitude += std::abs(term);
+    }
+    result.value = 1 + result.psi + result.phi;
+    return result;
+  }
+
+  // Step to the root of the model that keeps the two poles next to the
+  // root, psi ~ p + q / (d_root - x) and phi ~ r + s / (d_root+1 - x), and
+  // matches the values and derivatives of psi and phi at point.
+  static Scalar model_step(const DynamicVector& shifted, int root,
+                           bool is_last, Scalar point,
+                           const Evaluation& value) {
+    Scalar below = shifted(root) - point;
+    Scalar p = value.psi - value.psi_derivative * below;
+    Scalar q = value.psi_derivative * below * below;
+    if (is_last) {
+      Scalar constant = 1 + p + value.phi;
+      return constant > 0 ? below + q / constant : 0;
+    }
+    Scalar above = shifted(root + 1) - point;
+    Scalar r = value.phi - value.phi_derivative * above;
+    Scalar s = value.phi_derivative * above * above;
+    // c (below - t) (above - t) + q (above - t) + s (below - t) = 0 for the
+    // step t, whose root between below < 0 < above is taken.
+    Scalar c = 1 + p + r;
+    Scalar b = c * (below + above) + q + s;
+    Scalar a = c * below * above + q * above + s * below;
+    Scalar root_of_discriminant = std::sqrt(std::max(b * b - 4 * c * a,
+                                                     Scalar(0)));
+    Scalar first = b >= 0 ? 2 * a / (b + root_of_discriminant)
+                          : (b - root_of_discriminant) / (2 * c);
+    Scalar second = b >= 0 ? (b + root_of_discriminant) / (2 * c)
+                           : 2 * a / (b - root_of_discriminant);
+    return first > below && first < above ? first : second;
+  }
+
+  // The weights w for which the computed roots are the exact eigenvalues of
+  // diag(d) + w w^T:
+  // w_k^2 = (mu_last - d_k) prod_{i < k} (mu_i - d_k) / (d_i - d_k)
+  //         prod_{k <= i < last} (mu_i - d_k) / (d_i+1 - d_k).
+  void recompute_weights(const DynamicVector& weights, Step* step) const {
+    int updated = step->updated.size();
+    step->weights.resize(updated);
+    auto difference = [&](int pole, int root) {
+      Scalar origin = step->poles(step->origins[root]);
+      return (step->poles(pole) - origin) - step->offsets(root);
+    };
+    for (int pole = 0; pole < updated; ++pole) {
+      Scalar square = -difference(pole, updated - 1);
+      for (int root = 0; root < pole; ++root) {
+        square *= difference(pole, root) /
+                  (step->poles(pole) - step->poles(root));
+      }
+      for (int root = pole; root + 1 < updated; ++root) {
+        square *= difference(pole, root) /
+                  (step->poles(pole) - step->poles(root + 1));
+      }
+      step->weights(pole) =
+          std::copysign(std::sqrt(std::abs(square)),
+                        weights(step->updated[pole]));
+    }
+    step->inverse_norms.resize(updated);
+    for (int root = 0; root < updated; ++root) {
+      Scalar sum = 0;
+      for (int pole = 0; pole < updated; ++pole) {
+        Scalar entry = step->weights(pole) / difference(pole, root);
+        sum += entry * entry;
+      }
+      step->inverse_norms(root) = 1 / std::sqrt(sum);
+    }
+  }
+
+  Precision precision_;
+  int max_iterations_;
+  int deflated_ = 0;
+  int iterations_ = 0;
+  bool is_converged_ = true;
+};
+
+}  // namespace diagonal_plus_low_rank
+
+#endif
@@ -61,6 +61,15 @@ class GivensRotator {
     old *= rotary_matrix_;
   }
 
+  // Rotates the columns first and second of out, which need not be adjacent,
+  // as rotate_right() rotates the two columns of a block.
+  void rotate_columns(DynamicMatrix* out, int first, int second) const {
+    assert(out);
+    assert(first != second);
+    out->applyOnTheRight(first, second,
+                         Eigen::JacobiRotation<Scalar>(cos(), -sin()));
+  }
+
   Scalar cos() const { return rotary_matrix_(0, 0); }
   Scalar sin() const { return rotary_matrix_(1, 0); }
 
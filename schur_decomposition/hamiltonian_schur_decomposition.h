@@ -0,0 +1,233 @@
+#ifndef _SCHUR_DECOMPOSITION_HAMILTONIAN_SCHUR_DECOMPOSITION_H
+#define _SCHUR_DECOMPOSITION_HAMILTONIAN_SCHUR_DECOMPOSITION_H
+
+#include <complex>
+
+#include "../eigen/Eigen/Dense"
+#include "givens_rotation.h"
+#include "householder_reflection.h"
+#include "schur_decomposition.h"
+#include "trace_recorder.h"
+
+namespace hamiltonian_schur_decomposition {
+
+// Eigenvalues of Hamiltonian matrices [A G; Q -A^T] (G, Q symmetric) and of
+// skew-Hamiltonian matrices [N K; L N^T] (K, L skew-symmetric), both 2n x 2n.
+//
+// A skew-Hamiltonian matrix is brought by a symplectic orthogonal similarity
+// U = [U_1 U_2; -U_2 U_1] to the Paige/Van Loan form [N' K'; 0 N'^T] with N'
+// upper Hessenberg, so its spectrum is that of N' taken twice and only n x n
+// QR sweeps are needed. A Hamiltonian matrix H goes through its square (Van
+// Loan's square-reduced method): H^2 is skew-Hamiltonian, and every
+// eigenvalue mu of H^2 gives the pair +-sqrt(mu) of H. The pairing is exact,
+// but eigenvalues of H much smaller than its norm lose up to half of their
+// digits to the squaring.
+template <typename Scalar>
+class HamiltonianSchurDecomposition {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Algorithm = schur_decomposition::SchurDecomposition<Scalar>;
+  using HouseholderReflector = Algorithm::HouseholderReflector;
+  using Rotator = givens_rotation::GivensRotator<Scalar>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using DynamicVector = Algorithm::DynamicVector;
+  using DynamicBlock = Algorithm::DynamicBlock;
+  using Complex = Algorithm::Complex;
+  using ComplexVector = Algorithm::ComplexVector;
+  using Precision = Scalar;
+
+  HamiltonianSchurDecomposition(Precision precision)
+      : precision_(precision) {
+    assert(precision >= 0);
+  }
+
+  // Returns n eigenvalues lambda of the Hamiltonian matrix, each with a
+  // nonnegative real part (a nonnegative imaginary part on the imaginary
+  // axis); the spectrum is made of the pairs lambda, -lambda.
+  void run(const DynamicMatrix& hamiltonian, ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    trace_recorder::TraceSpan span("hamiltonian schur decomposition",
+                                   "hamiltonian_schur_decomposition",
+                                   hamiltonian.rows());
+    square(hamiltonian, &reduced_form_);
+    ComplexVector squares;
+    decompose(&squares, nullptr);
+    eigenvalues->resize(squares.size());
+    for (int index = 0; index < squares.size(); ++index) {
+      (*eigenvalues)(index) = find_stable_root(squares(index));
+    }
+  }
+
+  // Returns the n eigenvalues of N', each of which appears twice in the
+  // spectrum of the skew-Hamiltonian matrix. unitary receives U and may be
+  // nullptr when it is not needed.
+  void run_skew_hamiltonian(const DynamicMatrix& data,
+                            ComplexVector* eigenvalues,
+                            DynamicMatrix* unitary) {
+    assert(eigenvalues);
+    assert(data.rows() == data.cols() && data.rows() % 2 == 0);
+    trace_recorder::TraceSpan span("skew-hamiltonian schur decomposition",
+                                   "hamiltonian_schur_decomposition",
+                                   data.rows());
+    reduced_form_ = data;
+    decompose(eigenvalues, unitary);
+  }
+
+  // Paige/Van Loan form of the last skew-Hamiltonian matrix reduced (the
+  // square of the Hamiltonian one for run()), with N' left in Hessenberg
+  // form.
+  const DynamicMatrix& get_reduced_form() const { return reduced_form_; }
+
+  // Full spectrum {lambda, -lambda} of a Hamiltonian matrix from the output
+  // of run().
+  static void complete_spectrum(const ComplexVector& eigenvalues,
+                                ComplexVector* spectrum) {
+    assert(spectrum);
+    int size = eigenvalues.size();
+    spectrum->resize(2 * size);
+    spectrum->head(size) = eigenvalues;
+    spectrum->tail(size) = -eigenvalues;
+  }
+
+  void set_precision(Precision precision) {
+    assert(precision >= 0);
+    precision_ = precision;
+  }
+
+  Precision get_precision() const { return precision_; }
+
+ private:
+  // H^2 = [A^2 + GQ, AG - GA^T; QA - A^TQ, (A^2 + GQ)^T] is assembled from
+  // the blocks so that its skew-symmetric blocks are exactly so.
+  static void square(const DynamicMatrix& hamiltonian, DynamicMatrix* out) {
+    assert(hamiltonian.rows() == hamiltonian.cols());
+    assert(hamiltonian.rows() % 2 == 0);
+    int half = hamiltonian.rows() / 2;
+    auto a = hamiltonian.topLeftCorner(half, half);
+    auto g = hamiltonian.topRightCorner(half, half);
+    auto q = hamiltonian.bottomLeftCorner(half, half);
+    DynamicMatrix& result = *out;
+    result.resize(2 * half, 2 * half);
+    result.topLeftCorner(half, half).noalias() = a * a;
+    result.topLeftCorner(half, half).noalias() += g * q;
+    result.bottomRightCorner(half, half) =
+        result.topLeftCorner(half, half).transpose();
+    DynamicMatrix product = a * g;
+    result.topRightCorner(half, half) = product - product.transpose();
+    product.noalias() = q * a;
+    result.bottomLeftCorner(half, half) = product - product.transpose();
+  }
+
+  static Complex find_stable_root(Complex square) {
+    Complex root = std::sqrt(square);
+    if (root.real() < 0 || (root.real() == 0 && root.imag() < 0)) {
+      root = -root;
+    }
+    return root;
+  }
+
+  void decompose(ComplexVector* eigenvalues, DynamicMatrix* unitary) {
+    p_unitary_ = unitary;
+    if (p_unitary_) {
+      *p_unitary_ = DynamicMatrix::Identity(size(), size());
+    }
+    reduce_to_paige_van_loan_form();
+    DynamicMatrix hessenberg = reduced_form_.topLeftCorner(half(), half());
+    Algorithm algorithm(precision_);
+    algorithm.run_hessenberg(&hessenberg, nullptr);
+    Algorithm::extract_eigenvalues(hessenberg, eigenvalues);
+  }
+
+  // Column by column, the lower block column entry is zeroed by a symplectic
+  // reflection, a symplectic rotation and another reflection; the lower
+  // block row follows by skew-symmetry.
+  void reduce_to_paige_van_loan_form() {
+    trace_recorder::TraceSpan span("paige/van loan reduction",
+                                   "hamiltonian_schur_decomposition",
+                                   size());
+    for (int col = 0; col + 1 < half(); ++col) {
+      int length = half() - col - 1;
+      if (length >= 2) {
+        reflect(HouseholderReflector(
+                    reduced_form_.block(half() + col + 1, col, length, 1)),
+                col + 1);
+      }
+      rotate(col + 1, col);
+      if (length >= 2) {
+        reflect(HouseholderReflector(
+                    reduced_form_.block(col + 1, col, length, 1)),
+                col + 1);
+      }
+    }
+    clean_up();
+  }
+
+  // Similarity with diag(P, P), P acting on the indices offset.. of each
+  // half.
+  void reflect(const HouseholderReflector& reflector, int offset) {
+    int length = reflector.direction().rows();
+    for (int first : {offset, half() + offset}) {
+      reflector.reflect_left(
+          reduced_form_.block(first, 0, length, size()));
+    }
+    for (int first : {offset, half() + offset}) {
+      reflector.reflect_right(
+          reduced_form_.block(0, first, size(), length));
+      if (p_unitary_) {
+        reflector.reflect_right(
+            p_unitary_->block(0, first, size(), length));
+      }
+    }
+  }
+
+  // Rotation in the plane of the indices index and half() + index that zeros
+  // the lower half of column col.
+  void rotate(int index, int col) {
+    Scalar x = reduced_form_(index, col);
+    Scalar y = reduced_form_(half() + index, col);
+    if (y == 0) {
+      return;
+    }
+    Rotator rotator(x, y);
+    DynamicMatrix rows(2, size());
+    rows << reduced_form_.row(index), reduced_form_.row(half() + index);
+    rotator.rotate_left(&rows);
+    reduced_form_.row(index) = rows.row(0);
+    reduced_form_.row(half() + index) = rows.row(1);
+    rotate_columns(rotator, index, &reduced_form_);
+    if (p_unitary_) {
+      rotate_columns(rotator, index, p_unitary_);
+    }
+  }
+
+  void rotate_columns(const Rotator& rotator, int index,
+                      DynamicMatrix* data) {
+    DynamicMatrix cols(data->rows(), 2);
+    cols << data->col(index), data->col(half() + index);
+    rotator.rotate_right(&cols);
+    data->col(index) = cols.col(0);
+    data->col(half() + index) = cols.col(1);
+  }
+
+  // Rounding leaves the zeroed parts small but nonzero.
+  void clean_up() {
+    reduced_form_.bottomLeftCorner(half(), half()).setZero();
+    for (int col = 0; col + 2 < half(); ++col) {
+      reduced_form_.block(col + 2, col, half() - col - 2, 1).setZero();
+    }
+  }
+
+  int size() const { return reduced_form_.rows(); }
+
+  int half() const { return reduced_form_.rows() / 2; }
+
+  Precision precision_;
+  DynamicMatrix reduced_form_;
+  DynamicMatrix* p_unitary_;
+};
+
+}  // namespace hamiltonian_schur_decomposition
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef _SCHUR_DECOMPOSITION_HESSENBERG_REDUCTION_H
 #define _SCHUR_DECOMPOSITION_HESSENBERG_REDUCTION_H
 
+#include <vector>
+
 #include "../eigen/Eigen/Dense"
 #include "householder_reflection.h"
+#include "memory_policy.h"
+#include "metrics_registry.h"
+#include "trace_recorder.h"
 
 namespace hessenberg_reduction {
 
-template <typename Scalar>
+template <typename Scalar,
+          class Allocator = memory_policy::DefaultAllocator<Scalar>>
 class HessenbergReduction {
   static_assert(std::is_arithmetic_v<Scalar>,
                 "Scalar must be arithmetic type!");
@@ -17,14 +23,75 @@ class HessenbergReduction {
   using DynamicMatrix = HouseholderReflector::DynamicMatrix;
   using DynamicVector = HouseholderReflector::DynamicVector;
 
+  HessenbergReduction() = default;
+  HessenbergReduction(Allocator allocator) : allocator_(std::move(allocator)) {}
+
+  // backtrace may be nullptr when the transform is not needed.
   void run(DynamicMatrix* data, DynamicMatrix* backtrace) {
     set_internal_resources(data, backtrace);
-    reduce_matrix();
+    trace_recorder::TraceSpan span("hessenberg reduction",
+                                   "hessenberg_reduction", data_size());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kHessenbergReduction, data_size());
+    reduce_matrix(0);
+  }
+
+  // Keeps the reflectors instead of accumulating them: reflector k acts on
+  // the indices k + 1, ..., n - 1 and the transform is their product in
+  // order.
+  void run_factored(DynamicMatrix* data,
+                    std::vector<HouseholderReflector>* reflectors) {
+    assert(reflectors);
+    set_internal_resources(data, nullptr);
+    p_reflectors_ = reflectors;
+    p_reflectors_->clear();
+    trace_recorder::TraceSpan span("hessenberg reduction",
+                                   "hessenberg_reduction", data_size());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kHessenbergReduction, data_size());
+    reduce_matrix(0);
+    p_reflectors_ = nullptr;
+  }
+
+  // Extends the reduction A = Q H Q^T of an n x n matrix to the bordered
+  // matrix [A column; row^T corner]. On entry data holds H (any upper
+  // Hessenberg matrix, e.g. a Schur form) and backtrace holds Q, on exit they
+  // hold the reduction of the bordered matrix. The border is moved into the
+  // basis of Q in O(n^2); the reduction is then resumed from the first column
+  // the border row disturbs, so a border that couples only to the trailing
+  // basis vectors is cheap. A border that is dense in that basis needs a full
+  // pass, as every reflector touches dense rows of H.
+  void update(const DynamicVector& column, const DynamicVector& row,
+              Scalar corner, DynamicMatrix* data, DynamicMatrix* backtrace) {
+    set_update_resources(data, backtrace);
+    trace_recorder::TraceSpan span("hessenberg update", "hessenberg_reduction",
+                                   data_size() + 1);
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kHessenbergReduction, data_size() + 1);
+    add_border(column, row, corner);
+    reduce_matrix(find_first_disturbed_col());
+  }
+
+  // Finishes a reduction of which the columns before first_col are done, e.g.
+  // by StreamingHessenbergReduction. backtrace holds the transform
+  // accumulated so far, or is nullptr.
+  void resume(int first_col, DynamicMatrix* data, DynamicMatrix* backtrace) {
+    assert(data);
+    assert(data->rows() == data->cols());
+    assert(!backtrace || backtrace->rows() == data->rows());
+    assert(!backtrace || backtrace->cols() == data->cols());
+    p_hessenberg_form_ = data;
+    p_backtrace_matrix_ = backtrace;
+    trace_recorder::TraceSpan span("hessenberg reduction",
+                                   "hessenberg_reduction", data_size());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kHessenbergReduction, data_size());
+    reduce_matrix(first_col);
   }
 
  private:
-  void reduce_matrix() {
-    for (int cur_col = 0; cur_col < data_size() - 2; ++cur_col) {
+  void reduce_matrix(int first_col) {
+    for (int cur_col = first_col; cur_col < data_size() - 2; ++cur_col) {
       reduce_column(cur_col);
     }
   }
@@ -34,6 +101,9 @@ class HessenbergReduction {
         HouseholderReflector(find_reduced_col(cur_col));
     update_hessenberg(cur_col, reflector);
     update_backtrace(cur_col, reflector);
+    if (p_reflectors_) {
+      p_reflectors_->push_back(std::move(reflector));
+    }
   }
 
   DynamicVector find_reduced_col(int cur_col) {
@@ -42,6 +112,8 @@ class HessenbergReduction {
   }
 
   void update_hessenberg(int cur_col, const HouseholderReflector& reflector) {
+    trace_recorder::TraceSpan span("trailing update", "hessenberg_reduction",
+                                   cur_col);
     reflector.reflect_left(p_hessenberg_form_->bottomRightCorner(
         data_size() - cur_col - 1, data_size() - cur_col));
     reflector.reflect_right(p_hessenberg_form_->bottomRightCorner(
@@ -49,6 +121,11 @@ class HessenbergReduction {
   }
 
   void update_backtrace(int cur_col, const HouseholderReflector& reflector) {
+    if (!p_backtrace_matrix_) {
+      return;
+    }
+    trace_recorder::TraceSpan span("backtrace update", "hessenberg_reduction",
+                                   cur_col);
     reflector.reflect_right(p_backtrace_matrix_->bottomRightCorner(
         data_size(), data_size() - cur_col - 1));
   }
@@ -58,9 +135,62 @@ class HessenbergReduction {
     assert(data->rows() == data->cols());
     p_hessenberg_form_ = data;
 
+    p_backtrace_matrix_ = backtrace;
+    if (p_backtrace_matrix_) {
+      allocate(p_backtrace_matrix_, data_size(), data_size());
+      p_backtrace_matrix_->setIdentity();
+    }
+  }
+
+  void set_update_resources(DynamicMatrix* data, DynamicMatrix* backtrace) {
+    assert(data);
+    assert(data->rows() == data->cols());
+    p_hessenberg_form_ = data;
+
     assert(backtrace);
+    assert(backtrace->rows() == data->rows());
+    assert(backtrace->cols() == data->cols());
     p_backtrace_matrix_ = backtrace;
-    *p_backtrace_matrix_ = DynamicMatrix::Identity(data_size(), data_size());
+  }
+
+  void add_border(const DynamicVector& column, const DynamicVector& row,
+                  Scalar corner) {
+    int old_size = data_size();
+    assert(column.rows() == old_size);
+    assert(row.rows() == old_size);
+
+    DynamicMatrix hessenberg_form;
+    allocate(&hessenberg_form, old_size + 1, old_size + 1);
+    hessenberg_form.topLeftCorner(old_size, old_size) = *p_hessenberg_form_;
+    hessenberg_form.col(old_size).head(old_size).noalias() =
+        p_backtrace_matrix_->transpose() * column;
+    hessenberg_form.row(old_size).head(old_size).noalias() =
+        row.transpose() * (*p_backtrace_matrix_);
+    hessenberg_form(old_size, old_size) = corner;
+    p_hessenberg_form_->swap(hessenberg_form);
+
+    DynamicMatrix backtrace;
+    allocate(&backtrace, old_size + 1, old_size + 1);
+    backtrace.setZero();
+    backtrace.topLeftCorner(old_size, old_size) = *p_backtrace_matrix_;
+    backtrace(old_size, old_size) = 1;
+    p_backtrace_matrix_->swap(backtrace);
+  }
+
+  void allocate(DynamicMatrix* buffer, int rows, int cols) {
+    allocator_.allocate(buffer, rows, cols);
+    metrics_registry::record_allocation<Scalar>(
+        metrics_registry::Solver::kHessenbergReduction, rows, cols);
+  }
+
+  int find_first_disturbed_col() {
+    int last_row = data_size() - 1;
+    int first_col = 0;
+    while (first_col < last_row - 1 &&
+           (*p_hessenberg_form_)(last_row, first_col) == 0) {
+      ++first_col;
+    }
+    return first_col;
   }
 
   int data_size() {
@@ -68,8 +198,10 @@ class HessenbergReduction {
     return p_hessenberg_form_->rows();
   }
 
+  Allocator allocator_;
   DynamicMatrix* p_hessenberg_form_;
   DynamicMatrix* p_backtrace_matrix_;
+  std::vector<HouseholderReflector>* p_reflectors_ = nullptr;
 };
 
 }  // namespace hessenberg_reduction
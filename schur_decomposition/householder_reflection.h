@@ -2,6 +2,7 @@
 #define _SCHUR_DECOMPOSITION_HOUSEHOLDER_REFLECTION_H
 
 #include <cmath>
+#include <limits>
 #include <type_traits>
 
 #include "../eigen/Eigen/Dense"
@@ -23,6 +24,13 @@ class HouseholderReflector {
   HouseholderReflector(DynamicVector vector) : direction_(std::move(vector)) {
     int size = direction_.rows();
     assert(size >= 2);
+    // The direction does not depend on the scale of the vector; a vector
+    // whose squared norm under- or overflows is rescaled first, otherwise
+    // the normalized direction and the reflector would not be orthogonal.
+    Scalar largest = direction_.cwiseAbs().maxCoeff();
+    if (largest > 0 && (largest < safe_minimum() || largest > safe_maximum())) {
+      direction_ /= largest;
+    }
     if (direction_(0) > 0) {
       direction_(0) += direction_.norm();
     } else {
@@ -35,15 +43,23 @@ class HouseholderReflector {
 
   void reflect_left(DynamicBlock block) const {
     assert(block.rows() == direction_.rows());
-    block -= direction_ * (2 * (direction_.transpose() * block));
+    block.noalias() -= direction_ * (2 * (direction_.transpose() * block));
   }
 
   void reflect_right(DynamicBlock block) const {
     assert(block.cols() == direction_.rows());
-    block -= 2 * (block * direction_) * direction_.transpose();
+    block.noalias() -= 2 * (block * direction_) * direction_.transpose();
   }
 
  private:
+  static Scalar safe_minimum() {
+    return std::sqrt(std::numeric_limits<Scalar>::min());
+  }
+
+  static Scalar safe_maximum() {
+    return std::sqrt(std::numeric_limits<Scalar>::max()) / 2;
+  }
+
   DynamicVector direction_;
 };
 
@@ -0,0 +1,215 @@
+#ifndef _SCHUR_DECOMPOSITION_JOINT_DIAGONALIZATION_H
+#define _SCHUR_DECOMPOSITION_JOINT_DIAGONALIZATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "givens_rotation.h"
+#include "trace_recorder.h"
+
+namespace joint_diagonalization {
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Orthogonal V that makes every V^T A_k V of a set of symmetric matrices as
+// diagonal as possible, by the Jacobi method of Cardoso and Souloumiac
+// (JADE): the angle of the rotation of the pair (p, q) maximizes the sum
+// over all k of the squared diagonal entries p and q, which is the
+// principal eigenvector of the 2 x 2 matrix G = sum_k h_k h_k^T with
+// h_k = (A_k(p, p) - A_k(q, q), 2 A_k(p, q)).
+//
+// The pairs of a sweep are visited in the rounds of a round-robin
+// tournament, n / 2 disjoint pairs per round. Rotations of disjoint pairs
+// commute, so all angles of a round are computed first and its rotations
+// are then applied to every matrix as column rotations, (A R)^T R with one
+// transposition in between, which keeps the kernels on contiguous columns.
+// The matrices (and V) are split between the threads for every round.
+template <typename Scalar>
+class JointDiagonalization {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using GivensRotator = givens_rotation::GivensRotator<Scalar>;
+  using DynamicMatrix = GivensRotator::DynamicMatrix;
+
+  JointDiagonalization(Precision precision, int max_sweeps = 100,
+                       int number_of_threads = default_number_of_threads())
+      : precision_(precision),
+        max_sweeps_(max_sweeps),
+        number_of_threads_(number_of_threads) {
+    assert(precision > 0);
+    assert(max_sweeps >= 1);
+    assert(number_of_threads >= 1);
+  }
+
+  // Overwrites every matrix with V^T A_k V; basis receives V. Only the
+  // symmetry of the matrices is assumed, they need not commute.
+  void run(std::vector<DynamicMatrix>* matrices, DynamicMatrix* basis) {
+    assert(matrices && !matrices->empty());
+    assert(basis);
+    p_matrices_ = matrices;
+    int size = (*matrices)[0].rows();
+    for (const DynamicMatrix& matrix : *matrices) {
+      assert(matrix.rows() == size && matrix.cols() == size);
+    }
+    trace_recorder::TraceSpan span("joint diagonalization",
+                                   "joint_diagonalization", size);
+    basis->setIdentity(size, size);
+    p_basis_ = basis;
+    sweeps_ = 0;
+    bool rotated = size >= 2;
+    while (rotated && sweeps_ < max_sweeps_) {
+      rotated = false;
+      for (int round = 0; round < count_rounds(); ++round) {
+        rotated = run_round(round) || rotated;
+      }
+      ++sweeps_;
+    }
+    is_converged_ = !rotated;
+    p_matrices_ = nullptr;
+    p_basis_ = nullptr;
+  }
+
+  // Sum over the matrices of the squared off-diagonal entries, the quantity
+  // the method decreases.
+  static Scalar off_diagonal_norm(const std::vector<DynamicMatrix>& matrices) {
+    Scalar sum = 0;
+    for (const DynamicMatrix& matrix : matrices) {
+      int size = matrix.rows();
+      for (int column = 1; column < size; ++column) {
+        sum += matrix.col(column).head(column).squaredNorm() +
+               matrix.row(column).head(column).squaredNorm();
+      }
+    }
+    return sum;
+  }
+
+  int get_sweeps() const { return sweeps_; }
+
+  // False when the last run() stopped at max_sweeps.
+  bool is_converged() const { return is_converged_; }
+
+ private:
+  struct Rotation {
+    int first;
+    int second;
+    GivensRotator rotator;
+  };
+
+  int size() const { return (*p_matrices_)[0].rows(); }
+
+  // Players of the tournament; an odd size gets a dummy that sits out.
+  int count_players() const { return size() + size() % 2; }
+
+  int count_rounds() const { return count_players() - 1; }
+
+  // Pair index of round: the last player meets player round, and the others
+  // meet symmetrically around it modulo the number of rounds.
+  std::pair<int, int> get_pair(int round, int index) const {
+    int rounds = count_rounds();
+    if (index == 0) {
+      return {round, count_players() - 1};
+    }
+    return {(round + index) % rounds, (round - index + rounds) % rounds};
+  }
+
+  bool run_round(int round) {
+    std::vector<Rotation> rotations;
+    for (int index = 0; index < count_players() / 2; ++index) {
+      auto [first, second] = get_pair(round, index);
+      if (second >= size()) {
+        continue;
+      }
+      Rotation rotation{std::min(first, second), std::max(first, second),
+                        find_rotation(std::min(first, second),
+                                      std::max(first, second))};
+      // Rotations by less than the precision are skipped, as in JADE.
+      if (std::abs(rotation.rotator.sin()) > precision_) {
+        rotations.push_back(rotation);
+      }
+    }
+    if (rotations.empty()) {
+      return false;
+    }
+    int jobs = p_matrices_->size() + 1;
+    for_each_thread(std::min(number_of_threads_, jobs), [&](int thread,
+                                                            int threads) {
+      for (int job = thread; job < jobs; job += threads) {
+        if (job + 1 == jobs) {
+          rotate_columns(rotations, p_basis_);
+        } else {
+          rotate_symmetric(rotations, &(*p_matrices_)[job]);
+        }
+      }
+    });
+    return true;
+  }
+
+  GivensRotator find_rotation(int first, int second) const {
+    Scalar g11 = 0;
+    Scalar g12 = 0;
+    Scalar g22 = 0;
+    for (const DynamicMatrix& matrix : *p_matrices_) {
+      Scalar gap = matrix(first, first) - matrix(second, second);
+      Scalar coupling = matrix(first, second) + matrix(second, first);
+      g11 += gap * gap;
+      g12 += gap * coupling;
+      g22 += coupling * coupling;
+    }
+    // (cos 4 theta, sin 4 theta) is the principal eigenvector direction of
+    // G; this form of the angle has no cancellation when g11 < g22.
+    Scalar theta = std::atan2(2 * g12, g11 - g22) / 4;
+    return GivensRotator(std::cos(theta), std::sin(theta));
+  }
+
+  static void rotate_columns(const std::vector<Rotation>& rotations,
+                             DynamicMatrix* matrix) {
+    for (const Rotation& rotation : rotations) {
+      rotation.rotator.rotate_columns(matrix, rotation.first,
+                                      rotation.second);
+    }
+  }
+
+  // A = R^T A R = (A R)^T R for symmetric A.
+  static void rotate_symmetric(const std::vector<Rotation>& rotations,
+                               DynamicMatrix* matrix) {
+    rotate_columns(rotations, matrix);
+    matrix->transposeInPlace();
+    rotate_columns(rotations, matrix);
+  }
+
+  template <class Work>
+  static void for_each_thread(int threads, const Work& work) {
+    if (threads <= 1) {
+      work(0, 1);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int thread = 0; thread < threads; ++thread) {
+      workers.emplace_back([&, thread]() { work(thread, threads); });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  Precision precision_;
+  int max_sweeps_;
+  int number_of_threads_;
+  std::vector<DynamicMatrix>* p_matrices_ = nullptr;
+  DynamicMatrix* p_basis_ = nullptr;
+  int sweeps_ = 0;
+  bool is_converged_ = true;
+};
+
+}  // namespace joint_diagonalization
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef _SCHUR_DECOMPOSITION_KRONECKER_OPERATOR_H
+#define _SCHUR_DECOMPOSITION_KRONECKER_OPERATOR_H
+
+#include <complex>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "memory_policy.h"
+#include "schur_decomposition.h"
+#include "schur_decomposition_symmetric.h"
+#include "solver_policy.h"
+#include "trace_recorder.h"
+
+namespace kronecker_operator {
+
+enum class Structure {
+  // A_1 x A_2 x ... x A_d.
+  kProduct,
+  // A_1 x I x ... x I + I x A_2 x ... x I + ... + I x ... x I x A_d.
+  kSum,
+};
+
+// Kronecker product or sum K of small square factors A_k (n_k x n_k), of
+// size N = n_1 n_2 ... n_d, which is never formed. Vectors of size N are
+// tensors in the Kronecker order, where the index of (i_1, ..., i_d) is
+// (...(i_1 n_2 + i_2) n_3 + ...) + i_d, and a factor acts on its mode by
+// one matrix product per slab, in O(N n_k) instead of O(N^2).
+//
+// Each factor is decomposed once, A_k = Q_k T_k Q_k^T, by the symmetric
+// solver when it equals its transpose and by SchurDecomposition otherwise.
+// Then Q = Q_1 x ... x Q_d is orthogonal and Q^T K Q is the product or sum
+// of the T_k, so the eigenvalues of K are the products or sums of the
+// eigenvalues of the factors. When all factors are symmetric, Q is an
+// eigenbasis and its column j belongs to eigenvalue j.
+template <typename Scalar>
+class KroneckerOperator {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using Algorithm = schur_decomposition::SchurDecomposition<
+      Scalar, memory_policy::DefaultAllocator<Scalar>,
+      solver_policy::AccumulateUnitary,
+      solver_policy::ExceptionalDoubleShift<Scalar>>;
+  using SymmetricAlgorithm =
+      schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using DynamicVector = Algorithm::DynamicVector;
+  using Complex = Algorithm::Complex;
+  using ComplexVector = Algorithm::ComplexVector;
+
+  KroneckerOperator(Structure structure, std::vector<DynamicMatrix> factors,
+                    Precision precision)
+      : structure_(structure), factors_(std::move(factors)) {
+    assert(!factors_.empty());
+    assert(precision >= 0);
+    trace_recorder::TraceSpan span("kronecker decomposition",
+                                   "kronecker_operator", factors_.size());
+    is_symmetric_ = true;
+    for (const DynamicMatrix& factor : factors_) {
+      assert(factor.rows() == factor.cols() && factor.rows() >= 1);
+      size_ *= factor.rows();
+      decompose_factor(factor, precision);
+    }
+    combine_eigenvalues();
+  }
+
+  int get_size() const { return size_; }
+
+  int get_factors_count() const { return factors_.size(); }
+
+  Structure get_structure() const { return structure_; }
+
+  // True when every factor is symmetric and the basis is an eigenbasis.
+  bool is_symmetric() const { return is_symmetric_; }
+
+  // Eigenvalue j belongs to the multi-index (i_1, ..., i_d) of j.
+  const ComplexVector& get_eigenvalues() const { return eigenvalues_; }
+
+  const DynamicMatrix& get_factor_unitary(int factor) const {
+    return unitaries_[factor];
+  }
+
+  // T_k, diagonal for a symmetric factor.
+  const DynamicMatrix& get_factor_schur_form(int factor) const {
+    return schur_forms_[factor];
+  }
+
+  // out = K in.
+  void apply(const DynamicVector& in, DynamicVector* out) const {
+    assert(out);
+    assert(in.rows() == size_);
+    if (structure_ == Structure::kProduct) {
+      *out = in;
+      for (int factor = 0; factor < get_factors_count(); ++factor) {
+        multiply_mode(factor, factors_[factor], out);
+      }
+      return;
+    }
+    out->setZero(size_);
+    for (int factor = 0; factor < get_factors_count(); ++factor) {
+      DynamicVector term = in;
+      multiply_mode(factor, factors_[factor], &term);
+      *out += term;
+    }
+  }
+
+  // out = Q in.
+  void apply_basis(const DynamicVector& in, DynamicVector* out) const {
+    assert(out);
+    assert(in.rows() == size_);
+    *out = in;
+    for (int factor = 0; factor < get_factors_count(); ++factor) {
+      multiply_mode(factor, unitaries_[factor], out);
+    }
+  }
+
+  // out = Q^T in.
+  void apply_basis_transpose(const DynamicVector& in,
+                             DynamicVector* out) const {
+    assert(out);
+    assert(in.rows() == size_);
+    *out = in;
+    for (int factor = 0; factor < get_factors_count(); ++factor) {
+      multiply_mode(factor, unitaries_[factor].transpose(), out);
+    }
+  }
+
+ private:
+  void decompose_factor(const DynamicMatrix& factor, Precision precision) {
+    DynamicMatrix unitary;
+    DynamicMatrix schur_form;
+    ComplexVector eigenvalues;
+    if (factor == factor.transpose()) {
+      DynamicVector real_eigenvalues;
+      SymmetricAlgorithm(precision).run(factor, &real_eigenvalues, &unitary);
+      schur_form = real_eigenvalues.asDiagonal();
+      eigenvalues = real_eigenvalues.template cast<Complex>();
+    } else {
+      is_symmetric_ = false;
+      Algorithm(precision).run(factor, &schur_form, &unitary);
+      Algorithm::extract_eigenvalues(schur_form, &eigenvalues);
+    }
+    unitaries_.push_back(std::move(unitary));
+    schur_forms_.push_back(std::move(schur_form));
+    factor_eigenvalues_.push_back(std::move(eigenvalues));
+  }
+
+  void combine_eigenvalues() {
+    eigenvalues_ = factor_eigenvalues_[0];
+    for (int factor = 1; factor < get_factors_count(); ++factor) {
+      const ComplexVector& next = factor_eigenvalues_[factor];
+      ComplexVector combined(eigenvalues_.size() * next.size());
+      for (int outer = 0; outer < eigenvalues_.size(); ++outer) {
+        for (int inner = 0; inner < next.size(); ++inner) {
+          combined(outer * next.size() + inner) =
+              structure_ == Structure::kProduct
+                  ? eigenvalues_(outer) * next(inner)
+                  : eigenvalues_(outer) + next(inner);
+        }
+      }
+      eigenvalues_.swap(combined);
+    }
+  }
+
+  // Multiplies mode factor of the tensor by matrix. The tensor splits into
+  // slabs of mid x right entries, row-major, where mid = n_factor and right
+  // is the product of the later sizes; a slab seen column-major as S
+  // (right x mid) becomes S matrix^T.
+  template <class Matrix>
+  void multiply_mode(int factor, const Matrix& matrix,
+                     DynamicVector* tensor) const {
+    int mid = factors_[factor].rows();
+    int right = 1;
+    for (int later = factor + 1; later < get_factors_count(); ++later) {
+      right *= factors_[later].rows();
+    }
+    int slabs = size_ / (mid * right);
+    DynamicMatrix product(right, mid);
+    for (int slab = 0; slab < slabs; ++slab) {
+      Eigen::Map<DynamicMatrix> view(tensor->data() + slab * mid * right,
+                                     right, mid);
+      product.noalias() = view * matrix.transpose();
+      view = product;
+    }
+  }
+
+  Structure structure_;
+  std::vector<DynamicMatrix> factors_;
+  std::vector<DynamicMatrix> unitaries_;
+  std::vector<DynamicMatrix> schur_forms_;
+  std::vector<ComplexVector> factor_eigenvalues_;
+  ComplexVector eigenvalues_;
+  int size_ = 1;
+  bool is_symmetric_ = true;
+};
+
+}  // namespace kronecker_operator
+
+#endif
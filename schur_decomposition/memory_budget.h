@@ -0,0 +1,319 @@
+#ifndef _SCHUR_DECOMPOSITION_MEMORY_BUDGET_H
+#define _SCHUR_DECOMPOSITION_MEMORY_BUDGET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "../eigen/Eigen/Dense"
+#include "memory_policy.h"
+#include "schur_decomposition.h"
+#include "schur_decomposition_symmetric.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace memory_budget {
+
+// Variants ordered by preference: each one keeps less than the previous.
+enum class Variant {
+  kFull,                    // input is kept, unitary is computed
+  kInPlace,                 // input is overwritten, unitary is computed
+  kEigenvaluesOnly,         // input is kept, no unitary
+  kInPlaceEigenvaluesOnly,  // input is overwritten, no unitary
+};
+
+constexpr const Variant variants[] = {Variant::kFull, Variant::kInPlace,
+                                      Variant::kEigenvaluesOnly,
+                                      Variant::kInPlaceEigenvaluesOnly};
+
+inline const char* variant_name(Variant variant) {
+  switch (variant) {
+    case Variant::kFull:
+      return "full";
+    case Variant::kInPlace:
+      return "in-place";
+    case Variant::kEigenvaluesOnly:
+      return "eigenvalues-only";
+    case Variant::kInPlaceEigenvaluesOnly:
+      return "in-place eigenvalues-only";
+  }
+  return "unknown";
+}
+
+struct Requirements {
+  bool need_unitary = true;
+  bool may_overwrite_input = false;
+};
+
+// Peak memory is counted for the whole decomposition, the caller's input
+// matrix included.
+struct MemoryReport {
+  Variant variant = Variant::kFull;
+  bool fits = false;
+  std::size_t budget_bytes = 0;
+  std::size_t predicted_peak_bytes = 0;
+  std::size_t actual_peak_bytes = 0;
+};
+
+inline bool is_allowed(Variant variant, Requirements requirements) {
+  bool has_unitary = variant == Variant::kFull || variant == Variant::kInPlace;
+  bool is_in_place = variant == Variant::kInPlace ||
+                     variant == Variant::kInPlaceEigenvaluesOnly;
+  return has_unitary == requirements.need_unitary &&
+         (!is_in_place || requirements.may_overwrite_input);
+}
+
+// Number of n x n matrices alive at the peak of each variant: the input, the
+// working copy (Schur form or Hessenberg form) and the unitary. Both solvers
+// share the same layout; their O(n) vectors are added separately.
+inline int count_square_buffers(Variant variant) {
+  switch (variant) {
+    case Variant::kFull:
+      return 3;
+    case Variant::kInPlace:
+    case Variant::kEigenvaluesOnly:
+      return 2;
+    case Variant::kInPlaceEigenvaluesOnly:
+      return 1;
+  }
+  return 3;
+}
+
+template <typename Scalar>
+std::size_t predict_peak_bytes(Variant variant, int size) {
+  constexpr const int vectors = 6;
+  std::size_t elements = std::size_t(size) * size;
+  return (count_square_buffers(variant) * elements +
+          vectors * std::size_t(size)) *
+         sizeof(Scalar);
+}
+
+// Heap usage of the process as seen by the allocator. On glibc this is the
+// number of bytes malloc reports in use, small freed blocks kept in its
+// per-thread cache included; elsewhere only the buffers handed out by
+// MeasuringAllocator are counted.
+class HeapWatermark {
+ public:
+  void start() {
+    counted_bytes_ = 0;
+    base_bytes_ = heap_in_use();
+    peak_bytes_ = 0;
+  }
+
+  void sample() {
+    std::size_t in_use = heap_in_use();
+    if (in_use > base_bytes_) {
+      peak_bytes_ = std::max(peak_bytes_, in_use - base_bytes_);
+    }
+  }
+
+  void count(std::size_t bytes) { counted_bytes_ += bytes; }
+
+  std::size_t get_peak_bytes() const { return peak_bytes_; }
+
+ private:
+  std::size_t heap_in_use() const {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return base_bytes_ + counted_bytes_;
+#endif
+  }
+
+  std::size_t base_bytes_ = 0;
+  std::size_t counted_bytes_ = 0;
+  std::size_t peak_bytes_ = 0;
+};
+
+// Samples the heap right after every working buffer is allocated, which is
+// where the peaks of the solvers occur.
+template <typename Scalar>
+class MeasuringAllocator {
+ public:
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+
+  MeasuringAllocator() = default;
+  MeasuringAllocator(HeapWatermark* watermark) : watermark_(watermark) {}
+
+  void allocate(DynamicMatrix* buffer, int rows, int cols) const {
+    memory_policy::DefaultAllocator<Scalar>().allocate(buffer, rows, cols);
+    if (watermark_) {
+      watermark_->count(std::size_t(rows) * cols * sizeof(Scalar));
+      watermark_->sample();
+    }
+  }
+
+ private:
+  HeapWatermark* watermark_ = nullptr;
+};
+
+template <typename Scalar>
+MemoryReport plan(int size, Requirements requirements,
+                  std::size_t budget_bytes) {
+  MemoryReport report;
+  report.budget_bytes = budget_bytes;
+  for (Variant variant : variants) {
+    if (!is_allowed(variant, requirements)) {
+      continue;
+    }
+    report.variant = variant;
+    report.predicted_peak_bytes = predict_peak_bytes<Scalar>(variant, size);
+    report.fits = report.predicted_peak_bytes <= budget_bytes;
+    if (report.fits) {
+      break;
+    }
+  }
+  return report;
+}
+
+// Runs schur_decomposition::SchurDecomposition in the most complete variant
+// that fits into the memory budget. Nothing is computed when no allowed
+// variant fits (report.fits is false).
+template <typename Scalar>
+class SchurDecomposition {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Algorithm =
+      schur_decomposition::SchurDecomposition<Scalar,
+                                              MeasuringAllocator<Scalar>>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using Precision = Scalar;
+
+  SchurDecomposition(Precision precision, std::size_t budget_bytes)
+      : precision_(precision), budget_bytes_(budget_bytes) {
+    assert(precision >= 0);
+  }
+
+  MemoryReport plan(int size, Requirements requirements) const {
+    return memory_budget::plan<Scalar>(size, requirements, budget_bytes_);
+  }
+
+  // The Schur form is returned in schur_form for every variant; the in-place
+  // variants move the overwritten data there. unitary may be nullptr unless
+  // requirements.need_unitary is set.
+  MemoryReport run(DynamicMatrix* data, DynamicMatrix* schur_form,
+                   DynamicMatrix* unitary, Requirements requirements) {
+    assert(data && schur_form);
+    assert(!requirements.need_unitary || unitary);
+    MemoryReport report = plan(data->rows(), requirements);
+    if (!report.fits) {
+      return report;
+    }
+    release(schur_form, unitary);
+    std::size_t input_bytes = data->size() * sizeof(Scalar);
+    watermark_.start();
+    Algorithm algorithm(precision_, MeasuringAllocator<Scalar>(&watermark_));
+    switch (report.variant) {
+      case Variant::kFull:
+        algorithm.run(*data, schur_form, unitary);
+        break;
+      case Variant::kInPlace:
+        algorithm.run_in_place(data, unitary);
+        schur_form->swap(*data);
+        break;
+      case Variant::kEigenvaluesOnly:
+        algorithm.run(*data, schur_form);
+        break;
+      case Variant::kInPlaceEigenvaluesOnly:
+        algorithm.run_in_place(data, nullptr);
+        schur_form->swap(*data);
+        break;
+    }
+    watermark_.sample();
+    report.actual_peak_bytes = input_bytes + watermark_.get_peak_bytes();
+    return report;
+  }
+
+  void set_budget(std::size_t budget_bytes) { budget_bytes_ = budget_bytes; }
+
+  std::size_t get_budget() const { return budget_bytes_; }
+
+ private:
+  static void release(DynamicMatrix* schur_form, DynamicMatrix* unitary) {
+    schur_form->resize(0, 0);
+    if (unitary) {
+      unitary->resize(0, 0);
+    }
+  }
+
+  Precision precision_;
+  std::size_t budget_bytes_;
+  HeapWatermark watermark_;
+};
+
+// Budgeted driver of schur_decomposition_symmetric::SchurDecomposition.
+template <typename Scalar>
+class SymmetricSchurDecomposition {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Algorithm = schur_decomposition_symmetric::SchurDecomposition<
+      Scalar, MeasuringAllocator<Scalar>>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using DynamicVector = Algorithm::DynamicVector;
+  using Precision = Scalar;
+
+  SymmetricSchurDecomposition(Precision precision, std::size_t budget_bytes)
+      : precision_(precision), budget_bytes_(budget_bytes) {
+    assert(precision >= 0);
+  }
+
+  MemoryReport plan(int size, Requirements requirements) const {
+    return memory_budget::plan<Scalar>(size, requirements, budget_bytes_);
+  }
+
+  // data is overwritten only by the in-place variants. unitary may be nullptr
+  // unless requirements.need_unitary is set.
+  MemoryReport run(DynamicMatrix* data, DynamicVector* eigenvalues,
+                   DynamicMatrix* unitary, Requirements requirements) {
+    assert(data && eigenvalues);
+    assert(!requirements.need_unitary || unitary);
+    MemoryReport report = plan(data->rows(), requirements);
+    if (!report.fits) {
+      return report;
+    }
+    if (unitary) {
+      unitary->resize(0, 0);
+    }
+    std::size_t input_bytes = data->size() * sizeof(Scalar);
+    watermark_.start();
+    Algorithm algorithm(precision_, MeasuringAllocator<Scalar>(&watermark_));
+    switch (report.variant) {
+      case Variant::kFull:
+        algorithm.run(*data, eigenvalues, unitary);
+        break;
+      case Variant::kInPlace:
+        algorithm.run_in_place(data, eigenvalues, unitary);
+        break;
+      case Variant::kEigenvaluesOnly:
+        algorithm.run(*data, eigenvalues);
+        break;
+      case Variant::kInPlaceEigenvaluesOnly:
+        algorithm.run_in_place(data, eigenvalues);
+        break;
+    }
+    watermark_.sample();
+    report.actual_peak_bytes = input_bytes + watermark_.get_peak_bytes();
+    return report;
+  }
+
+  void set_budget(std::size_t budget_bytes) { budget_bytes_ = budget_bytes; }
+
+  std::size_t get_budget() const { return budget_bytes_; }
+
+ private:
+  Precision precision_;
+  std::size_t budget_bytes_;
+  HeapWatermark watermark_;
+};
+
+}  // namespace memory_budget
+
+#endif
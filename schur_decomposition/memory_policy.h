@@ -0,0 +1,91 @@
+#ifndef _SCHUR_DECOMPOSITION_MEMORY_POLICY_H
+#define _SCHUR_DECOMPOSITION_MEMORY_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../eigen/Eigen/Dense"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace memory_policy {
+
+// Allocation policies decide how the working buffers of the solvers obtain
+// their storage. A policy is any class with a method
+//   void allocate(DynamicMatrix* buffer, int rows, int cols) const;
+// which resizes buffer to rows x cols (contents unspecified).
+
+constexpr const std::size_t cache_line_bytes = 64;
+constexpr const std::size_t huge_page_bytes = std::size_t(2) << 20;
+
+template <typename Scalar>
+class DefaultAllocator {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+
+  void allocate(DynamicMatrix* buffer, int rows, int cols) const {
+    assert(buffer);
+    assert(rows >= 0 && cols >= 0);
+    buffer->resize(rows, cols);
+  }
+};
+
+// Backs every buffer of at least min_huge_bytes with 2 MB transparent huge
+// pages. Eigen owns the storage of its matrices, so the pages are requested
+// with madvise() on the 2 MB aligned part of the buffer right after it is
+// allocated and before it is first touched.
+template <typename Scalar>
+class HugePageAllocator {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+
+  HugePageAllocator() = default;
+  HugePageAllocator(std::size_t min_huge_bytes)
+      : min_huge_bytes_(min_huge_bytes) {}
+
+  void allocate(DynamicMatrix* buffer, int rows, int cols) const {
+    assert(buffer);
+    assert(rows >= 0 && cols >= 0);
+    buffer->resize(rows, cols);
+    assert(is_aligned(buffer->data()));
+    std::size_t bytes = std::size_t(buffer->size()) * sizeof(Scalar);
+    if (bytes >= min_huge_bytes_) {
+      advise_huge_pages(buffer->data(), bytes);
+    }
+  }
+
+  std::size_t get_min_huge_bytes() const { return min_huge_bytes_; }
+
+ private:
+  static bool is_aligned(const Scalar* data) {
+    return reinterpret_cast<std::uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES ==
+           0;
+  }
+
+  static void advise_huge_pages(Scalar* data, std::size_t bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    std::uintptr_t end = begin + bytes;
+    begin = (begin + huge_page_bytes - 1) / huge_page_bytes * huge_page_bytes;
+    end = end / huge_page_bytes * huge_page_bytes;
+    if (begin < end) {
+      madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#endif
+  }
+
+  std::size_t min_huge_bytes_ = huge_page_bytes;
+};
+
+}  // namespace memory_policy
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef _SCHUR_DECOMPOSITION_METRICS_REGISTRY_H
+#define _SCHUR_DECOMPOSITION_METRICS_REGISTRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace metrics_registry {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Solver {
+  kSchurDecomposition,
+  kSymmetricSchurDecomposition,
+  kHessenbergReduction,
+};
+
+constexpr const int solvers_count = 3;
+
+inline const char* solver_name(Solver solver) {
+  switch (solver) {
+    case Solver::kSchurDecomposition:
+      return "schur_decomposition";
+    case Solver::kSymmetricSchurDecomposition:
+      return "schur_decomposition_symmetric";
+    case Solver::kHessenbergReduction:
+      return "hessenberg_reduction";
+  }
+  return "unknown";
+}
+
+// Upper bounds of the matrix size classes and of the histogram buckets; the
+// last class or bucket of each is unbounded.
+constexpr const int size_bounds[] = {16, 64, 256, 1024, 4096};
+constexpr const int size_classes_count = std::size(size_bounds) + 1;
+constexpr const double duration_bounds[] = {1e-5, 1e-4, 1e-3, 1e-2,
+                                            1e-1, 1.,   10.};
+constexpr const int duration_buckets_count = std::size(duration_bounds) + 1;
+constexpr const int sweeps_bounds[] = {1, 10, 100, 1000, 10000, 100000};
+constexpr const int sweeps_buckets_count = std::size(sweeps_bounds) + 1;
+
+// Iteration budget of LAPACK's xHSEQR, 30 sweeps per eigenvalue but at least
+// 300. The QR loops here have no such limit, so a run above it is reported
+// as slow to converge rather than failed.
+inline bool is_over_iteration_budget(int sweeps, int size) {
+  return sweeps > 30 * std::max(10, size);
+}
+
+template <class Bounds, class Value>
+int find_bucket(const Bounds& bounds, Value value) {
+  int bucket = 0;
+  while (bucket < int(std::size(bounds)) && value > bounds[bucket]) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+using Counter = std::atomic<std::uint64_t>;
+
+// Counters of one thread. The owning thread is the only writer, so a
+// relaxed load and store replace a read-modify-write.
+struct Shard {
+  Counter durations[solvers_count][size_classes_count]
+                   [duration_buckets_count] = {};
+  Counter duration_ns[solvers_count][size_classes_count] = {};
+  Counter sweeps[solvers_count][sweeps_buckets_count] = {};
+  Counter sweeps_sum[solvers_count] = {};
+  Counter over_budget[solvers_count] = {};
+  Counter allocations[solvers_count] = {};
+  Counter allocated_bytes[solvers_count] = {};
+
+  static void add(Counter* counter, std::uint64_t value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+  }
+};
+
+// Process-wide aggregate of solver statistics, exported in the Prometheus
+// text format. Recording is off by default, so an instrumented call costs
+// one relaxed atomic load. Export and reset() may run concurrently with the
+// solvers; a sample taken meanwhile may miss the calls still in flight.
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& instance() {
+    static MetricsRegistry registry;
+    return registry;
+  }
+
+  void enable() { enabled_.store(true, std::memory_order_relaxed); }
+  void disable() { enabled_.store(false, std::memory_order_relaxed); }
+  bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // sweeps is negative for solvers without QR sweeps.
+  void record_call(Solver solver, int size, std::int64_t duration_ns,
+                   int sweeps) {
+    Shard* shard = thread_shard();
+    int index = static_cast<int>(solver);
+    int size_class = find_bucket(size_bounds, size);
+    double seconds = duration_ns * 1e-9;
+    Shard::add(&shard->durations[index][size_class]
+                                [find_bucket(duration_bounds, seconds)],
+               1);
+    Shard::add(&shard->duration_ns[index][size_class], duration_ns);
+    if (sweeps >= 0) {
+      Shard::add(&shard->sweeps[index][find_bucket(sweeps_bounds, sweeps)],
+                 1);
+      Shard::add(&shard->sweeps_sum[index], sweeps);
+      if (is_over_iteration_budget(sweeps, size)) {
+        Shard::add(&shard->over_budget[index], 1);
+      }
+    }
+  }
+
+  void record_allocation(Solver solver, std::size_t bytes) {
+    Shard* shard = thread_shard();
+    int index = static_cast<int>(solver);
+    Shard::add(&shard->allocations[index], 1);
+    Shard::add(&shard->allocated_bytes[index], bytes);
+  }
+
+  // Counters only grow between resets; a reset while the solvers run may
+  // lose the increments made at that moment.
+  void reset() {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+      clear(shard.get());
+    }
+  }
+
+  void export_prometheus(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    write_durations(out);
+    write_sweeps(out);
+    write_counter(out, "schur_solver_over_iteration_budget_total",
+                  "Runs that needed more QR sweeps than the LAPACK budget.",
+                  &Shard::over_budget);
+    write_counter(out, "schur_solver_allocations_total",
+                  "Working buffers allocated by the solvers.",
+                  &Shard::allocations);
+    write_counter(out, "schur_solver_allocated_bytes_total",
+                  "Bytes of the working buffers allocated by the solvers.",
+                  &Shard::allocated_bytes);
+  }
+
+  // Writes to a temporary file next to path and renames it, so that a
+  // collector reading path (e.g. the node exporter textfile collector)
+  // never sees a partial file. Returns false when the file cannot be
+  // written.
+  bool write_prometheus_file(const std::string& path) {
+    std::string temporary = path + ".tmp";
+    {
+      std::ofstream out(temporary);
+      if (!out) {
+        return false;
+      }
+      export_prometheus(out);
+      if (!out) {
+        return false;
+      }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+  }
+
+ private:
+  MetricsRegistry() = default;
+
+  Shard* thread_shard() {
+    static thread_local Shard* shard = register_thread();
+    return shard;
+  }
+
+  Shard* register_thread() {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    shards_.push_back(std::make_unique<Shard>());
+    return shards_.back().get();
+  }
+
+  static void clear(Shard* shard) {
+    auto zero = [](Counter& counter) {
+      counter.store(0, std::memory_order_relaxed);
+    };
+    for (int solver = 0; solver < solvers_count; ++solver) {
+      for (int size_class = 0; size_class < size_classes_count;
+           ++size_class) {
+        for (Counter& counter : shard->durations[solver][size_class]) {
+          zero(counter);
+        }
+        zero(shard->duration_ns[solver][size_class]);
+      }
+      for (Counter& counter : shard->sweeps[solver]) {
+        zero(counter);
+      }
+      zero(shard->sweeps_sum[solver]);
+      zero(shard->over_budget[solver]);
+      zero(shard->allocations[solver]);
+      zero(shard->allocated_bytes[solver]);
+    }
+  }
+
+  template <class Select>
+  std::uint64_t sum(Select select) const {
+    std::uint64_t total = 0;
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+      total += select(*shard).load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  static std::string size_class_label(int size_class) {
+    return size_class < int(std::size(size_bounds))
+               ? std::to_string(size_bounds[size_class])
+               : "+Inf";
+  }
+
+  void write_durations(std::ostream& out) const {
+    const char* name = "schur_solver_duration_seconds";
+    out << "# HELP " << name
+        << " Duration of solver calls by matrix size class (upper bound).\n";
+    out << "# TYPE " << name << " histogram\n";
+    for (int solver = 0; solver < solvers_count; ++solver) {
+      for (int size_class = 0; size_class < size_classes_count;
+           ++size_class) {
+        std::string labels =
+            std::string("solver=\"") +
+            solver_name(static_cast<Solver>(solver)) + "\",size_class=\"" +
+            size_class_label(size_class) + "\"";
+        std::uint64_t count = 0;
+        for (int bucket = 0; bucket < duration_buckets_count; ++bucket) {
+          count += sum([&](const Shard& shard) -> const Counter& {
+            return shard.durations[solver][size_class][bucket];
+          });
+          out << name << "_bucket{" << labels << ",le=\""
+              << (bucket < int(std::size(duration_bounds))
+                      ? std::to_string(duration_bounds[bucket])
+                      : std::string("+Inf"))
+              << "\"} " << count << "\n";
+        }
+        std::uint64_t duration_ns = sum([&](const Shard& shard)
+                                            -> const Counter& {
+          return shard.duration_ns[solver][size_class];
+        });
+        out << name << "_sum{" << labels << "} " << duration_ns * 1e-9
+            << "\n";
+        out << name << "_count{" << labels << "} " << count << "\n";
+      }
+    }
+  }
+
+  void write_sweeps(std::ostream& out) const {
+    const char* name = "schur_solver_sweeps";
+    out << "# HELP " << name << " QR sweeps per solver call.\n";
+    out << "# TYPE " << name << " histogram\n";
+    for (int solver = 0; solver < solvers_count; ++solver) {
+      if (static_cast<Solver>(solver) == Solver::kHessenbergReduction) {
+        continue;
+      }
+      std::string labels = std::string("solver=\"") +
+                           solver_name(static_cast<Solver>(solver)) + "\"";
+      std::uint64_t count = 0;
+      for (int bucket = 0; bucket < sweeps_buckets_count; ++bucket) {
+        count += sum([&](const Shard& shard) -> const Counter& {
+          return shard.sweeps[solver][bucket];
+        });
+        out << name << "_bucket{" << labels << ",le=\""
+            << (bucket < int(std::size(sweeps_bounds))
+                    ? std::to_string(sweeps_bounds[bucket])
+                    : std::string("+Inf"))
+            << "\"} " << count << "\n";
+      }
+      out << name << "_sum{" << labels << "} "
+          << sum([&](const Shard& shard) -> const Counter& {
+               return shard.sweeps_sum[solver];
+             })
+          << "\n";
+      out << name << "_count{" << labels << "} " << count << "\n";
+    }
+  }
+
+  void write_counter(std::ostream& out, const char* name, const char* help,
+                     Counter (Shard::*counters)[solvers_count]) const {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " counter\n";
+    for (int solver = 0; solver < solvers_count; ++solver) {
+      out << name << "{solver=\"" << solver_name(static_cast<Solver>(solver))
+          << "\"} " << sum([&](const Shard& shard) -> const Counter& {
+               return (shard.*counters)[solver];
+             })
+          << "\n";
+    }
+  }
+
+  std::atomic<bool> enabled_ = false;
+  std::mutex shards_mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Records one solver call, from construction to destruction.
+class SolverCall {
+ public:
+  SolverCall(Solver solver, int size) : solver_(solver), size_(size) {
+    if (MetricsRegistry::instance().is_enabled()) {
+      start_ = Clock::now();
+      active_ = true;
+    }
+  }
+
+  SolverCall(const SolverCall&) = delete;
+  SolverCall& operator=(const SolverCall&) = delete;
+
+  void set_sweeps(int sweeps) { sweeps_ = sweeps; }
+
+  ~SolverCall() {
+    if (active_) {
+      std::int64_t duration_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                               start_)
+              .count();
+      MetricsRegistry::instance().record_call(solver_, size_, duration_ns,
+                                              sweeps_);
+    }
+  }
+
+ private:
+  Solver solver_;
+  int size_;
+  int sweeps_ = -1;
+  Clock::time_point start_;
+  bool active_ = false;
+};
+
+template <typename Scalar>
+void record_allocation(Solver solver, int rows, int cols) {
+  MetricsRegistry& registry = MetricsRegistry::instance();
+  if (registry.is_enabled()) {
+    registry.record_allocation(solver,
+                               std::size_t(rows) * cols * sizeof(Scalar));
+  }
+}
+
+}  // namespace metrics_registry
+
+#endif
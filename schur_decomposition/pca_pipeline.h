@@ -0,0 +1,218 @@
+#ifndef _SCHUR_DECOMPOSITION_PCA_PIPELINE_H
+#define _SCHUR_DECOMPOSITION_PCA_PIPELINE_H
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "bounded_queue.h"
+#include "compact_eigenbasis.h"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+
+namespace pca_pipeline {
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Principal components of a stream of samples, given as chunks of rows of
+// an m x n data matrix.
+//
+// Every chunk is centered on its own mean and merged into the running mean
+// and scatter matrix with the pairwise update of Chan, Golub and LeVeque,
+// which keeps the centering exact in a single pass. The scatter matrix
+// lives in the lower triangle of one n x n buffer and is updated by column
+// blocks of equal area on several threads. compute() symmetrizes that
+// buffer and tridiagonalizes it in place, with the eigenbasis kept in
+// compact form, so that only the requested components are formed and the
+// covariance is never copied.
+template <typename Scalar>
+class PcaPipeline {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using SymmetricAlgorithm =
+      schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using CompactEigenbasis = SymmetricAlgorithm::CompactEigenbasis;
+  using DynamicMatrix = SymmetricAlgorithm::DynamicMatrix;
+  using DynamicVector = SymmetricAlgorithm::DynamicVector;
+  // Stores the next chunk of samples (rows) and returns true, or returns
+  // false at the end of the stream.
+  using ChunkSource = std::function<bool(DynamicMatrix* chunk)>;
+
+  PcaPipeline(int features, Precision precision,
+              int number_of_threads = default_number_of_threads(),
+              int queue_capacity = 4)
+      : precision_(precision),
+        number_of_threads_(number_of_threads),
+        queue_capacity_(queue_capacity) {
+    assert(features >= 1);
+    assert(precision >= 0);
+    assert(number_of_threads >= 1);
+    assert(queue_capacity >= 1);
+    scatter_.setZero(features, features);
+    mean_.setZero(features);
+  }
+
+  void add_chunk(DynamicMatrix chunk) {
+    assert(chunk.cols() == features());
+    if (chunk.rows() == 0) {
+      return;
+    }
+    trace_recorder::TraceSpan span("chunk accumulation", "pca_pipeline",
+                                   chunk.rows());
+    Scalar count = chunk.rows();
+    DynamicVector chunk_mean = chunk.colwise().mean().transpose();
+    chunk.rowwise() -= chunk_mean.transpose();
+    DynamicVector delta = chunk_mean - mean_;
+    Scalar weight = samples_ * count / (samples_ + count);
+    update_scatter(chunk, delta, weight);
+    mean_ += delta * (count / (samples_ + count));
+    samples_ += chunk.rows();
+  }
+
+  // Reads the chunks on a producer thread while the calling thread
+  // accumulates them.
+  void add_chunks(const ChunkSource& source) {
+    bounded_queue::BoundedQueue<DynamicMatrix> queue(queue_capacity_);
+    std::thread producer([&]() {
+      DynamicMatrix chunk;
+      while (source(&chunk)) {
+        queue.push(std::move(chunk));
+      }
+      queue.close();
+    });
+    DynamicMatrix chunk;
+    while (queue.pop(&chunk)) {
+      add_chunk(std::move(chunk));
+    }
+    producer.join();
+  }
+
+  // variances receives the largest count eigenvalues of the sample
+  // covariance in decreasing order and components the matching unit
+  // eigenvectors as columns. The accumulated samples are consumed.
+  void compute(int count, DynamicVector* variances,
+               DynamicMatrix* components) {
+    assert(variances);
+    assert(components);
+    assert(count >= 0 && count <= features());
+    assert(samples_ >= 2);
+    trace_recorder::TraceSpan span("principal components", "pca_pipeline",
+                                   features());
+    make_covariance();
+    DynamicVector eigenvalues;
+    CompactEigenbasis basis;
+    SymmetricAlgorithm(precision_).run_in_place(&scatter_, &eigenvalues,
+                                                &basis);
+    std::vector<int> order(features());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int left, int right) {
+      return eigenvalues(left) > eigenvalues(right);
+    });
+    variances->resize(count);
+    components->setZero(features(), count);
+    for (int index = 0; index < count; ++index) {
+      (*variances)(index) = eigenvalues(order[index]);
+      (*components)(order[index], index) = 1;
+    }
+    basis.apply(components);
+    reset();
+  }
+
+  void reset() {
+    scatter_.setZero(features(), features());
+    mean_.setZero(features());
+    samples_ = 0;
+  }
+
+  int features() const { return mean_.rows(); }
+
+  long long get_samples_count() const { return samples_; }
+
+  const DynamicVector& get_mean() const { return mean_; }
+
+  int get_number_of_threads() const { return number_of_threads_; }
+
+ private:
+  // scatter += chunk^T chunk + weight delta delta^T on the lower triangle,
+  // by column blocks; each block is a GEMM on the rows from its first
+  // column down.
+  void update_scatter(const DynamicMatrix& chunk, const DynamicVector& delta,
+                      Scalar weight) {
+    std::vector<int> bounds = split_columns();
+    int blocks = bounds.size() - 1;
+    for_each_thread(blocks, [&](int block, int) {
+      int first = bounds[block];
+      int width = bounds[block + 1] - first;
+      if (width == 0) {
+        return;
+      }
+      int rows = features() - first;
+      auto target = scatter_.block(first, first, rows, width);
+      target.noalias() +=
+          chunk.rightCols(rows).transpose() * chunk.middleCols(first, width);
+      target.noalias() +=
+          weight * delta.tail(rows) * delta.segment(first, width).transpose();
+    });
+  }
+
+  // Column bounds that give every thread about the same part of the lower
+  // triangle.
+  std::vector<int> split_columns() const {
+    int threads = std::min(number_of_threads_, features());
+    double area = features() * (features() + 1.) / 2;
+    std::vector<int> bounds = {0};
+    double covered = 0;
+    for (int col = 0; col < features(); ++col) {
+      covered += features() - col;
+      if (covered >= area * bounds.size() / threads &&
+          int(bounds.size()) < threads) {
+        bounds.push_back(col + 1);
+      }
+    }
+    bounds.push_back(features());
+    return bounds;
+  }
+
+  void make_covariance() {
+    scatter_ /= Scalar(samples_ - 1);
+    for (int col = 0; col + 1 < features(); ++col) {
+      int rest = features() - col - 1;
+      scatter_.row(col).tail(rest) = scatter_.col(col).tail(rest).transpose();
+    }
+  }
+
+  template <class Work>
+  static void for_each_thread(int threads, const Work& work) {
+    if (threads <= 1) {
+      work(0, 1);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int thread = 0; thread < threads; ++thread) {
+      workers.emplace_back([&, thread]() { work(thread, threads); });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  Precision precision_;
+  int number_of_threads_;
+  int queue_capacity_;
+  DynamicMatrix scatter_;
+  DynamicVector mean_;
+  long long samples_ = 0;
+};
+
+}  // namespace pca_pipeline
+
+#endif
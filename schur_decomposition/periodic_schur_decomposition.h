@@ -0,0 +1,386 @@
+#ifndef _SCHUR_DECOMPOSITION_PERIODIC_SCHUR_DECOMPOSITION_H
+#define _SCHUR_DECOMPOSITION_PERIODIC_SCHUR_DECOMPOSITION_H
+
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "givens_rotation.h"
+#include "householder_reflection.h"
+#include "schur_decomposition.h"
+#include "trace_recorder.h"
+
+namespace periodic_schur_decomposition {
+
+// Periodic Schur decomposition of a product A_k ... A_2 A_1 computed on the
+// factors, without forming the product. factors = {A_1, ..., A_k} are
+// brought to T_i = Q_{i+1}^T A_i Q_i (with Q_{k+1} = Q_1), where T_k is quasi
+// upper triangular and the other T_i are upper triangular, so that
+// Q_1^T A_k ... A_1 Q_1 = T_k ... T_1 is the real Schur form of the product.
+// unitaries receives Q_1, ..., Q_k.
+//
+// The factors are first reduced to periodic Hessenberg-triangular form (T_k
+// Hessenberg). Every QR sweep then chases the usual double shift bulge
+// through T_k; each transform applied to T_k from the left continues to the
+// right of T_1, whose triangular form is restored from the left, which
+// continues to the right of T_2, and so on back to T_k. Shifts and deflation
+// follow SchurDecomposition, with the 2 x 2 and 3 x 3 blocks of the product
+// that they need formed from the factors.
+template <typename Scalar>
+class PeriodicSchurDecomposition {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using HouseholderReflector =
+      householder_reflection::HouseholderReflector<Scalar>;
+  using Rotator = givens_rotation::GivensRotator<Scalar>;
+  using DynamicMatrix = HouseholderReflector::DynamicMatrix;
+  using DynamicVector = HouseholderReflector::DynamicVector;
+  using Factors = std::vector<DynamicMatrix>;
+  using Algorithm = schur_decomposition::SchurDecomposition<Scalar>;
+  using ComplexVector = Algorithm::ComplexVector;
+  using Matrix2 = Eigen::Matrix<Scalar, 2, 2>;
+  using Matrix3 = Eigen::Matrix<Scalar, 3, 3>;
+  using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+  using Precision = Scalar;
+
+  PeriodicSchurDecomposition(Precision precision) : precision_(precision) {
+    assert(precision >= 0);
+  }
+
+  // unitaries may be nullptr when the transforms are not needed.
+  void run(const Factors& factors, Factors* schur_factors,
+           Factors* unitaries) {
+    set_internal_resources(factors, schur_factors, unitaries);
+    trace_recorder::TraceSpan span("periodic schur decomposition",
+                                   "periodic_schur_decomposition", size());
+    reduce_to_hessenberg_triangular_form();
+    run_QR_algorithm();
+  }
+
+  // Eigenvalues of the product read off its periodic Schur form.
+  static void extract_eigenvalues(const Factors& schur_factors,
+                                  ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    assert(!schur_factors.empty());
+    const DynamicMatrix& quasi_triangular = schur_factors.back();
+    int size = quasi_triangular.rows();
+    eigenvalues->resize(size);
+    for (int index = 0; index < size; ++index) {
+      int length =
+          index + 1 < size && quasi_triangular(index + 1, index) != 0 ? 2 : 1;
+      DynamicMatrix block =
+          quasi_triangular.block(index, index, length, length);
+      for (int factor = int(schur_factors.size()) - 2; factor >= 0;
+           --factor) {
+        block *= schur_factors[factor].block(index, index, length, length);
+      }
+      ComplexVector block_eigenvalues;
+      Algorithm::extract_eigenvalues(block, &block_eigenvalues);
+      eigenvalues->segment(index, length) = block_eigenvalues;
+      index += length - 1;
+    }
+  }
+
+  void set_precision(Precision precision) {
+    assert(precision >= 0);
+    precision_ = precision;
+  }
+
+  Precision get_precision() const { return precision_; }
+
+ private:
+  struct Reflection {
+    HouseholderReflector reflector;
+    int offset;
+
+    int length() const { return reflector.direction().rows(); }
+  };
+
+  struct Rotation {
+    Rotator rotator;
+    int offset;
+
+    int length() const { return 2; }
+  };
+
+  void reduce_to_hessenberg_triangular_form() {
+    trace_recorder::TraceSpan span("hessenberg-triangular reduction",
+                                   "periodic_schur_decomposition", size());
+    for (int factor = 0; factor < hessenberg_index(); ++factor) {
+      triangularize(factor);
+    }
+    for (int col = 0; col < size() - 2; ++col) {
+      for (int row = size() - 1; row >= col + 2; --row) {
+        reduce_entry(row, col);
+      }
+    }
+  }
+
+  // QR decomposition of a factor whose successor is still dense.
+  void triangularize(int factor) {
+    for (int col = 0; col < size() - 1; ++col) {
+      Reflection reflection = {
+          HouseholderReflector(
+              factor_at(factor).block(col, col, size() - col, 1)),
+          col};
+      apply_left(reflection, factor, col);
+      apply_right(reflection, factor + 1, size());
+      update_unitary(reflection, factor + 1);
+    }
+  }
+
+  void reduce_entry(int row, int col) {
+    DynamicMatrix& hessenberg = factor_at(hessenberg_index());
+    if (hessenberg(row, col) == 0) {
+      return;
+    }
+    Rotation rotation = {
+        Rotator(hessenberg(row - 1, col), hessenberg(row, col)), row - 1};
+    apply_left(rotation, hessenberg_index(), col);
+    propagate(std::vector<Rotation>{rotation}, size());
+  }
+
+  void run_QR_algorithm() {
+    cur_size_ = size() - 1;
+    if (cur_size_ >= 2) {
+      try_to_deflate();
+    }
+    while (cur_size_ >= 2) {
+      make_QR_iteration();
+      try_to_deflate();
+    }
+  }
+
+  void make_QR_iteration() {
+    trace_recorder::TraceSpan span("bulge chase",
+                                   "periodic_schur_decomposition",
+                                   cur_size_ + 1);
+    set_matching_column();
+    restore_hessenberg_form();
+  }
+
+  void set_matching_column() {
+    chase(HouseholderReflector(find_matching_column()), -1);
+  }
+
+  void restore_hessenberg_form() {
+    int step = 0;
+    for (; step <= cur_size_ - 3; ++step) {
+      chase(HouseholderReflector(get_reflected_column(step, 3)), step);
+    }
+    chase(HouseholderReflector(get_reflected_column(step, 2)), step);
+  }
+
+  DynamicVector get_reflected_column(int step, int rows) {
+    return factor_at(hessenberg_index()).block(step + 1, step, rows, 1);
+  }
+
+  void chase(HouseholderReflector reflector, int step) {
+    Reflection reflection = {std::move(reflector), step + 1};
+    apply_left(reflection, hessenberg_index(), std::max(step, 0));
+    propagate(std::vector<Reflection>{reflection},
+              std::min(cur_size_, step + 4) + 1);
+  }
+
+  // Continues transforms applied to the left of the Hessenberg factor: they
+  // are applied to the right of T_1, whose triangular form is restored by
+  // new transforms from the left, which go on to T_2, and so on until the
+  // right of the Hessenberg factor is reached. Only its first
+  // hessenberg_rows rows are updated there.
+  template <class Transform>
+  void propagate(std::vector<Transform> transforms, int hessenberg_rows) {
+    for (int factor = 0; factor < factors_count(); ++factor) {
+      bool is_hessenberg = factor == hessenberg_index();
+      for (const Transform& transform : transforms) {
+        apply_right(transform, factor,
+                    is_hessenberg ? hessenberg_rows
+                                  : transform.offset + transform.length());
+        update_unitary(transform, factor);
+      }
+      if (is_hessenberg || transforms.empty()) {
+        return;
+      }
+      restore_triangular_form(factor, &transforms);
+    }
+  }
+
+  // The transforms just applied mixed the columns of one diagonal block of
+  // the triangular factor; it is made triangular again from the left.
+  void restore_triangular_form(int factor,
+                               std::vector<Reflection>* reflections) {
+    int offset = reflections->front().offset;
+    int length = 0;
+    for (const Reflection& reflection : *reflections) {
+      offset = std::min(offset, reflection.offset);
+      length = std::max(length, reflection.offset + reflection.length());
+    }
+    length -= offset;
+    reflections->clear();
+    for (int col = offset; col < offset + length - 1; ++col) {
+      Reflection reflection = {
+          HouseholderReflector(factor_at(factor).block(
+              col, col, offset + length - col, 1)),
+          col};
+      apply_left(reflection, factor, col);
+      reflections->push_back(std::move(reflection));
+    }
+  }
+
+  void restore_triangular_form(int factor, std::vector<Rotation>* rotations) {
+    int offset = rotations->front().offset;
+    rotations->clear();
+    DynamicMatrix& triangular = factor_at(factor);
+    if (triangular(offset + 1, offset) == 0) {
+      return;
+    }
+    Rotation rotation = {
+        Rotator(triangular(offset, offset), triangular(offset + 1, offset)),
+        offset};
+    apply_left(rotation, factor, offset);
+    rotations->push_back(rotation);
+  }
+
+  void apply_left(const Reflection& reflection, int factor, int first_col) {
+    reflection.reflector.reflect_left(factor_at(factor).block(
+        reflection.offset, first_col, reflection.length(),
+        size() - first_col));
+  }
+
+  void apply_left(const Rotation& rotation, int factor, int first_col) {
+    rotation.rotator.rotate_left(factor_at(factor).block(
+        rotation.offset, first_col, 2, size() - first_col));
+  }
+
+  void apply_right(const Reflection& reflection, int factor, int rows) {
+    reflection.reflector.reflect_right(factor_at(factor).block(
+        0, reflection.offset, rows, reflection.length()));
+  }
+
+  void apply_right(const Rotation& rotation, int factor, int rows) {
+    rotation.rotator.rotate_right(
+        factor_at(factor).block(0, rotation.offset, rows, 2));
+  }
+
+  void update_unitary(const Reflection& reflection, int index) {
+    if (!p_unitaries_) {
+      return;
+    }
+    reflection.reflector.reflect_right((*p_unitaries_)[index].block(
+        0, reflection.offset, size(), reflection.length()));
+  }
+
+  void update_unitary(const Rotation& rotation, int index) {
+    if (!p_unitaries_) {
+      return;
+    }
+    rotation.rotator.rotate_right(
+        (*p_unitaries_)[index].block(0, rotation.offset, size(), 2));
+  }
+
+  void try_to_deflate() {
+    trace_recorder::TraceSpan span("deflation window",
+                                   "periodic_schur_decomposition",
+                                   cur_size_ + 1);
+    bool check_deflation = true;
+    while (check_deflation && cur_size_ >= 1) {
+      if (zero_under_diagonal(cur_size_)) {
+        decrement_cur_size(1);
+      } else if (cur_size_ >= 2 && zero_under_diagonal(cur_size_ - 1)) {
+        decrement_cur_size(2);
+      } else {
+        check_deflation = false;
+      }
+    }
+  }
+
+  void decrement_cur_size(int decrement) {
+    factor_at(hessenberg_index())(cur_size_ + 1 - decrement,
+                                  cur_size_ - decrement) = 0;
+    cur_size_ -= decrement;
+  }
+
+  // The subdiagonal of the product is that of the Hessenberg factor scaled
+  // by the diagonals of the triangular ones, so the test is made on the
+  // Hessenberg factor alone.
+  bool zero_under_diagonal(int index) {
+    const DynamicMatrix& hessenberg = factor_at(hessenberg_index());
+    return std::abs(hessenberg(index, index - 1)) <
+           precision_ * (std::abs(hessenberg(index, index)) +
+                         std::abs(hessenberg(index - 1, index - 1)));
+  }
+
+  // First column of (P - s_1)(P - s_2) for the product P, the shifts being
+  // the eigenvalues of the trailing 2 x 2 block of the active window.
+  Vector3 find_matching_column() {
+    Matrix2 corner = find_bottom_corner();
+    Scalar trace = corner.trace();
+    Scalar det = corner.determinant();
+    Eigen::Matrix<Scalar, 3, 2> top = find_top_columns();
+    Vector3 tmp;
+    tmp(0) = top(0, 0) * top(0, 0) + top(0, 1) * top(1, 0) -
+             trace * top(0, 0) + det;
+    tmp(1) = top(1, 0) * (top(0, 0) + top(1, 1) - trace);
+    tmp(2) = top(1, 0) * top(2, 1);
+    return tmp;
+  }
+
+  // P(0:2, 0:1): the leading blocks of upper triangular factors multiply.
+  Eigen::Matrix<Scalar, 3, 2> find_top_columns() {
+    Matrix2 triangular = Matrix2::Identity();
+    for (int factor = 0; factor < hessenberg_index(); ++factor) {
+      triangular = factor_at(factor).template topLeftCorner<2, 2>() *
+                   triangular;
+    }
+    return factor_at(hessenberg_index()).template topLeftCorner<3, 2>() *
+           triangular;
+  }
+
+  // P(m-1:m, m-1:m) for the last active row m, which involves the 3 x 3
+  // trailing block of the triangular product.
+  Matrix2 find_bottom_corner() {
+    int first = cur_size_ - 2;
+    Matrix3 triangular = Matrix3::Identity();
+    for (int factor = 0; factor < hessenberg_index(); ++factor) {
+      triangular =
+          factor_at(factor).template block<3, 3>(first, first) * triangular;
+    }
+    return factor_at(hessenberg_index()).template block<2, 3>(first + 1,
+                                                              first) *
+           triangular.template rightCols<2>();
+  }
+
+  void set_internal_resources(const Factors& factors, Factors* schur_factors,
+                              Factors* unitaries) {
+    assert(!factors.empty());
+    assert(schur_factors);
+    int size = factors.front().rows();
+    for (const DynamicMatrix& factor : factors) {
+      assert(factor.rows() == size && factor.cols() == size);
+    }
+    *schur_factors = factors;
+    p_factors_ = schur_factors;
+    p_unitaries_ = unitaries;
+    if (p_unitaries_) {
+      p_unitaries_->assign(factors.size(),
+                           DynamicMatrix::Identity(size, size));
+    }
+  }
+
+  DynamicMatrix& factor_at(int index) { return (*p_factors_)[index]; }
+
+  int factors_count() { return p_factors_->size(); }
+
+  int hessenberg_index() { return factors_count() - 1; }
+
+  int size() { return p_factors_->front().rows(); }
+
+  Precision precision_;
+  Factors* p_factors_;
+  Factors* p_unitaries_;
+  int cur_size_;
+};
+
+}  // namespace periodic_schur_decomposition
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef _SCHUR_DECOMPOSITION_PIPELINED_TRIDIAGONAL_QR_H
+#define _SCHUR_DECOMPOSITION_PIPELINED_TRIDIAGONAL_QR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "givens_rotation.h"
+#include "hessenberg_reduction.h"
+#include "trace_recorder.h"
+#include "tridiagonal_symmetric.h"
+
+namespace pipelined_tridiagonal_qr {
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Symmetric tridiagonal QR algorithm that keeps several implicit QR sweeps
+// in flight. Each batch takes the eigenvalues of the trailing sweeps x sweeps
+// block of the active window as shifts and starts one sweep per shift; sweep
+// j chases its bulge at least safe_distance steps behind sweep j - 1, which
+// is the furthest a step reaches into the diagonals, so the result is the
+// same as running the sweeps one after another. Sweeps are owned by the
+// threads in turn and the rotations of a batch are then applied to the
+// unitary by row blocks, each thread updating its own rows.
+template <typename Scalar>
+class PipelinedTridiagonalQR {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using TridiagonalSymmetric =
+      tridiagonal_symmetric::TridiagonalSymmetric<Scalar>;
+  using Rotator = givens_rotation::GivensRotator<Scalar>;
+  using HessenbergReduction = hessenberg_reduction::HessenbergReduction<Scalar>;
+  using DynamicMatrix = HessenbergReduction::DynamicMatrix;
+  using DynamicVector = HessenbergReduction::DynamicVector;
+
+  static constexpr const int safe_distance = 3;
+  // Progress is published every publish_interval steps, which bounds the
+  // synchronization to a few operations per interval.
+  static constexpr const int publish_interval = 16;
+
+  PipelinedTridiagonalQR(Precision precision, int sweeps = 4,
+                         int number_of_threads = default_number_of_threads())
+      : precision_(precision),
+        sweeps_(sweeps),
+        number_of_threads_(number_of_threads) {
+    assert(precision >= 0);
+    assert(sweeps >= 1);
+    assert(number_of_threads >= 1);
+  }
+
+  // unitary may be nullptr when the eigenvectors are not needed.
+  void run(const DynamicMatrix& data, DynamicVector* eigenvalues,
+           DynamicMatrix* unitary) {
+    assert(data.rows() == data.cols());
+    DynamicMatrix hessenberg_form = data;
+    HessenbergReduction reduction;
+    reduction.run(&hessenberg_form, unitary);
+    p_unitary_ = unitary;
+    decompose(TridiagonalSymmetric::extract_diagonals(hessenberg_form),
+              eigenvalues);
+  }
+
+  // Starts from a matrix that is already symmetric tridiagonal. unitary
+  // receives its eigenvectors, or may be nullptr.
+  void run_tridiagonal(TridiagonalSymmetric diagonals,
+                       DynamicVector* eigenvalues, DynamicMatrix* unitary) {
+    p_unitary_ = unitary;
+    if (p_unitary_) {
+      *p_unitary_ = DynamicMatrix::Identity(diagonals.get_size(),
+                                            diagonals.get_size());
+    }
+    decompose(std::move(diagonals), eigenvalues);
+  }
+
+  void set_precision(Precision precision) {
+    assert(precision >= 0);
+    precision_ = precision;
+  }
+
+  Precision get_precision() const { return precision_; }
+
+  // Statistics of the last run.
+  int get_batches() const { return batches_; }
+  int get_sweeps() const { return total_sweeps_; }
+
+ private:
+  struct Rotation {
+    Scalar cos;
+    Scalar sin;
+  };
+
+  void decompose(TridiagonalSymmetric diagonals, DynamicVector* eigenvalues) {
+    assert(eigenvalues);
+    diagonals_ = std::move(diagonals);
+    trace_recorder::TraceSpan span("pipelined tridiagonal qr",
+                                   "pipelined_tridiagonal_qr", size());
+    batches_ = 0;
+    total_sweeps_ = 0;
+    current_size_ = size() - 1;
+    try_to_deflate();
+    while (current_size_ >= 1) {
+      run_batch();
+      try_to_deflate();
+    }
+    *eigenvalues = diagonals_.get_major_diagonal();
+    diagonals_ = {};
+  }
+
+  void run_batch() {
+    trace_recorder::TraceSpan span("batch", "pipelined_tridiagonal_qr",
+                                   current_size_ + 1);
+    choose_shifts();
+    int sweeps = shifts_.size();
+    rotations_.assign(sweeps, std::vector<Rotation>(current_size_));
+    progress_ = std::vector<std::atomic<int>>(sweeps);
+    for_each_thread(std::min(number_of_threads_, sweeps), [&](int thread,
+                                                              int threads) {
+      for (int sweep = thread; sweep < sweeps; sweep += threads) {
+        chase(sweep);
+      }
+    });
+    update_unitary();
+    ++batches_;
+    total_sweeps_ += sweeps;
+  }
+
+  // Eigenvalues of the trailing block of the window, or the Wilkinson shift
+  // when the window is too small for several sweeps. The small block is
+  // solved by Eigen, whose 2 x 2 case stays accurate near convergence. Only
+  // the bottom of the window is deflated, so the shift closest to its last
+  // diagonal entry goes last.
+  void choose_shifts() {
+    int window = current_size_ + 1;
+    shifts_.clear();
+    if (sweeps_ == 1 || window <= 2 * sweeps_) {
+      shifts_.push_back(find_wilkinson_shift());
+      return;
+    }
+    int first = window - sweeps_;
+    Eigen::SelfAdjointEigenSolver<DynamicMatrix> solver;
+    solver.computeFromTridiagonal(
+        diagonals_.get_major_diagonal().segment(first, sweeps_),
+        diagonals_.get_side_diagonal().segment(first, sweeps_ - 1),
+        Eigen::EigenvaluesOnly);
+    shifts_.assign(solver.eigenvalues().data(),
+                   solver.eigenvalues().data() + sweeps_);
+    Scalar last = diagonals_.get_major_diagonal()(current_size_);
+    std::sort(shifts_.begin(), shifts_.end(), [last](Scalar left,
+                                                     Scalar right) {
+      return std::abs(left - last) > std::abs(right - last);
+    });
+  }
+
+  Scalar find_wilkinson_shift() {
+    const DynamicVector& major = diagonals_.get_major_diagonal();
+    const DynamicVector& side = diagonals_.get_side_diagonal();
+    Scalar last = major(current_size_);
+    Scalar coupling = side(current_size_ - 1);
+    Scalar half_gap = (major(current_size_ - 1) - last) / 2;
+    if (half_gap == 0) {
+      return last - std::abs(coupling);
+    }
+    Scalar sign = half_gap > 0 ? 1 : -1;
+    return last - coupling * coupling /
+                      (half_gap + sign * std::hypot(half_gap, coupling));
+  }
+
+  void chase(int sweep) {
+    Scalar bulge = 0;
+    for (int step = 0; step < current_size_; ++step) {
+      if (sweep > 0) {
+        wait_for(sweep - 1, std::min(step + safe_distance, current_size_));
+      }
+      make_step(shifts_[sweep], step, &bulge, &rotations_[sweep][step]);
+      if ((step + 1) % publish_interval == 0 || step + 1 == current_size_) {
+        progress_[sweep].store(step + 1, std::memory_order_release);
+        progress_[sweep].notify_all();
+      }
+    }
+  }
+
+  void wait_for(int sweep, int steps) {
+    int done = progress_[sweep].load(std::memory_order_acquire);
+    while (done < steps) {
+      progress_[sweep].wait(done, std::memory_order_acquire);
+      done = progress_[sweep].load(std::memory_order_acquire);
+    }
+  }
+
+  // One rotation of the bulge chase, as in the symmetric solver: it reads
+  // and writes the diagonal at step and step + 1 and the side diagonal from
+  // step - 1 to step + 1.
+  void make_step(Scalar shift, int step, Scalar* bulge, Rotation* rotation) {
+    DynamicVector& major = diagonals_.get_major_diagonal();
+    DynamicVector& side = diagonals_.get_side_diagonal();
+    Scalar x = step == 0 ? major(0) - shift : side(step - 1);
+    Scalar y = step == 0 ? side(0) : *bulge;
+    Rotator rotator = x == 0 && y == 0 ? Rotator(1, 0) : Rotator(x, y);
+    Scalar cos = rotator.cos();
+    Scalar sin = rotator.sin();
+    Scalar first = major(step);
+    Scalar second = major(step + 1);
+    Scalar coupling = side(step);
+    major(step) = cos * cos * first + 2 * cos * sin * coupling +
+                  sin * sin * second;
+    major(step + 1) = sin * sin * first - 2 * cos * sin * coupling +
+                      cos * cos * second;
+    side(step) =
+        cos * sin * (second - first) + (cos * cos - sin * sin) * coupling;
+    if (step > 0) {
+      side(step - 1) = cos * side(step - 1) + sin * *bulge;
+    }
+    if (step + 1 < current_size_) {
+      *bulge = side(step + 1) * sin;
+      side(step + 1) *= cos;
+    }
+    *rotation = {cos, sin};
+  }
+
+  // Rows of the unitary are independent under rotations from the right.
+  void update_unitary() {
+    if (!p_unitary_) {
+      return;
+    }
+    trace_recorder::TraceSpan span("unitary update",
+                                   "pipelined_tridiagonal_qr",
+                                   current_size_ + 1);
+    DynamicMatrix& unitary = *p_unitary_;
+    int rows = unitary.rows();
+    for_each_thread(std::min(number_of_threads_, rows), [&](int thread,
+                                                            int threads) {
+      int begin = rows * thread / threads;
+      int end = rows * (thread + 1) / threads;
+      for (const std::vector<Rotation>& sweep : rotations_) {
+        for (int step = 0; step < int(sweep.size()); ++step) {
+          auto left = unitary.col(step).segment(begin, end - begin);
+          auto right = unitary.col(step + 1).segment(begin, end - begin);
+          for (int row = 0; row < end - begin; ++row) {
+            Scalar x = left(row);
+            Scalar y = right(row);
+            left(row) = sweep[step].cos * x + sweep[step].sin * y;
+            right(row) = sweep[step].cos * y - sweep[step].sin * x;
+          }
+        }
+      }
+    });
+  }
+
+  template <class Work>
+  static void for_each_thread(int threads, const Work& work) {
+    if (threads <= 1) {
+      work(0, 1);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int thread = 0; thread < threads; ++thread) {
+      workers.emplace_back([&, thread]() { work(thread, threads); });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // A split within the trailing sweeps entries of the window decouples a
+  // block whose eigenvalues are the shifts of the next batch; such a block
+  // would only be rotated around by its own shifts, so it is solved
+  // directly.
+  void try_to_deflate() {
+    bool check_deflation = true;
+    while (check_deflation && current_size_ >= 1) {
+      check_deflation = false;
+      int last_split = std::max(1, current_size_ - sweeps_ + 1);
+      for (int first = current_size_; first >= last_split; --first) {
+        if (zero_under_diagonal(first)) {
+          solve_trailing_block(first);
+          current_size_ = first - 1;
+          check_deflation = true;
+          break;
+        }
+      }
+    }
+  }
+
+  bool zero_under_diagonal(int index) {
+    const DynamicVector& major = diagonals_.get_major_diagonal();
+    return std::abs(diagonals_.get_side_diagonal()(index - 1)) <=
+           precision_ * (std::abs(major(index - 1)) + std::abs(major(index)));
+  }
+
+  void solve_trailing_block(int first) {
+    int length = current_size_ - first + 1;
+    diagonals_.get_side_diagonal()(first - 1) = 0;
+    if (length == 1) {
+      return;
+    }
+    Eigen::SelfAdjointEigenSolver<DynamicMatrix> solver;
+    solver.computeFromTridiagonal(
+        diagonals_.get_major_diagonal().segment(first, length),
+        diagonals_.get_side_diagonal().segment(first, length - 1),
+        p_unitary_ ? Eigen::ComputeEigenvectors : Eigen::EigenvaluesOnly);
+    diagonals_.get_major_diagonal().segment(first, length) =
+        solver.eigenvalues();
+    diagonals_.get_side_diagonal().segment(first, length - 1).setZero();
+    if (p_unitary_) {
+      p_unitary_->middleCols(first, length) =
+          p_unitary_->middleCols(first, length) * solver.eigenvectors();
+    }
+  }
+
+  int size() { return diagonals_.get_size(); }
+
+  Precision precision_;
+  int sweeps_;
+  int number_of_threads_;
+  TridiagonalSymmetric diagonals_;
+  DynamicMatrix* p_unitary_;
+  std::vector<Scalar> shifts_;
+  std::vector<std::vector<Rotation>> rotations_;
+  std::vector<std::atomic<int>> progress_;
+  int current_size_;
+  int batches_ = 0;
+  int total_sweeps_ = 0;
+};
+
+}  // namespace pipelined_tridiagonal_qr
+
+#endif
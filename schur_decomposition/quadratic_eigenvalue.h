@@ -0,0 +1,146 @@
+#ifndef _SCHUR_DECOMPOSITION_QUADRATIC_EIGENVALUE_H
+#define _SCHUR_DECOMPOSITION_QUADRATIC_EIGENVALUE_H
+
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#include "../eigen/Eigen/Dense"
+#include "householder_reflection.h"
+#include "schur_decomposition.h"
+#include "trace_recorder.h"
+
+namespace quadratic_eigenvalue {
+
+// Eigenvalues of the quadratic eigenvalue problem (l^2 M + l C + K) x = 0
+// with real n x n coefficients, from the first companion linearization
+//
+//   L = [     0        I    ]   L [x; l x] = l [x; l x],
+//       [ -M^-1 K  -M^-1 C  ]
+//
+// which is a standard 2n x 2n problem, so the pencil of the usual
+// linearization, its second 2n x 2n matrix and the QZ algorithm are not
+// needed. M^-1 is not formed either: the Householder reflectors of the QR
+// factorization of M are applied blockwise to the two lower blocks of L,
+// written there from C and K, which are then solved with the triangular
+// factor in place. Apart from L, whose Schur form holds the 2n eigenvalues,
+// the only storage is the n x n factor.
+//
+// The coefficients are first scaled as in Fan, Lin and Van Dooren,
+// l = gamma m with gamma = sqrt(|K| / |M|), which brings the norms of the
+// three coefficients close to each other and makes the linearization as
+// backward stable as the Schur decomposition. When M is numerically
+// singular, the reversed problem (M + m C + m^2 K) with m = 1 / l is solved
+// instead, and the eigenvalues at infinity come out as very large or
+// infinite ones.
+template <typename Scalar>
+class QuadraticEigensolver {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using SchurDecomposition = schur_decomposition::SchurDecomposition<Scalar>;
+  using HouseholderReflector =
+      householder_reflection::HouseholderReflector<Scalar>;
+  using DynamicMatrix = SchurDecomposition::DynamicMatrix;
+  using DynamicVector = SchurDecomposition::DynamicVector;
+  using Complex = SchurDecomposition::Complex;
+  using ComplexVector = SchurDecomposition::ComplexVector;
+
+  QuadraticEigensolver(Precision precision, bool is_scaled = true)
+      : precision_(precision), is_scaled_(is_scaled) {
+    assert(precision > 0);
+  }
+
+  // eigenvalues receives the 2n eigenvalues, in no particular order.
+  void run(const DynamicMatrix& mass, const DynamicMatrix& damping,
+           const DynamicMatrix& stiffness, ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    int size = mass.rows();
+    assert(size >= 1 && mass.cols() == size);
+    assert(damping.rows() == size && damping.cols() == size);
+    assert(stiffness.rows() == size && stiffness.cols() == size);
+    trace_recorder::TraceSpan span("quadratic eigenvalue problem",
+                                   "quadratic_eigenvalue", size);
+    find_scaling(mass, stiffness);
+    DynamicMatrix companion;
+    is_reversed_ = !linearize(mass, damping, stiffness, gamma_ * gamma_,
+                              Scalar(1), &companion);
+    if (is_reversed_) {
+      bool is_regular = linearize(stiffness, damping, mass, Scalar(1),
+                                  gamma_ * gamma_, &companion);
+      assert(is_regular && "Both M and K are singular!");
+    }
+    SchurDecomposition(precision_).run_in_place(&companion, nullptr);
+    SchurDecomposition::extract_eigenvalues(companion, eigenvalues);
+    for (Complex& eigenvalue : *eigenvalues) {
+      if (is_reversed_) {
+        eigenvalue = eigenvalue == Complex(0) ? Complex(infinity())
+                                              : Scalar(1) / eigenvalue;
+      }
+      eigenvalue *= gamma_;
+    }
+  }
+
+  // The scale of the eigenvalues, 1 without scaling.
+  Scalar get_gamma() const { return gamma_; }
+
+  // True when the last run() solved the reversed problem because M was
+  // numerically singular.
+  bool is_reversed() const { return is_reversed_; }
+
+ private:
+  // The common factor delta of Fan, Lin and Van Dooren cancels from L and
+  // is left out.
+  void find_scaling(const DynamicMatrix& mass,
+                    const DynamicMatrix& stiffness) {
+    gamma_ = 1;
+    Scalar mass_norm = mass.norm();
+    Scalar stiffness_norm = stiffness.norm();
+    if (is_scaled_ && mass_norm > 0 && stiffness_norm > 0) {
+      gamma_ = std::sqrt(stiffness_norm / mass_norm);
+    }
+  }
+
+  // Writes L for the scaled coefficients leading_scale * leading,
+  // gamma * middle and trailing_scale * trailing, where the scales are
+  // gamma^2 and 1 in either order. Returns false when the leading
+  // coefficient is numerically singular.
+  bool linearize(const DynamicMatrix& leading, const DynamicMatrix& middle,
+                 const DynamicMatrix& trailing, Scalar leading_scale,
+                 Scalar trailing_scale, DynamicMatrix* companion) {
+    int size = leading.rows();
+    companion->setZero(2 * size, 2 * size);
+    companion->topRightCorner(size, size).setIdentity();
+    companion->bottomLeftCorner(size, size) = -trailing_scale * trailing;
+    companion->bottomRightCorner(size, size) = -gamma_ * middle;
+    DynamicMatrix factor = leading_scale * leading;
+    for (int step = 0; step + 1 < size; ++step) {
+      int rows = size - step;
+      HouseholderReflector reflector(factor.col(step).tail(rows));
+      reflector.reflect_left(factor.block(step, step, rows, rows));
+      reflector.reflect_left(
+          companion->block(size + step, 0, rows, 2 * size));
+    }
+    Scalar largest = factor.diagonal().cwiseAbs().maxCoeff();
+    Scalar smallest = factor.diagonal().cwiseAbs().minCoeff();
+    if (!(smallest > size * precision_ * largest)) {
+      return false;
+    }
+    factor.template triangularView<Eigen::Upper>().solveInPlace(
+        companion->bottomRows(size));
+    return true;
+  }
+
+  static Scalar infinity() { return std::numeric_limits<Scalar>::infinity(); }
+
+  Precision precision_;
+  bool is_scaled_;
+  Scalar gamma_ = 1;
+  bool is_reversed_ = false;
+};
+
+}  // namespace quadratic_eigenvalue
+
+#endif
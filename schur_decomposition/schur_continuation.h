@@ -0,0 +1,437 @@
+#ifndef _SCHUR_DECOMPOSITION_SCHUR_CONTINUATION_H
+#define _SCHUR_DECOMPOSITION_SCHUR_CONTINUATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "schur_decomposition.h"
+#include "trace_recorder.h"
+
+namespace schur_continuation {
+
+// Follows the real Schur form of a matrix family A(t). Each new point starts
+// from the Schur basis Z of the previous one: B = Z^T A(t) Z is nearly quasi
+// upper triangular, and a few Newton steps on its invariant subspaces bring
+// it back to that form at the cost of a handful of matrix products. When
+// Newton's method fails (e.g. two real eigenvalues merge into a complex
+// pair) B is decomposed by the QR algorithm instead. The eigenvalues are
+// matched to the previous ones, so that eigenvalues(i) keeps following the
+// same branch.
+template <typename Scalar>
+class SchurContinuation {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Algorithm = schur_decomposition::SchurDecomposition<Scalar>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using Complex = Algorithm::Complex;
+  using ComplexVector = Algorithm::ComplexVector;
+  using SmallMatrix = Eigen::Matrix<Scalar, -1, -1, 0, 4, 4>;
+  using SmallVector = Eigen::Matrix<Scalar, -1, 1, 0, 4, 1>;
+  using Family = std::function<DynamicMatrix(Scalar)>;
+  using Precision = Scalar;
+
+  struct Point {
+    Scalar parameter;
+    ComplexVector eigenvalues;
+    int newton_steps;
+    int iterations;
+  };
+
+  SchurContinuation(Precision precision) : precision_(precision) {
+    assert(precision >= 0);
+  }
+
+  // Decomposes data from scratch; its eigenvalues become the branches.
+  void start(const DynamicMatrix& data) {
+    Algorithm algorithm(precision_);
+    algorithm.run(data, &schur_form_, &unitary_);
+    newton_steps_ = 0;
+    iterations_ = algorithm.get_iterations();
+    Algorithm::extract_eigenvalues(schur_form_, &eigenvalues_);
+  }
+
+  // Decomposes data starting from the current basis. The step is rejected
+  // and the state kept when the eigenvalues cannot be matched unambiguously.
+  bool step(const DynamicMatrix& data) {
+    if (try_step(data) > ambiguity_ratio_) {
+      return false;
+    }
+    accept_step();
+    return true;
+  }
+
+  // Sweeps the parameter from begin to end. The step is halved while the
+  // matching is ambiguous (at most max_halvings times, after which the
+  // point is accepted anyway) and grows back to initial_step once the
+  // branches are well separated again.
+  void track(const Family& family, Scalar begin, Scalar end,
+             Scalar initial_step, std::vector<Point>* path) {
+    assert(path);
+    assert(begin <= end);
+    assert(initial_step > 0);
+    trace_recorder::TraceSpan span("continuation", "schur_continuation");
+    path->clear();
+    start(family(begin));
+    path->push_back({begin, eigenvalues_, newton_steps_, iterations_});
+    Scalar min_step = std::ldexp(initial_step, -max_halvings_);
+    Scalar parameter = begin;
+    Scalar step = initial_step;
+    Scalar last_step = 0;
+    while (parameter < end) {
+      Scalar next = std::min(parameter + step, end);
+      bool predict = step == last_step && next < end && iterations_ == 0;
+      Scalar ratio = try_step(family(next), predict);
+      if (ratio > ambiguity_ratio_ && step > min_step) {
+        step /= 2;
+        continue;
+      }
+      accept_step();
+      last_step = step;
+      parameter = next;
+      path->push_back({parameter, eigenvalues_, newton_steps_, iterations_});
+      if (ratio < ambiguity_ratio_ / 4) {
+        step = std::min(2 * step, initial_step);
+      }
+    }
+  }
+
+  // A matched eigenvalue must be closer to its branch than ambiguity_ratio
+  // times the distance to the nearest other eigenvalue.
+  void set_ambiguity_ratio(Scalar ambiguity_ratio) {
+    assert(ambiguity_ratio > 0);
+    ambiguity_ratio_ = ambiguity_ratio;
+  }
+
+  void set_max_halvings(int max_halvings) {
+    assert(max_halvings >= 0);
+    max_halvings_ = max_halvings;
+  }
+
+  void set_max_newton_steps(int max_newton_steps) {
+    assert(max_newton_steps >= 0);
+    max_newton_steps_ = max_newton_steps;
+  }
+
+  const DynamicMatrix& get_schur_form() const { return schur_form_; }
+  const DynamicMatrix& get_unitary() const { return unitary_; }
+  const ComplexVector& get_eigenvalues() const { return eigenvalues_; }
+
+  // Work spent on the last accepted point: Newton steps, and QR sweeps when
+  // Newton's method had to be abandoned.
+  int get_newton_steps() const { return newton_steps_; }
+  int get_iterations() const { return iterations_; }
+
+ private:
+  static constexpr const Scalar max_correction_norm = 0.5;
+
+  struct Block {
+    int begin;
+    int length;
+  };
+
+  struct Candidate {
+    Scalar distance;
+    int branch;
+    int eigenvalue;
+
+    bool operator<(const Candidate& other) const {
+      return distance < other.distance;
+    }
+  };
+
+  // With predict set, the rotation of the last accepted step is applied to
+  // the basis once more before projecting, which leaves Newton's method a
+  // residual of second order in the step.
+  Scalar try_step(const DynamicMatrix& data, bool predict = false) {
+    assert(data.rows() == unitary_.rows() && data.cols() == unitary_.cols());
+    trace_recorder::TraceSpan span("continuation step", "schur_continuation",
+                                   data.rows());
+    p_basis_ = &unitary_;
+    if (predict) {
+      predicted_basis_.noalias() = unitary_ * step_rotation_;
+      p_basis_ = &predicted_basis_;
+    }
+    product_.noalias() = data * *p_basis_;
+    projected_data_.noalias() = p_basis_->transpose() * product_;
+    next_schur_form_ = projected_data_;
+    next_iterations_ = 0;
+    if (!refine_schur_form()) {
+      next_schur_form_.swap(projected_data_);
+      Algorithm algorithm(precision_);
+      algorithm.run_in_place(&next_schur_form_, &transform_);
+      next_iterations_ = algorithm.get_iterations();
+    }
+    Algorithm::extract_eigenvalues(next_schur_form_, &found_);
+    return match_eigenvalues();
+  }
+
+  void accept_step() {
+    product_.noalias() = *p_basis_ * transform_;
+    unitary_.swap(product_);
+    if (p_basis_ == &predicted_basis_) {
+      product_.noalias() = step_rotation_ * transform_;
+      step_rotation_.swap(product_);
+    } else {
+      step_rotation_ = transform_;
+    }
+    schur_form_.swap(next_schur_form_);
+    eigenvalues_.swap(next_eigenvalues_);
+    newton_steps_ = next_newton_steps_;
+    iterations_ = next_iterations_;
+  }
+
+  // Newton's method keeping the block structure of the previous Schur form.
+  // With T the block upper part of B, each step solves the Sylvester
+  // equation T L - L T = -low(B) for a strictly block lower L and rotates B
+  // by the Cayley transform of the skew matrix L - L^T.
+  bool refine_schur_form() {
+    int size = schur_form_.rows();
+    find_blocks();
+    transform_.setIdentity(size, size);
+    for (next_newton_steps_ = 0;; ++next_newton_steps_) {
+      if (is_block_lower_negligible()) {
+        clear_block_lower();
+        return true;
+      }
+      if (next_newton_steps_ == max_newton_steps_ ||
+          !solve_sylvester_equation()) {
+        return false;
+      }
+      rotate();
+    }
+  }
+
+  // Diagonal blocks of the previous Schur form: a nonzero subdiagonal entry
+  // starts a 2 x 2 block.
+  void find_blocks() {
+    int size = schur_form_.rows();
+    blocks_.clear();
+    for (int begin = 0; begin < size;) {
+      int length = begin + 1 < size && schur_form_(begin + 1, begin) != 0;
+      blocks_.push_back({begin, length + 1});
+      begin += length + 1;
+    }
+  }
+
+  // The deflation criterion of the QR algorithm applied to every entry
+  // below the diagonal blocks.
+  bool is_block_lower_negligible() const {
+    const DynamicMatrix& form = next_schur_form_;
+    for (const Block& block : blocks_) {
+      for (int column = block.begin; column < block.begin + block.length;
+           ++column) {
+        for (int row = block.begin + block.length; row < form.rows(); ++row) {
+          if (std::abs(form(row, column)) >=
+              precision_ * (std::abs(form(row, row)) +
+                            std::abs(form(column, column)))) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void clear_block_lower() {
+    for (const Block& block : blocks_) {
+      int end = block.begin + block.length;
+      next_schur_form_
+          .block(end, block.begin, schur_form_.rows() - end, block.length)
+          .setZero();
+    }
+  }
+
+  // Solves for L block by block: block columns left to right, block rows
+  // bottom to top, each block being a Sylvester equation of size at most
+  // 2 x 2. Fails when the diagonal blocks are too close for a small step.
+  bool solve_sylvester_equation() {
+    int size = schur_form_.rows();
+    correction_.setZero(size, size);
+    product_.resize(size, 2);
+    const DynamicMatrix& form = next_schur_form_;
+    for (int column = 0; column < int(blocks_.size()); ++column) {
+      int left = blocks_[column].begin;
+      int width = blocks_[column].length;
+      product_.leftCols(width).noalias() =
+          correction_.leftCols(left) * form.block(0, left, left, width);
+      for (int row = int(blocks_.size()) - 1; row > column; --row) {
+        int top = blocks_[row].begin;
+        int height = blocks_[row].length;
+        int bottom = top + height;
+        SmallMatrix rhs = product_.block(top, 0, height, width) -
+                          form.block(top, left, height, width);
+        rhs -= form.block(top, bottom, height, size - bottom)
+                   .lazyProduct(correction_.block(bottom, left,
+                                                  size - bottom, width));
+        SmallMatrix solution;
+        if (!solve_small_sylvester(form.block(top, top, height, height),
+                                   form.block(left, left, width, width), rhs,
+                                   &solution)) {
+          return false;
+        }
+        correction_.block(top, left, height, width) = solution;
+      }
+    }
+    return correction_.norm() <= max_correction_norm;
+  }
+
+  // Solves upper * solution - solution * lower = rhs through its Kronecker
+  // form.
+  bool solve_small_sylvester(const SmallMatrix& upper,
+                             const SmallMatrix& lower, const SmallMatrix& rhs,
+                             SmallMatrix* solution) const {
+    int height = upper.rows();
+    int width = lower.rows();
+    int unknowns = height * width;
+    SmallMatrix system = SmallMatrix::Zero(unknowns, unknowns);
+    SmallVector vector(unknowns);
+    for (int j = 0; j < width; ++j) {
+      system.block(j * height, j * height, height, height) = upper;
+      for (int k = 0; k < width; ++k) {
+        for (int i = 0; i < height; ++i) {
+          system(k * height + i, j * height + i) -= lower(j, k);
+        }
+      }
+      vector.segment(j * height, height) = rhs.col(j);
+    }
+    Eigen::FullPivLU<SmallMatrix> lu(system);
+    if (lu.rank() < unknowns) {
+      return false;
+    }
+    vector = lu.solve(vector);
+    solution->resize(height, width);
+    for (int j = 0; j < width; ++j) {
+      solution->col(j) = vector.segment(j * height, height);
+    }
+    return solution->allFinite();
+  }
+
+  // B <- U^T B U with U the Cayley transform (I - X / 2)^{-1} (I + X / 2)
+  // of X = L - L^T. Once the cube of X drops below the rounding error, the
+  // series I + X + X^2 / 2 replaces the solve.
+  void rotate() {
+    product_ = correction_ - correction_.transpose();
+    correction_.swap(product_);
+    Scalar norm = correction_.norm();
+    if (norm * norm * norm <= std::numeric_limits<Scalar>::epsilon()) {
+      rotation_.noalias() = correction_ * correction_;
+      rotation_ /= 2;
+      rotation_ += correction_;
+      rotation_.diagonal().array() += 1;
+    } else {
+      correction_ /= 2;
+      product_ = -correction_;
+      product_.diagonal().array() += 1;
+      rotation_ = correction_;
+      rotation_.diagonal().array() += 1;
+      rotation_ = product_.partialPivLu().solve(rotation_);
+    }
+    product_.noalias() = next_schur_form_ * rotation_;
+    next_schur_form_.noalias() = rotation_.transpose() * product_;
+    if (next_newton_steps_ == 0) {
+      transform_.swap(rotation_);
+    } else {
+      product_.noalias() = transform_ * rotation_;
+      transform_.swap(product_);
+    }
+  }
+
+  // Greedily pairs the closest (branch, eigenvalue) couples and returns the
+  // worst ratio of a branch's move to its distance to the nearest other
+  // eigenvalue. Moves below the precision of the decomposition are ignored,
+  // and so is the ambiguity between the two members of a conjugate pair: at
+  // the point where they meet on the real axis their labels are arbitrary
+  // and no step is small enough to resolve them.
+  Scalar match_eigenvalues() {
+    int size = eigenvalues_.size();
+    std::vector<Candidate> candidates;
+    candidates.reserve(std::size_t(size) * size);
+    Scalar scale = 0;
+    for (int branch = 0; branch < size; ++branch) {
+      scale = std::max(scale, std::abs(eigenvalues_(branch)));
+      for (int eigenvalue = 0; eigenvalue < size; ++eigenvalue) {
+        candidates.push_back(
+            {std::abs(found_(eigenvalue) - eigenvalues_(branch)), branch,
+             eigenvalue});
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    matches_.assign(size, -1);
+    owners_.assign(size, -1);
+    for (const Candidate& candidate : candidates) {
+      if (matches_[candidate.branch] < 0 && owners_[candidate.eigenvalue] < 0) {
+        matches_[candidate.branch] = candidate.eigenvalue;
+        owners_[candidate.eigenvalue] = candidate.branch;
+      }
+    }
+    next_eigenvalues_.resize(size);
+    Scalar worst_ratio = 0;
+    Scalar noise = 100 * std::max(precision_, Scalar(1e-15)) * scale;
+    for (int branch = 0; branch < size; ++branch) {
+      next_eigenvalues_(branch) = found_(matches_[branch]);
+      Scalar distance =
+          std::abs(found_(matches_[branch]) - eigenvalues_(branch));
+      if (distance <= noise) {
+        continue;
+      }
+      worst_ratio = std::max(worst_ratio, distance / find_separation(branch));
+    }
+    return worst_ratio;
+  }
+
+  Scalar find_separation(int branch) const {
+    Scalar separation = std::numeric_limits<Scalar>::infinity();
+    for (int eigenvalue = 0; eigenvalue < found_.size(); ++eigenvalue) {
+      int other = owners_[eigenvalue];
+      if (other == branch ||
+          are_conjugate(eigenvalues_(branch), eigenvalues_(other)) ||
+          are_conjugate(found_(matches_[branch]), found_(eigenvalue))) {
+        continue;
+      }
+      separation = std::min(
+          separation, std::abs(found_(eigenvalue) - eigenvalues_(branch)));
+    }
+    return separation;
+  }
+
+  // extract_eigenvalues() returns complex pairs as exact conjugates.
+  static bool are_conjugate(Complex first, Complex second) {
+    return first.imag() != 0 && first == std::conj(second);
+  }
+
+  Precision precision_;
+  Scalar ambiguity_ratio_ = 0.5;
+  int max_halvings_ = 10;
+  int max_newton_steps_ = 4;
+  DynamicMatrix schur_form_;
+  DynamicMatrix unitary_;
+  ComplexVector eigenvalues_;
+  int newton_steps_ = 0;
+  int iterations_ = 0;
+  std::vector<Block> blocks_;
+  const DynamicMatrix* p_basis_ = nullptr;
+  DynamicMatrix step_rotation_;
+  DynamicMatrix predicted_basis_;
+  DynamicMatrix product_;
+  DynamicMatrix projected_data_;
+  DynamicMatrix correction_;
+  DynamicMatrix rotation_;
+  DynamicMatrix next_schur_form_;
+  DynamicMatrix transform_;
+  ComplexVector found_;
+  ComplexVector next_eigenvalues_;
+  std::vector<int> matches_;
+  std::vector<int> owners_;
+  int next_newton_steps_ = 0;
+  int next_iterations_ = 0;
+};
+
+}  // namespace schur_continuation
+
+#endif
@@ -1,36 +1,84 @@
 #ifndef _SCHUR_DECOMPOSITION_SCHUR_DECOMPOSITION_H
 #define _SCHUR_DECOMPOSITION_SCHUR_DECOMPOSITION_H
 
+#include <complex>
+
 #include "../eigen/Eigen/Dense"
 #include "hessenberg_reduction.h"
 #include "householder_reflection.h"
+#include "memory_policy.h"
+#include "metrics_registry.h"
+#include "solver_policy.h"
+#include "trace_recorder.h"
 
 namespace schur_decomposition {
 
-template <typename Scalar>
+// The shift strategy, the deflation criterion and whether the unitary is
+// accumulated are compile-time policies, see solver_policy.h.
+template <typename Scalar,
+          class Allocator = memory_policy::DefaultAllocator<Scalar>,
+          class UnitaryPolicy = solver_policy::AccumulateUnitary,
+          class ShiftPolicy = solver_policy::FrancisDoubleShift<Scalar>,
+          class DeflationPolicy = solver_policy::NeighbourDeflation<Scalar>>
 class SchurDecomposition {
   static_assert(std::is_arithmetic_v<Scalar>,
                 "Scalar must be arithmetic type!");
 
  public:
-  using HessenbergReduction = hessenberg_reduction::HessenbergReduction<Scalar>;
+  using HessenbergReduction =
+      hessenberg_reduction::HessenbergReduction<Scalar, Allocator>;
   using HouseholderReflector = HessenbergReduction::HouseholderReflector;
   using DynamicMatrix = HessenbergReduction::DynamicMatrix;
   using DynamicVector = HessenbergReduction::DynamicVector;
   using DynamicBlock = Eigen::Block<DynamicMatrix>;
   using Matrix3 = Eigen::Matrix<Scalar, 3, 3>;
   using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+  using Complex = std::complex<Scalar>;
+  using ComplexVector = Eigen::Matrix<Complex, -1, 1>;
   using Precision = Scalar;
 
-  SchurDecomposition(Precision precision) : precision_(precision) {
+  SchurDecomposition(Precision precision, Allocator allocator = Allocator())
+      : precision_(precision), allocator_(std::move(allocator)) {
     assert(precision >= 0);
   }
 
   void run(const DynamicMatrix& data, DynamicMatrix* schur_form,
            DynamicMatrix* unitary) {
+    static_assert(UnitaryPolicy::accumulates,
+                  "The unitary is not accumulated by this solver!");
+    assert(unitary);
     set_internal_resources(data, schur_form, unitary);
-    reduce_to_hessenberg_form();
+    decompose();
+  }
+
+  // Computes the Schur form only; the unitary is neither stored nor updated.
+  void run(const DynamicMatrix& data, DynamicMatrix* schur_form) {
+    set_internal_resources(data, schur_form, nullptr);
+    decompose();
+  }
+
+  // Overwrites data with its Schur form instead of copying it. unitary may be
+  // nullptr when the transform is not needed.
+  void run_in_place(DynamicMatrix* data, DynamicMatrix* unitary) {
+    assert(UnitaryPolicy::accumulates || !unitary);
+    set_in_place_resources(data, unitary);
+    decompose();
+  }
+
+  // Continues from a matrix that is already in upper Hessenberg form, e.g. a
+  // Schur form extended by HessenbergReduction::update(). schur_form is
+  // brought to quasi upper triangular form in place and unitary, which holds
+  // the transform accumulated so far, is updated with the QR sweeps (or may
+  // be nullptr).
+  void run_hessenberg(DynamicMatrix* schur_form, DynamicMatrix* unitary) {
+    assert(UnitaryPolicy::accumulates || !unitary);
+    set_hessenberg_resources(schur_form, unitary);
+    trace_recorder::TraceSpan span("schur continuation",
+                                   "schur_decomposition", size());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSchurDecomposition, size());
     run_QR_algorithm();
+    call.set_sweeps(iterations_);
   }
 
   void set_precision(Precision precision) {
@@ -40,14 +88,58 @@ class SchurDecomposition {
 
   Precision get_precision() const { return precision_; }
 
+  // Number of QR sweeps made by the last run.
+  int get_iterations() const { return iterations_; }
+
+  // Reads the eigenvalues off a quasi upper triangular form produced by this
+  // class: a nonzero subdiagonal entry starts a 2 x 2 block, whose pair of
+  // eigenvalues may be complex conjugate or real.
+  static void extract_eigenvalues(const DynamicMatrix& schur_form,
+                                  ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    assert(schur_form.rows() == schur_form.cols());
+    int size = schur_form.rows();
+    eigenvalues->resize(size);
+    for (int index = 0; index < size; ++index) {
+      if (index + 1 == size || schur_form(index + 1, index) == 0) {
+        (*eigenvalues)(index) = schur_form(index, index);
+        continue;
+      }
+      Scalar half_trace =
+          (schur_form(index, index) + schur_form(index + 1, index + 1)) / 2;
+      Scalar half_gap =
+          (schur_form(index, index) - schur_form(index + 1, index + 1)) / 2;
+      Scalar discriminant =
+          half_gap * half_gap +
+          schur_form(index, index + 1) * schur_form(index + 1, index);
+      Complex root = std::sqrt(Complex(discriminant));
+      (*eigenvalues)(index) = half_trace + root;
+      (*eigenvalues)(index + 1) = half_trace - root;
+      ++index;
+    }
+  }
+
  private:
+  void decompose() {
+    trace_recorder::TraceSpan span("schur decomposition",
+                                   "schur_decomposition", size());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSchurDecomposition, size());
+    reduce_to_hessenberg_form();
+    run_QR_algorithm();
+    call.set_sweeps(iterations_);
+  }
+
   void reduce_to_hessenberg_form() {
-    HessenbergReduction reduction;
-    reduction.run(p_schur_form_, p_unitary_);
+    HessenbergReduction reduction(allocator_);
+    reduction.run(p_schur_form_,
+                  UnitaryPolicy::accumulates ? p_unitary_ : nullptr);
   }
 
   void run_QR_algorithm() {
     cur_size_ = size() - 1;
+    iterations_ = 0;
+    sweeps_since_deflation_ = 0;
     if (cur_size_ >= 2) {
       try_to_deflate();
     }
@@ -58,19 +150,26 @@ class SchurDecomposition {
   }
 
   void make_QR_iteration() {
+    trace_recorder::TraceSpan span("bulge chase", "schur_decomposition",
+                                   cur_size_ - first_ + 1);
+    ++iterations_;
     set_matching_column();
     restore_hessenberg_form();
+    ++sweeps_since_deflation_;
   }
 
   void set_matching_column() {
+    int length = cur_size_ - first_ + 1;
     HouseholderReflector reflector =
-        HouseholderReflector(find_matching_column());
-    update_schur_form(reflector, -1, 3);
-    update_unitary(reflector, -1, 3);
+        HouseholderReflector(ShiftPolicy::find_matching_column(
+            p_schur_form_->block(first_, first_, length, length),
+            cur_size_ - first_, sweeps_since_deflation_));
+    update_schur_form(reflector, first_ - 1, 3);
+    update_unitary(reflector, first_ - 1, 3);
   }
 
   void restore_hessenberg_form() {
-    int step = 0;
+    int step = first_;
     for (; step <= cur_size_ - 3; ++step) {
       HouseholderReflector reflector =
           HouseholderReflector(get_reflected_column(step, 3));
@@ -90,60 +189,62 @@ class SchurDecomposition {
   void update_schur_form(const HouseholderReflector& reflector, int step,
                          int length) {
     reflector.reflect_left(p_schur_form_->block(
-        step + 1, std::max(step, 0), length, size() - std::max(step, 0)));
+        step + 1, std::max(step, first_), length,
+        size() - std::max(step, first_)));
     reflector.reflect_right(p_schur_form_->block(
         0, step + 1, std::min(cur_size_, step + 4) + 1, length));
   }
 
   void update_unitary(const HouseholderReflector& reflector, int step,
                       int length) {
-    reflector.reflect_right(p_unitary_->block(0, step + 1, size(), length));
+    if constexpr (UnitaryPolicy::accumulates) {
+      if (p_unitary_) {
+        reflector.reflect_right(
+            p_unitary_->block(0, step + 1, size(), length));
+      }
+    }
   }
 
   void try_to_deflate() {
+    trace_recorder::TraceSpan span("deflation window", "schur_decomposition",
+                                   cur_size_ + 1);
     bool check_deflation = true;
-    while (check_deflation) {
+    while (check_deflation && cur_size_ >= 1) {
       if (zero_under_diagonal(cur_size_)) {
         decrement_cur_size(1);
-      } else if (zero_under_diagonal(cur_size_ - 1)) {
+      } else if (cur_size_ >= 2 && zero_under_diagonal(cur_size_ - 1)) {
         decrement_cur_size(2);
       } else {
         check_deflation = false;
       }
     }
+    find_active_block();
+  }
+
+  // The sweeps are chased over the unreduced block ending at cur_size_ only:
+  // the shifts of its trailing corner do not reach the blocks above a zero
+  // subdiagonal entry, and a sweep over all of them would never converge.
+  void find_active_block() {
+    first_ = cur_size_;
+    while (first_ > 0 && !zero_under_diagonal(first_)) {
+      --first_;
+    }
+    if (first_ > 0) {
+      (*p_schur_form_)(first_, first_ - 1) = 0;
+    }
   }
 
   void decrement_cur_size(int decrement) {
     (*p_schur_form_)(cur_size_ + 1 - decrement, cur_size_ - decrement) = 0;
     cur_size_ -= decrement;
+    sweeps_since_deflation_ = 0;
   }
 
   bool zero_under_diagonal(int index) {
-    return std::abs((*p_schur_form_)(index, index - 1)) <
-           precision_ * (std::abs((*p_schur_form_)(index, index)) +
-                         std::abs((*p_schur_form_)(index - 1, index - 1)));
-  }
-
-  Vector3 find_matching_column() {
-    Scalar trace = find_bottom_corner_trace();
-    Scalar det = find_bottom_corner_det();
-    Vector3 tmp;
-    tmp(0) = (*p_schur_form_)(0, 0) * (*p_schur_form_)(0, 0) +
-             (*p_schur_form_)(0, 1) * (*p_schur_form_)(1, 0) -
-             trace * (*p_schur_form_)(0, 0) + det;
-    tmp(1) = (*p_schur_form_)(1, 0) *
-             ((*p_schur_form_)(0, 0) + (*p_schur_form_)(1, 1) - trace);
-    tmp(2) = (*p_schur_form_)(1, 0) * (*p_schur_form_)(2, 1);
-    return tmp;
-  }
-
-  Scalar find_bottom_corner_trace() {
-    return p_schur_form_->block(cur_size_ - 1, cur_size_ - 1, 2, 2).trace();
-  }
-
-  Scalar find_bottom_corner_det() {
-    return p_schur_form_->block(cur_size_ - 1, cur_size_ - 1, 2, 2)
-        .determinant();
+    return DeflationPolicy::is_negligible(
+        (*p_schur_form_)(index, index - 1), (*p_schur_form_)(index - 1, index),
+        (*p_schur_form_)(index - 1, index - 1), (*p_schur_form_)(index, index),
+        precision_);
   }
 
   void set_internal_resources(const DynamicMatrix& data,
@@ -152,8 +253,28 @@ class SchurDecomposition {
     assert(schur_form);
     p_schur_form_ = schur_form;
     assert(data.rows() == data.cols());
+    allocator_.allocate(p_schur_form_, data.rows(), data.cols());
+    metrics_registry::record_allocation<Scalar>(
+        metrics_registry::Solver::kSchurDecomposition, data.rows(),
+        data.cols());
     *p_schur_form_ = data;
-    assert(unitary);
+    p_unitary_ = unitary;
+  }
+
+  void set_in_place_resources(DynamicMatrix* data, DynamicMatrix* unitary) {
+    assert(data);
+    assert(data->rows() == data->cols());
+    p_schur_form_ = data;
+    p_unitary_ = unitary;
+  }
+
+  void set_hessenberg_resources(DynamicMatrix* schur_form,
+                                DynamicMatrix* unitary) {
+    assert(schur_form);
+    assert(schur_form->rows() == schur_form->cols());
+    p_schur_form_ = schur_form;
+    assert(!unitary || unitary->rows() == schur_form->rows());
+    assert(!unitary || unitary->cols() == schur_form->cols());
     p_unitary_ = unitary;
   }
 
@@ -163,9 +284,13 @@ class SchurDecomposition {
   }
 
   Precision precision_;
+  Allocator allocator_;
   DynamicMatrix* p_schur_form_;
   DynamicMatrix* p_unitary_;
   int cur_size_;
+  int first_ = 0;
+  int iterations_ = 0;
+  int sweeps_since_deflation_ = 0;
 };
 
 };  // namespace schur_decomposition
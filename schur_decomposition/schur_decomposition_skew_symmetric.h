@@ -0,0 +1,293 @@
+#ifndef _SCHUR_DECOMPOSITION_SCHUR_DECOMPOSITION_SKEW_SYMMETRIC_H
+#define _SCHUR_DECOMPOSITION_SCHUR_DECOMPOSITION_SKEW_SYMMETRIC_H
+
+#include <algorithm>
+#include <complex>
+#include <numeric>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "householder_reflection.h"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+#include "tridiagonal_symmetric.h"
+
+namespace schur_decomposition_skew_symmetric {
+
+// Real Schur form of a skew-symmetric matrix S = Q C Q^T, where C is block
+// diagonal with blocks [0 sigma_j; -sigma_j 0] (sigma_1 >= sigma_2 >= ... >=
+// 0) followed by a single zero when the size is odd, and the eigenvalues are
+// +-i sigma_j.
+//
+// Only the lower triangle of S is read. It is reduced by reflections to a
+// skew-symmetric tridiagonal T with subdiagonal e, using rank-2 updates of
+// the lower triangle only. T = -i D J D^{-1} with D = diag(1, i, i^2, ...)
+// and J the symmetric tridiagonal with zero diagonal and side diagonal e, so
+// the sigma_j are the positive eigenvalues of J and the real and imaginary
+// parts of D v, for the eigenvectors v of J, span the 2 x 2 blocks.
+template <typename Scalar>
+class SchurDecomposition {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using HouseholderReflector =
+      householder_reflection::HouseholderReflector<Scalar>;
+  using TridiagonalSymmetric =
+      tridiagonal_symmetric::TridiagonalSymmetric<Scalar>;
+  using SymmetricAlgorithm =
+      schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using DynamicMatrix = HouseholderReflector::DynamicMatrix;
+  using DynamicVector = HouseholderReflector::DynamicVector;
+  using Complex = std::complex<Scalar>;
+  using ComplexVector = Eigen::Matrix<Complex, -1, 1>;
+
+  SchurDecomposition(Precision precision) : precision_(precision) {
+    assert(precision >= 0);
+  }
+
+  // frequencies receives the size / 2 values sigma_j, unitary receives Q.
+  void run(const DynamicMatrix& data, DynamicVector* frequencies,
+           DynamicMatrix* unitary) {
+    assert(unitary);
+    decompose(data, frequencies, unitary);
+  }
+
+  // Computes the frequencies only; no unitary is stored or updated.
+  void run(const DynamicMatrix& data, DynamicVector* frequencies) {
+    decompose(data, frequencies, nullptr);
+  }
+
+  static void make_canonical_form(const DynamicVector& frequencies, int size,
+                                  DynamicMatrix* canonical_form) {
+    assert(canonical_form);
+    assert(frequencies.rows() == size / 2);
+    canonical_form->setZero(size, size);
+    for (int index = 0; index < frequencies.rows(); ++index) {
+      (*canonical_form)(2 * index, 2 * index + 1) = frequencies(index);
+      (*canonical_form)(2 * index + 1, 2 * index) = -frequencies(index);
+    }
+  }
+
+  // Eigenvalues in the order of the blocks of the canonical form: i sigma_j
+  // and -i sigma_j, then zero for odd sizes.
+  static void extract_eigenvalues(const DynamicVector& frequencies, int size,
+                                  ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    assert(frequencies.rows() == size / 2);
+    eigenvalues->setZero(size);
+    for (int index = 0; index < frequencies.rows(); ++index) {
+      (*eigenvalues)(2 * index) = Complex(0, frequencies(index));
+      (*eigenvalues)(2 * index + 1) = Complex(0, -frequencies(index));
+    }
+  }
+
+  void set_precision(Precision precision) {
+    assert(precision >= 0);
+    precision_ = precision;
+  }
+
+  Precision get_precision() const { return precision_; }
+
+ private:
+  struct Pair {
+    Scalar frequency;
+    DynamicVector first;
+    DynamicVector second;
+  };
+
+  void decompose(const DynamicMatrix& data, DynamicVector* frequencies,
+                 DynamicMatrix* unitary) {
+    assert(data.rows() == data.cols());
+    assert(frequencies);
+    trace_recorder::TraceSpan span("schur decomposition",
+                                   "schur_decomposition_skew_symmetric",
+                                   data.rows());
+    p_unitary_ = unitary;
+    reduce_to_tridiagonal_form(data);
+    solve_tridiagonal();
+    collect_results(frequencies);
+    free_internal_resources();
+  }
+
+  void reduce_to_tridiagonal_form(const DynamicMatrix& data) {
+    trace_recorder::TraceSpan span("tridiagonal reduction",
+                                   "schur_decomposition_skew_symmetric",
+                                   data.rows());
+    tridiagonal_form_ = data;
+    if (p_unitary_) {
+      *p_unitary_ = DynamicMatrix::Identity(size(), size());
+    }
+    side_diagonal_.resize(std::max(size() - 1, 0));
+    for (int col = 0; col + 2 < size(); ++col) {
+      reduce_column(col);
+    }
+    if (size() >= 2) {
+      side_diagonal_(size() - 2) = tridiagonal_form_(size() - 1, size() - 2);
+    }
+  }
+
+  // With P = I - 2 v v^T and p = S v, P S P = S + 2 (v p^T - p v^T) since
+  // v^T S v = 0; only the strictly lower triangle of it is formed.
+  void reduce_column(int col) {
+    int length = size() - col - 1;
+    DynamicVector column = tridiagonal_form_.block(col + 1, col, length, 1);
+    HouseholderReflector reflector(column);
+    const DynamicVector& direction = reflector.direction();
+    side_diagonal_(col) =
+        column(0) - 2 * direction(0) * direction.dot(column);
+    auto trailing = tridiagonal_form_.bottomRightCorner(length, length);
+    DynamicVector product =
+        trailing.template triangularView<Eigen::StrictlyLower>() * direction;
+    product.noalias() -=
+        trailing.template triangularView<Eigen::StrictlyLower>().transpose() *
+        direction;
+    for (int index = 0; index + 1 < length; ++index) {
+      int rest = length - index - 1;
+      trailing.col(index).tail(rest) +=
+          2 * (direction.tail(rest) * product(index) -
+               product.tail(rest) * direction(index));
+    }
+    if (p_unitary_) {
+      reflector.reflect_right(
+          p_unitary_->block(0, col + 1, size(), length));
+    }
+  }
+
+  // T splits into unreduced blocks at negligible entries of e. An unreduced
+  // block of size m gives m / 2 positive eigenvalues of J and, for odd m,
+  // one zero.
+  void solve_tridiagonal() {
+    trace_recorder::TraceSpan span("tridiagonal solve",
+                                   "schur_decomposition_skew_symmetric",
+                                   size());
+    Scalar threshold = precision_ * (side_diagonal_.size() > 0
+                                         ? side_diagonal_.cwiseAbs().maxCoeff()
+                                         : Scalar(0));
+    int first = 0;
+    for (int index = 0; index < size(); ++index) {
+      if (index + 1 == size() ||
+          std::abs(side_diagonal_(index)) <= threshold) {
+        solve_block(first, index + 1 - first);
+        first = index + 1;
+      }
+    }
+  }
+
+  void solve_block(int first, int length) {
+    if (length == 1) {
+      add_kernel_vector(first, DynamicVector::Ones(1));
+      return;
+    }
+    TridiagonalSymmetric diagonals;
+    diagonals.set_diagonals(DynamicVector::Zero(length),
+                            side_diagonal_.segment(first, length - 1));
+    DynamicVector eigenvalues;
+    DynamicMatrix eigenvectors;
+    SymmetricAlgorithm algorithm(precision_);
+    algorithm.run_tridiagonal(std::move(diagonals), &eigenvalues,
+                              p_unitary_ ? &eigenvectors : nullptr);
+    std::vector<int> order(length);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int left, int right) {
+      return eigenvalues(left) > eigenvalues(right);
+    });
+    for (int index = 0; index < length / 2; ++index) {
+      Pair pair = {std::abs(eigenvalues(order[index])), {}, {}};
+      if (p_unitary_) {
+        DynamicVector real;
+        DynamicVector imaginary;
+        split_rotated(eigenvectors.col(order[index]), &real, &imaginary);
+        pair.first = lift(first, imaginary);
+        pair.second = lift(first, real);
+      }
+      pairs_.push_back(std::move(pair));
+    }
+    if (length % 2 == 1) {
+      DynamicVector real;
+      DynamicVector imaginary;
+      if (p_unitary_) {
+        split_rotated(eigenvectors.col(order[length / 2]), &real,
+                      &imaginary);
+      }
+      add_kernel_vector(first, real);
+    }
+  }
+
+  // Real and imaginary parts of D v, normalized: the entries of v with even
+  // and odd indices, with alternating signs.
+  static void split_rotated(const DynamicVector& vector, DynamicVector* real,
+                            DynamicVector* imaginary) {
+    int length = vector.rows();
+    real->setZero(length);
+    imaginary->setZero(length);
+    for (int index = 0; index < length; ++index) {
+      Scalar sign = index % 4 < 2 ? 1 : -1;
+      if (index % 2 == 0) {
+        (*real)(index) = sign * vector(index);
+      } else {
+        (*imaginary)(index) = sign * vector(index);
+      }
+    }
+    real->normalize();
+    imaginary->normalize();
+  }
+
+  // Maps a vector of the block starting at first back to the input basis.
+  DynamicVector lift(int first, const DynamicVector& local) {
+    return p_unitary_->middleCols(first, local.rows()) * local;
+  }
+
+  void add_kernel_vector(int first, const DynamicVector& local) {
+    if (p_unitary_) {
+      kernel_.push_back(lift(first, local));
+    } else {
+      kernel_.emplace_back();
+    }
+  }
+
+  // Zero eigenvalues pair up into zero blocks with any two kernel vectors.
+  void collect_results(DynamicVector* frequencies) {
+    std::stable_sort(pairs_.begin(), pairs_.end(),
+                     [](const Pair& left, const Pair& right) {
+                       return left.frequency > right.frequency;
+                     });
+    frequencies->setZero(size() / 2);
+    for (std::size_t index = 0; index < pairs_.size(); ++index) {
+      (*frequencies)(index) = pairs_[index].frequency;
+    }
+    if (!p_unitary_) {
+      return;
+    }
+    DynamicMatrix basis(size(), size());
+    int col = 0;
+    for (const Pair& pair : pairs_) {
+      basis.col(col++) = pair.first;
+      basis.col(col++) = pair.second;
+    }
+    for (const DynamicVector& vector : kernel_) {
+      basis.col(col++) = vector;
+    }
+    p_unitary_->swap(basis);
+  }
+
+  void free_internal_resources() {
+    tridiagonal_form_.resize(0, 0);
+    pairs_.clear();
+    kernel_.clear();
+  }
+
+  int size() const { return tridiagonal_form_.rows(); }
+
+  Precision precision_;
+  DynamicMatrix tridiagonal_form_;
+  DynamicVector side_diagonal_;
+  DynamicMatrix* p_unitary_;
+  std::vector<Pair> pairs_;
+  std::vector<DynamicVector> kernel_;
+};
+
+}  // namespace schur_decomposition_skew_symmetric
+
+#endif
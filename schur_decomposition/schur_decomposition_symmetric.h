@@ -2,14 +2,25 @@
 #define _SCHUR_DECOMPOSITION_SCHUR_DECOMPOSITION_SYMMETRIC_H
 
 #include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/compact_eigenbasis.h"
 #include "../schur_decomposition/givens_rotation.h"
 #include "../schur_decomposition/hessenberg_reduction.h"
 #include "../schur_decomposition/householder_reflection.h"
+#include "../schur_decomposition/memory_policy.h"
+#include "../schur_decomposition/metrics_registry.h"
+#include "../schur_decomposition/solver_policy.h"
+#include "../schur_decomposition/trace_recorder.h"
 #include "../schur_decomposition/tridiagonal_symmetric.h"
 
 namespace schur_decomposition_symmetric {
 
-template <typename Scalar>
+// The shift strategy, the deflation criterion and whether the unitary is
+// accumulated are compile-time policies, see solver_policy.h.
+template <typename Scalar,
+          class Allocator = memory_policy::DefaultAllocator<Scalar>,
+          class UnitaryPolicy = solver_policy::AccumulateUnitary,
+          class ShiftPolicy = solver_policy::WilkinsonShift<Scalar>,
+          class DeflationPolicy = solver_policy::NeighbourDeflation<Scalar>>
 class SchurDecomposition {
   static_assert(std::is_arithmetic_v<Scalar>,
                 "Scalar must be arithmetic type!");
@@ -19,20 +30,131 @@ class SchurDecomposition {
   using TridiagonalSymmetric =
       tridiagonal_symmetric::TridiagonalSymmetric<Scalar>;
   using Rotator = givens_rotation::GivensRotator<Scalar>;
-  using HessenbergReduction = hessenberg_reduction::HessenbergReduction<Scalar>;
+  using HessenbergReduction =
+      hessenberg_reduction::HessenbergReduction<Scalar, Allocator>;
 
   using DynamicMatrix = HessenbergReduction::DynamicMatrix;
   using DynamicVector = HessenbergReduction::DynamicVector;
+  using CompactEigenbasis = compact_eigenbasis::CompactEigenbasis<Scalar>;
 
-  SchurDecomposition(Precision precision) : precision_(precision) {
+  SchurDecomposition(Precision precision, Allocator allocator = Allocator())
+      : precision_(precision), allocator_(std::move(allocator)) {
     assert(precision >= 0);
   }
 
   void run(const DynamicMatrix& data, DynamicVector* eigenvalues,
            DynamicMatrix* unitary) {
+    static_assert(UnitaryPolicy::accumulates,
+                  "The unitary is not accumulated by this solver!");
+    assert(unitary);
     set_internal_resources(data, eigenvalues, unitary);
+    trace_recorder::TraceSpan span(
+        "schur decomposition", "schur_decomposition_symmetric", data.rows());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, data.rows());
+    reduce_to_hessenberg_form(copy_data(data));
+    run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
+    free_internal_resources();
+  }
+
+  // Computes the eigenvalues only; no unitary is stored or updated.
+  void run(const DynamicMatrix& data, DynamicVector* eigenvalues) {
+    set_internal_resources(data, eigenvalues, nullptr);
+    trace_recorder::TraceSpan span(
+        "schur decomposition", "schur_decomposition_symmetric", data.rows());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, data.rows());
+    reduce_to_hessenberg_form(copy_data(data));
+    run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
+    free_internal_resources();
+  }
+
+  // Records the eigenbasis as its reflectors and rotations in basis instead
+  // of a dense unitary, see CompactEigenbasis.
+  void run(const DynamicMatrix& data, DynamicVector* eigenvalues,
+           CompactEigenbasis* basis) {
+    static_assert(UnitaryPolicy::accumulates,
+                  "The unitary is not accumulated by this solver!");
+    assert(basis);
+    set_internal_resources(data, eigenvalues, nullptr);
+    p_basis_ = basis;
+    p_basis_->reset(data.rows());
+    trace_recorder::TraceSpan span(
+        "schur decomposition", "schur_decomposition_symmetric", data.rows());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, data.rows());
+    reduce_to_factored_hessenberg_form(copy_data(data));
+    run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
+    free_internal_resources();
+  }
+
+  // Uses data as the working matrix of the reduction instead of a copy, data
+  // is overwritten. unitary may be nullptr when the eigenvectors are not
+  // needed.
+  void run_in_place(DynamicMatrix* data, DynamicVector* eigenvalues,
+                    DynamicMatrix* unitary) {
+    assert(data);
+    assert(UnitaryPolicy::accumulates || !unitary);
+    set_internal_resources(*data, eigenvalues, unitary);
+    trace_recorder::TraceSpan span(
+        "schur decomposition", "schur_decomposition_symmetric", data->rows());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, data->rows());
     reduce_to_hessenberg_form(data);
     run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
+    free_internal_resources();
+  }
+
+  // Computes the eigenvalues only, with data as the working matrix.
+  void run_in_place(DynamicMatrix* data, DynamicVector* eigenvalues) {
+    run_in_place(data, eigenvalues, static_cast<DynamicMatrix*>(nullptr));
+  }
+
+  // Records the eigenbasis in basis like run(), with data as the working
+  // matrix of the reduction instead of a copy; data is overwritten.
+  void run_in_place(DynamicMatrix* data, DynamicVector* eigenvalues,
+                    CompactEigenbasis* basis) {
+    static_assert(UnitaryPolicy::accumulates,
+                  "The unitary is not accumulated by this solver!");
+    assert(data);
+    assert(basis);
+    set_internal_resources(*data, eigenvalues, nullptr);
+    p_basis_ = basis;
+    p_basis_->reset(data->rows());
+    trace_recorder::TraceSpan span(
+        "schur decomposition", "schur_decomposition_symmetric", data->rows());
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, data->rows());
+    reduce_to_factored_hessenberg_form(data);
+    run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
+    free_internal_resources();
+  }
+
+  // Starts from a matrix that is already symmetric tridiagonal, e.g. the
+  // tridiagonal of a Lanczos process. unitary receives its eigenvectors, or
+  // may be nullptr.
+  void run_tridiagonal(TridiagonalSymmetric diagonals,
+                       DynamicVector* eigenvalues, DynamicMatrix* unitary) {
+    assert(eigenvalues);
+    assert(UnitaryPolicy::accumulates || !unitary);
+    int size = diagonals.get_size();
+    if (unitary) {
+      allocate(unitary, size, size);
+      unitary->setIdentity();
+    }
+    p_unitary_ = unitary;
+    diagonals_ = std::move(diagonals);
+    trace_recorder::TraceSpan span("schur decomposition",
+                                   "schur_decomposition_symmetric", size);
+    metrics_registry::SolverCall call(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, size);
+    run_QR_algorithm(eigenvalues);
+    call.set_sweeps(iterations_);
     free_internal_resources();
   }
 
@@ -43,17 +165,53 @@ class SchurDecomposition {
 
   Precision get_precision() const { return precision_; }
 
+  // Number of QR sweeps made by the last run.
+  int get_iterations() const { return iterations_; }
+
  private:
-  void reduce_to_hessenberg_form(const DynamicMatrix& data) {
-    HessenbergReduction reduction;
-    DynamicMatrix hessenberg_form = data;
-    reduction.run(&hessenberg_form, p_unitary_);
-    diagonals_ = TridiagonalSymmetric::extract_diagonals(hessenberg_form);
+  DynamicMatrix copy_data(const DynamicMatrix& data) {
+    DynamicMatrix hessenberg_form;
+    allocate(&hessenberg_form, data.rows(), data.cols());
+    hessenberg_form = data;
+    return hessenberg_form;
+  }
+
+  void allocate(DynamicMatrix* buffer, int rows, int cols) {
+    allocator_.allocate(buffer, rows, cols);
+    metrics_registry::record_allocation<Scalar>(
+        metrics_registry::Solver::kSymmetricSchurDecomposition, rows, cols);
+  }
+
+  void reduce_to_hessenberg_form(DynamicMatrix hessenberg_form) {
+    reduce_to_hessenberg_form(&hessenberg_form);
+  }
+
+  void reduce_to_hessenberg_form(DynamicMatrix* hessenberg_form) {
+    HessenbergReduction reduction(allocator_);
+    reduction.run(hessenberg_form,
+                  UnitaryPolicy::accumulates ? p_unitary_ : nullptr);
+    diagonals_ = TridiagonalSymmetric::extract_diagonals(*hessenberg_form);
+  }
+
+  void reduce_to_factored_hessenberg_form(DynamicMatrix hessenberg_form) {
+    reduce_to_factored_hessenberg_form(&hessenberg_form);
+  }
+
+  void reduce_to_factored_hessenberg_form(DynamicMatrix* hessenberg_form) {
+    HessenbergReduction reduction(allocator_);
+    std::vector<typename HessenbergReduction::HouseholderReflector>
+        reflectors;
+    reduction.run_factored(hessenberg_form, &reflectors);
+    p_basis_->set_reflectors(std::move(reflectors));
+    diagonals_ = TridiagonalSymmetric::extract_diagonals(*hessenberg_form);
   }
 
   void run_QR_algorithm(DynamicVector* eigenvalues) {
     current_size_ = size() - 1;
+    iterations_ = 0;
+    try_to_deflate();
     while (current_size_ >= 1) {
+      ++iterations_;
       take_QR_implicit_step();
       try_to_deflate();
     }
@@ -62,24 +220,52 @@ class SchurDecomposition {
   }
 
   void take_QR_implicit_step() {
+    trace_recorder::TraceSpan span("bulge chase",
+                                   "schur_decomposition_symmetric",
+                                   current_size_ + 1);
+    find_active_block();
     set_matching_column();
     restore_tridiagonal_form();
   }
 
+  // The sweep runs on the unreduced block that ends at current_size_; a
+  // negligible side entry above it is set to zero, since a bulge would not
+  // get past it and the block would never see a shifted step.
+  void find_active_block() {
+    active_begin_ = current_size_ - 1;
+    while (active_begin_ > 0 &&
+           !DeflationPolicy::is_negligible(
+               diagonals_.get_side_diagonal()(active_begin_ - 1),
+               diagonals_.get_side_diagonal()(active_begin_ - 1),
+               diagonals_.get_major_diagonal()(active_begin_ - 1),
+               diagonals_.get_major_diagonal()(active_begin_), precision_)) {
+      --active_begin_;
+    }
+    if (active_begin_ > 0) {
+      diagonals_.get_side_diagonal()(active_begin_ - 1) = 0;
+    }
+  }
+
   void set_matching_column() {
+    if (p_basis_) {
+      p_basis_->start_sweep(active_begin_);
+    }
     Rotator rotator = Rotator(
-        diagonals_.get_major_diagonal()(0) - choose_shift_approximation(),
-        diagonals_.get_side_diagonal()(0));
-    update_diagonals(rotator, 0);
-    update_unitary(rotator, 0);
-    if (current_size_ > 1) {
-      save_current_bulge(rotator, 0);
-      update_side_diagonal(rotator, 0);
+        diagonals_.get_major_diagonal()(active_begin_) -
+            ShiftPolicy::find_shift(diagonals_.get_major_diagonal(),
+                                    diagonals_.get_side_diagonal(),
+                                    current_size_, precision_),
+        diagonals_.get_side_diagonal()(active_begin_));
+    update_diagonals(rotator, active_begin_);
+    update_unitary(rotator, active_begin_);
+    if (current_size_ > active_begin_ + 1) {
+      save_current_bulge(rotator, active_begin_);
+      update_side_diagonal(rotator, active_begin_);
     };
   }
 
   void restore_tridiagonal_form() {
-    for (int step = 1; step <= current_size_ - 1; ++step) {
+    for (int step = active_begin_ + 1; step <= current_size_ - 1; ++step) {
       Rotator rotator = Rotator(get_rotated_item(step), current_bulge_);
       update_diagonals(rotator, step);
       update_unitary(rotator, step);
@@ -90,44 +276,6 @@ class SchurDecomposition {
     }
   }
 
-  Scalar choose_shift_approximation() {
-    if (current_size_ > 1) {
-      return find_wilkinson_shift();
-    }
-    return find_eigenvalue();
-  }
-
-  Scalar find_eigenvalue() {
-    DynamicMatrix square(2, 2);
-    square << diagonals_.get_major_diagonal()(0),
-        diagonals_.get_side_diagonal()(0), diagonals_.get_side_diagonal()(0),
-        diagonals_.get_major_diagonal()(1);
-
-    Scalar trace = square.trace();
-    Scalar det = square.determinant();
-    return (trace + std::sqrt(trace * trace - 4 * det)) / 2;
-  }
-
-  Scalar find_wilkinson_shift() {
-    Scalar delta = diagonals_.get_major_diagonal()(current_size_ - 1) -
-                   diagonals_.get_major_diagonal()(current_size_);
-    Scalar hypot = std::hypot(
-        delta / 2, diagonals_.get_side_diagonal()(current_size_ - 1));
-
-    if (!near_zero(delta) && delta > 0) {
-      return diagonals_.get_major_diagonal()(current_size_) -
-             std::pow(diagonals_.get_side_diagonal()(current_size_ - 1), 2) /
-                 (delta / 2 + hypot);
-    }
-    if (!near_zero(delta) && delta < 0) {
-      return diagonals_.get_major_diagonal()(current_size_) -
-             std::pow(diagonals_.get_side_diagonal()(current_size_ - 1), 2) /
-                 (delta / 2 - hypot);
-    }
-    return diagonals_.get_major_diagonal()(current_size_) -
-           std::abs(diagonals_.get_side_diagonal()(current_size_ - 1));
-  }
-
   void update_diagonals(const Rotator& rotator, int step) {
     DynamicMatrix square(2, 2);
 
@@ -143,7 +291,7 @@ class SchurDecomposition {
     diagonals_.get_major_diagonal()(step + 1) = square(1, 1);
     diagonals_.get_side_diagonal()(step) = square(0, 1);
 
-    if (step > 0) {
+    if (step > active_begin_) {
       diagonals_.get_side_diagonal()(step - 1) *= rotator.cos();
       diagonals_.get_side_diagonal()(step - 1) +=
           rotator.sin() * current_bulge_;
@@ -155,7 +303,14 @@ class SchurDecomposition {
   }
 
   void update_unitary(const Rotator& rotator, int step) {
-    rotator.rotate_right(p_unitary_->block(0, step, size(), 2));
+    if constexpr (UnitaryPolicy::accumulates) {
+      if (p_basis_) {
+        p_basis_->add_rotation(rotator);
+      }
+      if (p_unitary_) {
+        rotator.rotate_right(p_unitary_->block(0, step, size(), 2));
+      }
+    }
   }
 
   void save_current_bulge(const Rotator& rotator, int step) {
@@ -167,16 +322,19 @@ class SchurDecomposition {
   }
 
   void try_to_deflate() {
-    if (zero_under_diagonal()) {
+    trace_recorder::TraceSpan span("deflation window",
+                                   "schur_decomposition_symmetric",
+                                   current_size_ + 1);
+    while (current_size_ >= 1 && zero_under_diagonal()) {
       --current_size_;
     }
   }
 
   bool zero_under_diagonal() {
-    return std::abs(diagonals_.get_side_diagonal()(current_size_ - 1)) <
-           precision_ *
-               (std::abs(diagonals_.get_major_diagonal()(current_size_ - 1)) +
-                std::abs(diagonals_.get_major_diagonal()(current_size_)));
+    Scalar side = diagonals_.get_side_diagonal()(current_size_ - 1);
+    return DeflationPolicy::is_negligible(
+        side, side, diagonals_.get_major_diagonal()(current_size_ - 1),
+        diagonals_.get_major_diagonal()(current_size_), precision_);
   }
 
   void set_internal_resources(const DynamicMatrix& data,
@@ -184,26 +342,30 @@ class SchurDecomposition {
                               DynamicMatrix* unitary) {
     assert(data.rows() == data.cols());
     assert(eigenvalues);
-    assert(unitary);
     p_unitary_ = unitary;
   }
 
-  void free_internal_resources() { diagonals_ = {}; }
+  void free_internal_resources() {
+    diagonals_ = {};
+    p_basis_ = nullptr;
+  }
 
   void extract_eigenvalues(DynamicVector* eigenvalues) {
     *eigenvalues = diagonals_.get_major_diagonal();
   }
 
-  bool near_zero(Scalar value) { return std::abs(value) < precision_; }
-
   int size() { return diagonals_.get_size(); }
 
   Precision precision_;
+  Allocator allocator_;
   TridiagonalSymmetric diagonals_;
   DynamicMatrix* p_unitary_;
+  CompactEigenbasis* p_basis_ = nullptr;
 
   int current_size_;
+  int active_begin_ = 0;
   Scalar current_bulge_;
+  int iterations_ = 0;
 };
 
 };  // namespace schur_decomposition_symmetric
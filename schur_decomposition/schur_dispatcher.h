@@ -0,0 +1,559 @@
+#ifndef _SCHUR_DECOMPOSITION_SCHUR_DISPATCHER_H
+#define _SCHUR_DECOMPOSITION_SCHUR_DISPATCHER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+#include "../eigen/Eigen/Dense"
+#include "hessenberg_reduction.h"
+#include "householder_reflection.h"
+#include "memory_policy.h"
+#include "schur_decomposition.h"
+#include "solver_policy.h"
+#include "trace_recorder.h"
+
+namespace schur_dispatcher {
+
+enum class Path {
+  // Francis double shift on fixed-size matrices, unrolled by the compiler.
+  kFixedSize,
+  // SchurDecomposition, one double shift sweep at a time.
+  kDoubleShift,
+  // Aggressive early deflation with the window eigenvalues as shifts.
+  kAggressiveDeflation,
+};
+
+inline const char* path_name(Path path) {
+  switch (path) {
+    case Path::kFixedSize:
+      return "fixed_size";
+    case Path::kDoubleShift:
+      return "double_shift";
+    case Path::kAggressiveDeflation:
+      return "aggressive_deflation";
+  }
+  return "unknown";
+}
+
+// Largest size with a fixed-size implementation.
+constexpr const int fixed_size_limit = 4;
+
+// Where the dispatcher switches paths; tune() measures them on the current
+// machine.
+struct Thresholds {
+  // The fixed-size path is used up to this size, at most fixed_size_limit.
+  int fixed_size_max = fixed_size_limit;
+  // Aggressive early deflation is used from this size on; below it the cost
+  // of the windows outweighs the sweeps they save.
+  int aggressive_size_min = 384;
+  // Active blocks up to this size are finished by the double shift loop.
+  int window_min = 24;
+};
+
+// Real Schur decomposition A = Q T Q^T through one entry point that picks
+// the implementation from the size; the output has the format of
+// SchurDecomposition, so SchurDecomposition::extract_eigenvalues() reads the
+// eigenvalues of any path.
+//
+// Large matrices go through the aggressive early deflation of Braman, Byers
+// and Mathias: the trailing window of the active block is brought to Schur
+// form, and its eigenvalues whose entries in the spike, the column that
+// couples the window to the rest, are negligible are deflated at once,
+// often many of them before a single sweep. The eigenvalues left in the
+// window become the shifts of the following double shift sweeps, which are
+// chased one after another over the whole active block.
+template <typename Scalar>
+class SchurDispatcher {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using Algorithm = schur_decomposition::SchurDecomposition<
+      Scalar, memory_policy::DefaultAllocator<Scalar>,
+      solver_policy::AccumulateUnitary,
+      solver_policy::ExceptionalDoubleShift<Scalar>>;
+  using HessenbergReduction = Algorithm::HessenbergReduction;
+  using HouseholderReflector = Algorithm::HouseholderReflector;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using DynamicVector = Algorithm::DynamicVector;
+  using Complex = Algorithm::Complex;
+  using ComplexVector = Algorithm::ComplexVector;
+  using Vector3 = Algorithm::Vector3;
+  using Clock = std::chrono::steady_clock;
+
+  // Sweeps without deflation after which an exceptional shift is taken, as
+  // in ExceptionalDoubleShift.
+  static constexpr const int exceptional_period = 10;
+
+  SchurDispatcher(Precision precision, Thresholds thresholds = Thresholds())
+      : precision_(precision), thresholds_(thresholds) {
+    assert(precision >= 0);
+    assert(thresholds.fixed_size_max <= fixed_size_limit);
+    assert(thresholds.window_min >= 3);
+  }
+
+  // unitary may be nullptr when the transform is not needed.
+  void run(const DynamicMatrix& data, DynamicMatrix* schur_form,
+           DynamicMatrix* unitary) {
+    assert(data.rows() == data.cols());
+    assert(schur_form);
+    int size = data.rows();
+    last_path_ = choose_path(size);
+    trace_recorder::TraceSpan span(path_name(last_path_), "schur_dispatcher",
+                                   size);
+    switch (last_path_) {
+      case Path::kFixedSize:
+        run_fixed_size(data, schur_form, unitary);
+        return;
+      case Path::kDoubleShift:
+        if (unitary) {
+          Algorithm(precision_).run(data, schur_form, unitary);
+        } else {
+          Algorithm(precision_).run(data, schur_form);
+        }
+        return;
+      case Path::kAggressiveDeflation:
+        *schur_form = data;
+        HessenbergReduction().run(schur_form, unitary);
+        run_aggressive_deflation(schur_form, unitary);
+        return;
+    }
+  }
+
+  Path choose_path(int size) const {
+    if (size <= thresholds_.fixed_size_max) {
+      return Path::kFixedSize;
+    }
+    if (size >= thresholds_.aggressive_size_min) {
+      return Path::kAggressiveDeflation;
+    }
+    return Path::kDoubleShift;
+  }
+
+  Path get_last_path() const { return last_path_; }
+
+  const Thresholds& get_thresholds() const { return thresholds_; }
+
+  void set_thresholds(Thresholds thresholds) {
+    assert(thresholds.fixed_size_max <= fixed_size_limit);
+    assert(thresholds.window_min >= 3);
+    thresholds_ = thresholds;
+  }
+
+  // Times the paths on random matrices with unitary and returns the
+  // thresholds at which each one starts to win: the sizes up to
+  // fixed_size_limit are tried for the fixed-size path and the sizes
+  // candidates, in increasing order, for the aggressive deflation.
+  static Thresholds tune(Precision precision,
+                         std::initializer_list<int> candidates = {128, 192,
+                                                                  256, 384,
+                                                                  512},
+                         int repetitions = 3) {
+    Thresholds thresholds;
+    thresholds.fixed_size_max = 0;
+    for (int size = 1; size <= fixed_size_limit; ++size) {
+      if (measure(precision, Path::kFixedSize, size, repetitions) <
+          measure(precision, Path::kDoubleShift, size, repetitions)) {
+        thresholds.fixed_size_max = size;
+      }
+    }
+    thresholds.aggressive_size_min = std::numeric_limits<int>::max();
+    for (int size : candidates) {
+      if (measure(precision, Path::kAggressiveDeflation, size, repetitions) <
+          measure(precision, Path::kDoubleShift, size, repetitions)) {
+        thresholds.aggressive_size_min = size;
+        break;
+      }
+    }
+    return thresholds;
+  }
+
+ private:
+  static double measure(Precision precision, Path path, int size,
+                        int repetitions) {
+    Thresholds thresholds;
+    thresholds.fixed_size_max = path == Path::kFixedSize ? size : 0;
+    thresholds.aggressive_size_min = path == Path::kAggressiveDeflation
+                                         ? 0
+                                         : std::numeric_limits<int>::max();
+    SchurDispatcher dispatcher(precision, thresholds);
+    DynamicMatrix data = DynamicMatrix::Random(size, size);
+    DynamicMatrix schur_form;
+    DynamicMatrix unitary;
+    // Tiny sizes are timed over many runs to rise above the clock.
+    int runs = std::max(1, 4096 / (size * size * size));
+    double best = 0;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+      Clock::time_point start = Clock::now();
+      for (int run = 0; run < runs; ++run) {
+        dispatcher.run(data, &schur_form, &unitary);
+      }
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+      if (repetition == 0 || elapsed.count() < best) {
+        best = elapsed.count();
+      }
+    }
+    return best;
+  }
+
+  template <class Matrix>
+  bool is_negligible(const Matrix& h, int index) const {
+    return solver_policy::NeighbourDeflation<Scalar>::is_negligible(
+        h(index, index - 1), h(index - 1, index), h(index - 1, index - 1),
+        h(index, index), precision_);
+  }
+
+  void run_fixed_size(const DynamicMatrix& data, DynamicMatrix* schur_form,
+                      DynamicMatrix* unitary) {
+    switch (data.rows()) {
+      case 1:
+        return run_fixed_size<1>(data, schur_form, unitary);
+      case 2:
+        return run_fixed_size<2>(data, schur_form, unitary);
+      case 3:
+        return run_fixed_size<3>(data, schur_form, unitary);
+      case 4:
+        return run_fixed_size<4>(data, schur_form, unitary);
+    }
+    assert(data.rows() == 0);
+    *schur_form = data;
+    if (unitary) {
+      unitary->resize(0, 0);
+    }
+  }
+
+  // The loop of SchurDecomposition with exceptional shifts, on matrices whose
+  // size is known at compile time. A 2 x 2 block is left as it is, as in
+  // SchurDecomposition.
+  template <int N>
+  void run_fixed_size(const DynamicMatrix& data, DynamicMatrix* schur_form,
+                      DynamicMatrix* unitary) {
+    using Matrix = Eigen::Matrix<Scalar, N, N>;
+    Matrix h = data;
+    Matrix q = Matrix::Identity();
+    if constexpr (N >= 3) {
+      run_fixed_size_loop<N>(&h, &q);
+    }
+    *schur_form = h;
+    if (unitary) {
+      *unitary = q;
+    }
+  }
+
+  template <int N>
+  void run_fixed_size_loop(Eigen::Matrix<Scalar, N, N>* p_h,
+                           Eigen::Matrix<Scalar, N, N>* p_q) {
+    auto& h = *p_h;
+    for (int col = 0; col + 2 < N; ++col) {
+      if (col + 3 < N) {
+        reflect_fixed_size<N, 3>(h.col(col).template segment<3>(col + 1),
+                                 col + 1, p_h, p_q);
+      } else {
+        reflect_fixed_size<N, 2>(h.col(col).template segment<2>(col + 1),
+                                 col + 1, p_h, p_q);
+      }
+    }
+    clear_below_subdiagonal(p_h);
+    int last = N - 1;
+    int sweeps = 0;
+    while (last >= 2) {
+      int first = last;
+      while (first > 0 && !is_negligible(h, first)) {
+        --first;
+      }
+      if (first > 0) {
+        h(first, first - 1) = 0;
+      }
+      if (last - first <= 1) {
+        last = first - 1;
+        sweeps = 0;
+        continue;
+      }
+      auto block = h.block(first, first, last - first + 1, last - first + 1);
+      Vector3 column =
+          solver_policy::ExceptionalDoubleShift<Scalar>::find_matching_column(
+              block, last - first, sweeps);
+      reflect_fixed_size<N, 3>(column, first, p_h, p_q);
+      for (int step = first; step + 3 <= last; ++step) {
+        reflect_fixed_size<N, 3>(h.col(step).template segment<3>(step + 1),
+                                 step + 1, p_h, p_q);
+      }
+      reflect_fixed_size<N, 2>(
+          h.col(last - 2).template segment<2>(last - 1), last - 1, p_h, p_q);
+      clear_below_subdiagonal(p_h);
+      ++sweeps;
+    }
+  }
+
+  // h = P h P and q = q P for the reflector P that maps vector onto the
+  // first of the L indices from first on; the whole rows and columns are
+  // updated, which costs nothing at these sizes.
+  template <int N, int L, class Vector>
+  static void reflect_fixed_size(const Vector& vector, int first,
+                                 Eigen::Matrix<Scalar, N, N>* h,
+                                 Eigen::Matrix<Scalar, N, N>* q) {
+    Eigen::Matrix<Scalar, L, 1> direction = vector;
+    Scalar norm = direction.norm();
+    if (norm == 0) {
+      return;
+    }
+    direction(0) += direction(0) > 0 ? norm : -norm;
+    direction.normalize();
+    auto rows = h->template middleRows<L>(first);
+    rows -= direction * (2 * (direction.transpose() * rows));
+    auto cols = h->template middleCols<L>(first);
+    cols -= 2 * (cols * direction) * direction.transpose();
+    auto basis = q->template middleCols<L>(first);
+    basis -= 2 * (basis * direction) * direction.transpose();
+  }
+
+  template <class Matrix>
+  static void clear_below_subdiagonal(Matrix* h) {
+    for (int col = 0; col + 2 < h->cols(); ++col) {
+      h->col(col).tail(h->rows() - col - 2).setZero();
+    }
+  }
+
+  void run_aggressive_deflation(DynamicMatrix* h, DynamicMatrix* unitary) {
+    p_h_ = h;
+    p_unitary_ = unitary;
+    int last = size() - 1;
+    int sweeps = 0;
+    while (last >= 0) {
+      int first = last;
+      while (first > 0 && !is_negligible(*h, first)) {
+        --first;
+      }
+      if (first > 0) {
+        (*h)(first, first - 1) = 0;
+      }
+      if (last - first + 1 <= thresholds_.window_min) {
+        solve_window(first, last);
+        last = first - 1;
+        sweeps = 0;
+        continue;
+      }
+      ComplexVector shifts;
+      int deflated = deflate_aggressively(first, last, &shifts);
+      last -= deflated;
+      if (deflated > 0) {
+        sweeps = 0;
+      }
+      if (deflated > 0 && last - first + 1 <= thresholds_.window_min) {
+        continue;
+      }
+      ++sweeps;
+      if (sweeps % exceptional_period == 0) {
+        // With period 1 the policy always returns its exceptional shift.
+        chase(first, last,
+              solver_policy::ExceptionalDoubleShift<Scalar, 1>::
+                  find_matching_column(h->block(first, first,
+                                                last - first + 1,
+                                                last - first + 1),
+                                       last - first, 1));
+        continue;
+      }
+      sweep_with_shifts(first, last, shifts);
+    }
+    p_h_ = nullptr;
+    p_unitary_ = nullptr;
+  }
+
+  // Number of shifts taken from a deflation window of the given size.
+  static int count_shifts(int window) { return std::max(2, window / 2 & ~1); }
+
+  // Window of the aggressive deflation for an active block of the given
+  // size, as in LAPACK's xLAQR0: larger blocks deflate more per window.
+  int choose_window(int block) const {
+    int window = std::max(thresholds_.window_min, block / 8);
+    return std::min(window, block);
+  }
+
+  // Brings the block [first, last] to Schur form with the double shift loop
+  // and applies its transform to the rest of the matrix.
+  void solve_window(int first, int last) {
+    int length = last - first + 1;
+    if (length <= 1) {
+      return;
+    }
+    DynamicMatrix window = p_h_->block(first, first, length, length);
+    DynamicMatrix transform = DynamicMatrix::Identity(length, length);
+    Algorithm(precision_).run_hessenberg(&window, &transform);
+    p_h_->block(first, first, length, length) = window;
+    apply_transform(first, transform);
+  }
+
+  // h and unitary outside the diagonal block of transform, which starts at
+  // index first.
+  void apply_transform(int first, const DynamicMatrix& transform) {
+    int length = transform.rows();
+    int after = first + length;
+    if (first > 0) {
+      auto above = p_h_->block(0, first, first, length);
+      above = above * transform;
+    }
+    if (after < size()) {
+      auto right = p_h_->block(first, after, length, size() - after);
+      right = transform.transpose() * right;
+    }
+    if (p_unitary_) {
+      auto basis = p_unitary_->middleCols(first, length);
+      basis = basis * transform;
+    }
+  }
+
+  // Deflates the converged eigenvalues at the bottom of the trailing window
+  // of the block [first, last] and returns their number. shifts receives the
+  // eigenvalues of the rest of the window.
+  int deflate_aggressively(int first, int last, ComplexVector* shifts) {
+    trace_recorder::TraceSpan span("aggressive deflation",
+                                   "schur_dispatcher", last - first + 1);
+    int length = choose_window(last - first + 1);
+    int top = last - length + 1;
+    Scalar spike_scale = top > first ? (*p_h_)(top, top - 1) : 0;
+    DynamicMatrix window = p_h_->block(top, top, length, length);
+    DynamicMatrix transform = DynamicMatrix::Identity(length, length);
+    Algorithm(precision_).run_hessenberg(&window, &transform);
+    DynamicVector spike = spike_scale * transform.row(0).transpose();
+    int kept = length;
+    while (kept > 0) {
+      int block = kept >= 2 && window(kept - 1, kept - 2) != 0 ? 2 : 1;
+      if (!is_spike_negligible(window, spike, kept - block, block)) {
+        break;
+      }
+      kept -= block;
+    }
+    spike.tail(length - kept).setZero();
+    Algorithm::extract_eigenvalues(window.topLeftCorner(kept, kept), shifts);
+    if (top > first && kept >= 2) {
+      restore_hessenberg_form(kept, &window, &transform, &spike);
+    }
+    p_h_->block(top, top, length, length) = window;
+    if (top > first) {
+      p_h_->block(top, top - 1, length, 1) = spike;
+    }
+    apply_transform(top, transform);
+    return length - kept;
+  }
+
+  // The test of LAPACK's xLAQR2: the spike entries of the diagonal block
+  // starting at index are negligible next to its eigenvalues.
+  bool is_spike_negligible(const DynamicMatrix& window,
+                           const DynamicVector& spike, int index,
+                           int block) const {
+    Scalar safe_minimum = std::numeric_limits<Scalar>::min();
+    Scalar magnitude = std::abs(window(index, index));
+    if (block == 2) {
+      magnitude += std::sqrt(std::abs(window(index + 1, index))) *
+                   std::sqrt(std::abs(window(index, index + 1)));
+    }
+    Scalar bound = std::max(safe_minimum, precision_ * magnitude);
+    if (magnitude == 0) {
+      bound = std::max(safe_minimum, precision_ * spike.cwiseAbs().maxCoeff());
+    }
+    return spike.segment(index, block).cwiseAbs().maxCoeff() <= bound;
+  }
+
+  // After the deflation the leading kept x kept part of the window is
+  // quasi-triangular but the spike is full there. A reflector folds the
+  // spike into its first entry and the part is reduced back to Hessenberg
+  // form; both transforms are added to transform.
+  void restore_hessenberg_form(int kept, DynamicMatrix* window,
+                               DynamicMatrix* transform,
+                               DynamicVector* spike) {
+    int length = window->rows();
+    HouseholderReflector reflector(spike->head(kept));
+    reflector.reflect_left(window->block(0, 0, kept, length));
+    reflector.reflect_right(window->block(0, 0, kept, kept));
+    reflector.reflect_right(transform->block(0, 0, length, kept));
+    Scalar norm = spike->head(kept).norm();
+    (*spike)(0) = (*spike)(0) > 0 ? -norm : norm;
+    spike->segment(1, kept - 1).setZero();
+    DynamicMatrix corner = window->topLeftCorner(kept, kept);
+    DynamicMatrix reduction;
+    HessenbergReduction().run(&corner, &reduction);
+    window->topLeftCorner(kept, kept) = corner;
+    window->block(0, kept, kept, length - kept) =
+        reduction.transpose() * window->block(0, kept, kept, length - kept);
+    transform->leftCols(kept) = transform->leftCols(kept) * reduction;
+  }
+
+  // Double shift sweeps over the block [first, last] with the shifts taken
+  // from the end, where the converged ones are. A complex shift comes with
+  // its conjugate right after it and the real ones are paired in order.
+  void sweep_with_shifts(int first, int last, const ComplexVector& shifts) {
+    int index = shifts.rows() - count_shifts(shifts.rows());
+    index = std::max(index, 0);
+    if (index > 0 && shifts(index).imag() != 0 &&
+        shifts(index) == std::conj(shifts(index - 1))) {
+      ++index;
+    }
+    auto block = p_h_->block(first, first, last - first + 1, last - first + 1);
+    int pending_real = -1;
+    for (; index < shifts.rows(); ++index) {
+      Complex other;
+      if (shifts(index).imag() != 0) {
+        if (index + 1 == shifts.rows()) {
+          break;
+        }
+        other = shifts(++index);
+      } else if (pending_real < 0) {
+        pending_real = index;
+        continue;
+      } else {
+        other = shifts(pending_real);
+        pending_real = -1;
+      }
+      Scalar trace = (shifts(index) + other).real();
+      Scalar det = (shifts(index) * other).real();
+      chase(first, last,
+            solver_policy::make_matching_column<Scalar>(block, trace, det));
+    }
+  }
+
+  // One double shift sweep over the block [first, last] starting from the
+  // first column of (H - s_1)(H - s_2); the updates reach the whole rows and
+  // columns, since the Schur form of the full matrix is kept.
+  void chase(int first, int last, const Vector3& column) {
+    trace_recorder::TraceSpan span("bulge chase", "schur_dispatcher",
+                                   last - first + 1);
+    reflect(HouseholderReflector(column), first, last, first - 1, 3);
+    int step = first;
+    for (; step <= last - 3; ++step) {
+      DynamicVector bulge = p_h_->block(step + 1, step, 3, 1);
+      reflect(HouseholderReflector(bulge), first, last, step, 3);
+    }
+    DynamicVector bulge = p_h_->block(step + 1, step, 2, 1);
+    reflect(HouseholderReflector(bulge), first, last, step, 2);
+  }
+
+  void reflect(const HouseholderReflector& reflector, int first, int last,
+               int step, int length) {
+    int left = std::max(step, first);
+    reflector.reflect_left(
+        p_h_->block(step + 1, left, length, size() - left));
+    reflector.reflect_right(
+        p_h_->block(0, step + 1, std::min(last, step + length + 1) + 1,
+                    length));
+    if (p_unitary_) {
+      reflector.reflect_right(
+          p_unitary_->block(0, step + 1, size(), length));
+    }
+  }
+
+  int size() const { return p_h_->rows(); }
+
+  Precision precision_;
+  Thresholds thresholds_;
+  Path last_path_ = Path::kDoubleShift;
+  DynamicMatrix* p_h_ = nullptr;
+  DynamicMatrix* p_unitary_ = nullptr;
+};
+
+}  // namespace schur_dispatcher
+
+#endif
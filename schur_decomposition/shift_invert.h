@@ -0,0 +1,381 @@
+#ifndef _SCHUR_DECOMPOSITION_SHIFT_INVERT_H
+#define _SCHUR_DECOMPOSITION_SHIFT_INVERT_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../eigen/Eigen/Sparse"
+#include "schur_decomposition.h"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+
+namespace shift_invert {
+
+// The count eigenvalues of a sparse matrix A nearest to a shift s, and
+// their eigenvectors, without forming A densely.
+//
+// A - s I is factorized once, by the sparse LDL^T of Eigen for a symmetric
+// A (with the sparse LU as a fallback when a pivot vanishes) and by the
+// sparse LU otherwise, and the Krylov-Schur method of Stewart runs on the
+// operator (A - s I)^-1, whose largest eigenvalues t = 1 / (l - s) belong
+// to the wanted l. A basis V of m vectors satisfies
+// (A - s I)^-1 V_m = V_m+1 H with an (m + 1) x m matrix H; the Ritz values
+// of its leading m x m block come from SchurDecomposition, or from the
+// symmetric SchurDecomposition for a symmetric A, and a restart keeps the
+// invariant subspace of the block for the wanted Ritz values, which is again
+// such a decomposition. The vectors of V are orthogonalized twice by
+// classical Gram-Schmidt, so the symmetric case is Lanczos with full
+// reorthogonalization.
+template <typename Scalar>
+class ShiftInvertSolver {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using SchurDecomposition = schur_decomposition::SchurDecomposition<Scalar>;
+  using SymmetricSchurDecomposition =
+      schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using SparseMatrix = Eigen::SparseMatrix<Scalar>;
+  using DynamicMatrix = SchurDecomposition::DynamicMatrix;
+  using DynamicVector = SchurDecomposition::DynamicVector;
+  using Complex = SchurDecomposition::Complex;
+  using ComplexVector = SchurDecomposition::ComplexVector;
+  using ComplexMatrix = Eigen::Matrix<Complex, -1, -1>;
+
+  // subspace_size is the largest dimension of the Krylov subspace, by
+  // default max(2 count + 1, 20).
+  ShiftInvertSolver(Precision precision, int max_restarts = 100,
+                    int subspace_size = 0)
+      : precision_(precision),
+        max_restarts_(max_restarts),
+        subspace_size_(subspace_size) {
+    assert(precision > 0);
+    assert(max_restarts >= 0);
+    assert(subspace_size >= 0);
+  }
+
+  // eigenvalues receives the count eigenvalues nearest to shift, nearest
+  // first; eigenvectors, when not nullptr, their unit eigenvectors.
+  void run(const SparseMatrix& data, Scalar shift, int count,
+           ComplexVector* eigenvalues, ComplexMatrix* eigenvectors = nullptr) {
+    assert(eigenvalues);
+    trace_recorder::TraceSpan span("shift invert", "shift_invert",
+                                   data.rows());
+    Eigen::SparseLU<SparseMatrix> lu;
+    factorize_lu(data, shift, &lu);
+    is_symmetric_ = false;
+    iterate(data.rows(), count);
+    ComplexVector values;
+    ComplexMatrix vectors;
+    find_ritz_pairs(&values, &vectors);
+    int size = data.rows();
+    eigenvalues->resize(count);
+    if (eigenvectors) {
+      eigenvectors->resize(size, count);
+    }
+    ComplexMatrix basis =
+        basis_.leftCols(dimension()).template cast<Complex>();
+    for (int index = 0; index < count; ++index) {
+      (*eigenvalues)(index) = shift + Scalar(1) / values(index);
+      if (eigenvectors) {
+        eigenvectors->col(index) = basis * vectors.col(index);
+        eigenvectors->col(index).normalize();
+      }
+    }
+    apply_inverse_ = nullptr;
+  }
+
+  // run() for a symmetric A, of which only the lower triangle is read.
+  void run_symmetric(const SparseMatrix& data, Scalar shift, int count,
+                     DynamicVector* eigenvalues,
+                     DynamicMatrix* eigenvectors = nullptr) {
+    assert(eigenvalues);
+    trace_recorder::TraceSpan span("shift invert", "shift_invert",
+                                   data.rows());
+    SparseMatrix shifted = shifted_matrix(data, shift);
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt(shifted);
+    Eigen::SparseLU<SparseMatrix> lu;
+    if (ldlt.info() == Eigen::Success) {
+      apply_inverse_ = [&ldlt](DynamicVector* vector) {
+        *vector = ldlt.solve(*vector);
+      };
+    } else {
+      // LDL^T does not pivot; an indefinite A - s I may need the LU.
+      SparseMatrix full = shifted.template selfadjointView<Eigen::Lower>();
+      factorize_lu(full, 0, &lu);
+    }
+    is_symmetric_ = true;
+    iterate(data.rows(), count);
+    DynamicVector values;
+    DynamicMatrix vectors;
+    find_symmetric_ritz_pairs(&values, &vectors);
+    eigenvalues->resize(count);
+    for (int index = 0; index < count; ++index) {
+      (*eigenvalues)(index) = shift + 1 / values(index);
+    }
+    if (eigenvectors) {
+      *eigenvectors = basis_.leftCols(dimension()) * vectors.leftCols(count);
+    }
+    apply_inverse_ = nullptr;
+  }
+
+  int get_restarts() const { return restarts_; }
+
+  // Number of solves with the factorization of A - s I in the last run.
+  int get_operator_applications() const { return operator_applications_; }
+
+  // False when the last run stopped at max_restarts.
+  bool is_converged() const { return is_converged_; }
+
+ private:
+  static SparseMatrix shifted_matrix(const SparseMatrix& data, Scalar shift) {
+    assert(data.rows() == data.cols());
+    SparseMatrix identity(data.rows(), data.cols());
+    identity.setIdentity();
+    return data - shift * identity;
+  }
+
+  void factorize_lu(const SparseMatrix& data, Scalar shift,
+                    Eigen::SparseLU<SparseMatrix>* lu) {
+    SparseMatrix shifted = shifted_matrix(data, shift);
+    shifted.makeCompressed();
+    lu->compute(shifted);
+    assert(lu->info() == Eigen::Success && "A - shift I is singular!");
+    apply_inverse_ = [lu](DynamicVector* vector) {
+      *vector = lu->solve(*vector);
+    };
+  }
+
+  int dimension() const { return basis_.cols() - 1; }
+
+  void iterate(int size, int count) {
+    assert(count >= 1 && count <= size);
+    int dimension = subspace_size_ > 0 ? subspace_size_
+                                       : std::max(2 * count + 1, 20);
+    dimension = std::min(std::max(dimension, count + 1), size);
+    basis_.setZero(size, dimension + 1);
+    projection_.setZero(dimension + 1, dimension);
+    basis_.col(0) = DynamicVector::Random(size).normalized();
+    count_ = count;
+    restarts_ = 0;
+    operator_applications_ = 0;
+    int kept = 0;
+    while (true) {
+      expand(kept);
+      DynamicMatrix subspace;
+      is_converged_ = find_wanted_subspace(&subspace);
+      if (is_converged_ || restarts_ == max_restarts_) {
+        return;
+      }
+      kept = restart(subspace);
+      ++restarts_;
+    }
+  }
+
+  // Extends the decomposition from first to dimension() vectors.
+  void expand(int first) {
+    int size = basis_.rows();
+    for (int column = first; column < dimension(); ++column) {
+      DynamicVector vector = basis_.col(column);
+      apply_inverse_(&vector);
+      ++operator_applications_;
+      auto kept = basis_.leftCols(column + 1);
+      DynamicVector coefficients = kept.transpose() * vector;
+      vector -= kept * coefficients;
+      DynamicVector correction = kept.transpose() * vector;
+      vector -= kept * correction;
+      coefficients += correction;
+      projection_.col(column).head(column + 1) = coefficients;
+      Scalar norm = vector.norm();
+      if (norm > precision_ * coefficients.norm()) {
+        projection_(column + 1, column) = norm;
+        basis_.col(column + 1) = vector / norm;
+      } else if (column + 1 < size) {
+        // The subspace is invariant; it is continued by any vector
+        // orthogonal to it, with no coupling.
+        basis_.col(column + 1) = orthogonal_vector(column + 1);
+      } else {
+        basis_.col(column + 1).setZero();
+      }
+    }
+  }
+
+  DynamicVector orthogonal_vector(int columns) const {
+    auto kept = basis_.leftCols(columns);
+    DynamicVector vector = DynamicVector::Random(basis_.rows());
+    for (int pass = 0; pass < 2; ++pass) {
+      vector -= kept * (kept.transpose() * vector);
+    }
+    return vector.normalized();
+  }
+
+  // Returns true when the count wanted Ritz pairs have converged; otherwise
+  // subspace receives the orthonormal basis of the invariant subspace of the
+  // leading block of H that the restart keeps.
+  bool find_wanted_subspace(DynamicMatrix* subspace) const {
+    if (is_symmetric_) {
+      DynamicVector values;
+      DynamicMatrix vectors;
+      find_symmetric_ritz_pairs(&values, &vectors);
+      if (has_converged(vectors, values)) {
+        return true;
+      }
+      *subspace =
+          vectors.leftCols(count_kept(values.template cast<Complex>()));
+      return false;
+    }
+    ComplexVector values;
+    ComplexMatrix vectors;
+    find_ritz_pairs(&values, &vectors);
+    if (has_converged(vectors, values)) {
+      return true;
+    }
+    *subspace = real_subspace(values, vectors, count_kept(values));
+    return false;
+  }
+
+  // Replaces V_m+1 and H by V_m S, v_m+1 and the projection of H on S for
+  // the invariant subspace S; returns its dimension.
+  int restart(const DynamicMatrix& subspace) {
+    int dimension = this->dimension();
+    int kept = subspace.cols();
+    DynamicMatrix leading = projection_.topRows(dimension);
+    DynamicMatrix coupling = projection_.bottomRows(1) * subspace;
+    DynamicMatrix reduced = subspace.transpose() * leading * subspace;
+    DynamicVector residual = basis_.col(dimension);
+    DynamicMatrix kept_vectors = basis_.leftCols(dimension) * subspace;
+    basis_.leftCols(kept) = kept_vectors;
+    basis_.col(kept) = residual;
+    projection_.setZero();
+    projection_.topLeftCorner(kept, kept) = reduced;
+    projection_.block(kept, 0, 1, kept) = coupling;
+    return kept;
+  }
+
+  // Ritz values t of the leading block of H by decreasing modulus, the
+  // first count of which are wanted, with unit Ritz vectors y.
+  void find_ritz_pairs(ComplexVector* values, ComplexMatrix* vectors) const {
+    int dimension = this->dimension();
+    DynamicMatrix leading = projection_.topRows(dimension);
+    DynamicMatrix schur_form;
+    SchurDecomposition(precision_).run(leading, &schur_form);
+    ComplexVector unsorted;
+    SchurDecomposition::extract_eigenvalues(schur_form, &unsorted);
+    std::vector<int> order = order_by_modulus(unsorted);
+    values->resize(dimension);
+    vectors->resize(dimension, dimension);
+    for (int index = 0; index < dimension; ++index) {
+      (*values)(index) = unsorted(order[index]);
+      vectors->col(index) = ritz_vector(leading, (*values)(index));
+    }
+  }
+
+  void find_symmetric_ritz_pairs(DynamicVector* values,
+                                 DynamicMatrix* vectors) const {
+    int dimension = this->dimension();
+    DynamicMatrix leading = projection_.topRows(dimension);
+    leading = (leading + leading.transpose()) / 2;
+    DynamicVector unsorted;
+    DynamicMatrix unitary;
+    SymmetricSchurDecomposition(precision_).run(leading, &unsorted, &unitary);
+    std::vector<int> order =
+        order_by_modulus(unsorted.template cast<Complex>());
+    values->resize(dimension);
+    vectors->resize(dimension, dimension);
+    for (int index = 0; index < dimension; ++index) {
+      (*values)(index) = unsorted(order[index]);
+      vectors->col(index) = unitary.col(order[index]);
+    }
+  }
+
+  static std::vector<int> order_by_modulus(const ComplexVector& values) {
+    std::vector<int> order(values.rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int left, int right) {
+      return std::abs(values(left)) > std::abs(values(right));
+    });
+    return order;
+  }
+
+  // Eigenvector of leading for its eigenvalue value by two steps of inverse
+  // iteration, with the shift moved off value by the precision.
+  ComplexVector ritz_vector(const DynamicMatrix& leading, Complex value) const {
+    int dimension = leading.rows();
+    Scalar scale = std::max(leading.cwiseAbs().maxCoeff(), Scalar(1));
+    ComplexMatrix shifted = leading.template cast<Complex>();
+    shifted.diagonal().array() -= value + Complex(precision_ * scale);
+    Eigen::PartialPivLU<ComplexMatrix> lu(shifted);
+    ComplexVector vector = ComplexVector::Ones(dimension);
+    for (int step = 0; step < 2; ++step) {
+      vector = lu.solve(vector);
+      vector.normalize();
+    }
+    return vector;
+  }
+
+  // The residual of the Ritz pair (t, V y) is |h y| for the last row h of H.
+  template <class Matrix, class Vector>
+  bool has_converged(const Matrix& vectors, const Vector& values) const {
+    using Entry = typename Matrix::Scalar;
+    auto last_row = projection_.row(dimension()).template cast<Entry>();
+    for (int index = 0; index < count_; ++index) {
+      Scalar residual = std::abs(last_row.dot(vectors.col(index)));
+      if (!(residual <= precision_ * std::abs(values(index)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The wanted Ritz pairs and half of the others are kept, without
+  // splitting a complex conjugate pair.
+  int count_kept(const ComplexVector& values) const {
+    int dimension = values.rows();
+    int kept = count_ + (dimension - count_) / 2;
+    if (kept < dimension && values(kept - 1).imag() != 0 &&
+        values(kept) == std::conj(values(kept - 1))) {
+      ++kept;
+    }
+    return std::min(kept, dimension - 1);
+  }
+
+  // Orthonormal basis of the real invariant subspace of the first kept Ritz
+  // pairs: the real vectors, and the real and imaginary parts of the first
+  // vector of each conjugate pair.
+  static DynamicMatrix real_subspace(const ComplexVector& values,
+                                     const ComplexMatrix& vectors, int kept) {
+    int dimension = vectors.rows();
+    DynamicMatrix columns(dimension, kept);
+    for (int index = 0; index < kept; ++index) {
+      columns.col(index) = vectors.col(index).real();
+      if (values(index).imag() != 0 && index + 1 < kept) {
+        ++index;
+        columns.col(index) = vectors.col(index - 1).imag();
+      }
+    }
+    Eigen::HouseholderQR<DynamicMatrix> qr(columns);
+    return qr.householderQ() * DynamicMatrix::Identity(dimension, kept);
+  }
+
+  Precision precision_;
+  int max_restarts_;
+  int subspace_size_;
+  std::function<void(DynamicVector*)> apply_inverse_;
+  bool is_symmetric_ = false;
+  DynamicMatrix basis_;
+  DynamicMatrix projection_;
+  int count_ = 0;
+  int restarts_ = 0;
+  int operator_applications_ = 0;
+  bool is_converged_ = true;
+};
+
+}  // namespace shift_invert
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef _SCHUR_DECOMPOSITION_SOLVER_POLICY_H
+#define _SCHUR_DECOMPOSITION_SOLVER_POLICY_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "../eigen/Eigen/Dense"
+
+namespace solver_policy {
+
+// Compile-time policies of the QR solvers, passed as template parameters
+// next to the allocation policy (see memory_policy.h).
+//
+// An accumulation policy has a member
+//   static constexpr bool accumulates;
+// and with accumulates == false the solver contains no code updating the
+// unitary at all; the methods taking one do not compile.
+//
+// A double shift policy of the nonsymmetric solver is any class with a
+// method
+//   static Vector3 find_matching_column(const DynamicMatrix& hessenberg,
+//                                       int last, int sweeps);
+// returning the first column of (H - s_1)(H - s_2) for the shifts s_1, s_2
+// of the active block ending at row last, where sweeps is the number of
+// sweeps since the last deflation.
+//
+// A shift policy of the symmetric solver is any class with a method
+//   static Scalar find_shift(const DynamicVector& major,
+//                            const DynamicVector& side, int last,
+//                            Scalar precision);
+// for the active block of the tridiagonal ending at index last.
+//
+// A deflation policy is any class with a method
+//   static bool is_negligible(Scalar sub, Scalar super, Scalar upper,
+//                             Scalar lower, Scalar precision);
+// deciding whether the subdiagonal entry sub of the 2 x 2 diagonal block
+// [upper super; sub lower] may be set to zero.
+
+struct AccumulateUnitary {
+  static constexpr bool accumulates = true;
+};
+
+struct SkipUnitary {
+  static constexpr bool accumulates = false;
+};
+
+template <typename Scalar>
+using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+
+// First column of H^2 - trace H + det for the 2 x 2 trailing block data
+// (trace, det), which only involves the leading 3 x 2 entries of H.
+template <typename Scalar, class Matrix>
+Vector3<Scalar> make_matching_column(const Matrix& hessenberg, Scalar trace,
+                                     Scalar det) {
+  Vector3<Scalar> column;
+  column(0) = hessenberg(0, 0) * hessenberg(0, 0) +
+              hessenberg(0, 1) * hessenberg(1, 0) -
+              trace * hessenberg(0, 0) + det;
+  column(1) =
+      hessenberg(1, 0) * (hessenberg(0, 0) + hessenberg(1, 1) - trace);
+  column(2) = hessenberg(1, 0) * hessenberg(2, 1);
+  return column;
+}
+
+// Francis double shift: the eigenvalues of the trailing 2 x 2 block.
+template <typename Scalar>
+class FrancisDoubleShift {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  template <class Matrix>
+  static Vector3<Scalar> find_matching_column(const Matrix& hessenberg,
+                                              int last, int) {
+    auto corner = hessenberg.block(last - 1, last - 1, 2, 2);
+    return make_matching_column<Scalar>(hessenberg, corner.trace(),
+                                        corner.determinant());
+  }
+};
+
+// Francis double shift, replaced by the ad hoc shift of LAPACK's xLAHQR
+// after every period sweeps without deflation. This breaks the cycles of
+// the plain double shift on e.g. the spectra symmetric about zero of
+// permutation matrices.
+template <typename Scalar, int period = 10>
+class ExceptionalDoubleShift {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+  static_assert(period > 0, "Period must be positive!");
+
+ public:
+  template <class Matrix>
+  static Vector3<Scalar> find_matching_column(const Matrix& hessenberg,
+                                              int last, int sweeps) {
+    if (sweeps == 0 || sweeps % period != 0) {
+      return FrancisDoubleShift<Scalar>::find_matching_column(hessenberg,
+                                                              last, sweeps);
+    }
+    Scalar scale = std::abs(hessenberg(last, last - 1));
+    if (last >= 2) {
+      scale += std::abs(hessenberg(last - 1, last - 2));
+    }
+    // The block [a b; s a] with a = 3/4 s + h_last,last and b = -7/16 s.
+    Scalar diagonal = Scalar(0.75) * scale + hessenberg(last, last);
+    Scalar det = diagonal * diagonal + Scalar(0.4375) * scale * scale;
+    return make_matching_column<Scalar>(hessenberg, 2 * diagonal, det);
+  }
+};
+
+// Wilkinson shift: the eigenvalue of the trailing 2 x 2 block closer to its
+// last diagonal entry. When the active block is 2 x 2 its larger eigenvalue
+// is taken, which deflates it in a single sweep.
+template <typename Scalar>
+class WilkinsonShift {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  template <class Vector>
+  static Scalar find_shift(const Vector& major, const Vector& side, int last,
+                           Scalar precision) {
+    if (last == 1) {
+      return (major(0) + major(1) +
+              std::hypot(major(0) - major(1), 2 * side(0))) /
+             2;
+    }
+    Scalar delta = major(last - 1) - major(last);
+    Scalar hypot = std::hypot(delta / 2, side(last - 1));
+    if (std::abs(delta) >= precision && delta > 0) {
+      return major(last) - std::pow(side(last - 1), 2) / (delta / 2 + hypot);
+    }
+    if (std::abs(delta) >= precision && delta < 0) {
+      return major(last) - std::pow(side(last - 1), 2) / (delta / 2 - hypot);
+    }
+    return major(last) - std::abs(side(last - 1));
+  }
+};
+
+// sub is negligible next to the neighbouring diagonal entries.
+template <typename Scalar>
+class NeighbourDeflation {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  static bool is_negligible(Scalar sub, Scalar, Scalar upper, Scalar lower,
+                            Scalar precision) {
+    return std::abs(sub) <= precision * (std::abs(upper) + std::abs(lower));
+  }
+};
+
+// The conservative criterion of Ahues and Tisseur used by LAPACK's xLAHQR:
+// on top of the neighbour test, the product sub * super must be negligible
+// next to the product of the diagonal entries of the shifted block, which
+// keeps small eigenvalues of graded matrices accurate. Entries below the
+// smallest normalized number are negligible in any case.
+template <typename Scalar>
+class AhuesTisseurDeflation {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  static bool is_negligible(Scalar sub, Scalar super, Scalar upper,
+                            Scalar lower, Scalar precision) {
+    Scalar safe_minimum = std::numeric_limits<Scalar>::min();
+    if (std::abs(sub) <= safe_minimum) {
+      return true;
+    }
+    if (!NeighbourDeflation<Scalar>::is_negligible(sub, super, upper, lower,
+                                                   precision)) {
+      return false;
+    }
+    Scalar off_max = std::max(std::abs(sub), std::abs(super));
+    Scalar off_min = std::min(std::abs(sub), std::abs(super));
+    Scalar gap = std::abs(upper - lower);
+    Scalar diagonal_max = std::max(std::abs(lower), gap);
+    Scalar diagonal_min = std::min(std::abs(lower), gap);
+    Scalar scale = diagonal_max + off_max;
+    return off_min * (off_max / scale) <=
+           std::max(safe_minimum,
+                    precision * (diagonal_min * (diagonal_max / scale)));
+  }
+};
+
+}  // namespace solver_policy
+
+#endif
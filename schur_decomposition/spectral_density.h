@@ -0,0 +1,374 @@
+#ifndef _SCHUR_DECOMPOSITION_SPECTRAL_DENSITY_H
+#define _SCHUR_DECOMPOSITION_SPECTRAL_DENSITY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+#include "tridiagonal_symmetric.h"
+
+namespace spectral_density {
+
+// Estimators of the eigenvalue histogram (density of states) of a symmetric
+// operator that is only available through products y = A x. Both estimators
+// average over random +-1 probe vectors, which are processed in parallel;
+// the operator must therefore be safe to call from several threads at once.
+// Probe i is drawn from a generator seeded with seed + i, so the result does
+// not depend on the number of threads.
+
+template <typename Scalar>
+using DynamicVector = Eigen::Matrix<Scalar, -1, 1>;
+
+template <typename Scalar>
+using Operator =
+    std::function<void(const DynamicVector<Scalar>&, DynamicVector<Scalar>*)>;
+
+template <typename Scalar>
+struct Bounds {
+  Scalar lower;
+  Scalar upper;
+};
+
+// counts(i) is the estimated number of eigenvalues in the i-th of the equal
+// bins that split [lower, upper].
+template <typename Scalar>
+struct Histogram {
+  Scalar lower;
+  Scalar upper;
+  DynamicVector<Scalar> counts;
+
+  Histogram(Scalar lower, Scalar upper, int bins)
+      : lower(lower), upper(upper), counts(DynamicVector<Scalar>::Zero(bins)) {
+    assert(lower < upper);
+    assert(bins >= 1);
+  }
+
+  int get_bins() const { return counts.rows(); }
+
+  Scalar get_bin_width() const { return (upper - lower) / get_bins(); }
+
+  Scalar get_edge(int index) const { return lower + index * get_bin_width(); }
+};
+
+template <typename Scalar>
+DynamicVector<Scalar> make_probe(int size, std::uint64_t seed) {
+  std::mt19937_64 generator(seed);
+  std::bernoulli_distribution sign;
+  DynamicVector<Scalar> probe(size);
+  for (int index = 0; index < size; ++index) {
+    probe(index) = sign(generator) ? 1 : -1;
+  }
+  return probe;
+}
+
+// Runs work(probe) for every probe on up to number_of_threads threads.
+template <class Work>
+void for_each_probe(int probes, int number_of_threads, const Work& work) {
+  int threads = std::max(1, std::min(number_of_threads, probes));
+  if (threads == 1) {
+    for (int probe = 0; probe < probes; ++probe) {
+      work(probe);
+    }
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int thread = 0; thread < threads; ++thread) {
+    workers.emplace_back([&, thread]() {
+      for (int probe = thread; probe < probes; probe += threads) {
+        work(probe);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Lanczos process without reorthogonalization started from start / |start|.
+// Stops early when the Krylov space becomes invariant. The norm of the last
+// residual is stored in last_beta if it is not nullptr.
+template <typename Scalar>
+tridiagonal_symmetric::TridiagonalSymmetric<Scalar> run_lanczos(
+    const Operator<Scalar>& apply, const DynamicVector<Scalar>& start,
+    int steps, Scalar* last_beta = nullptr) {
+  assert(steps >= 1);
+  trace_recorder::TraceSpan span("lanczos", "spectral_density", steps);
+  int size = start.rows();
+  DynamicVector<Scalar> major(steps);
+  DynamicVector<Scalar> side(steps);
+  DynamicVector<Scalar> previous = DynamicVector<Scalar>::Zero(size);
+  DynamicVector<Scalar> current = start / start.norm();
+  DynamicVector<Scalar> next(size);
+  Scalar beta = 0;
+  int length = 0;
+  while (length < steps) {
+    apply(current, &next);
+    next -= beta * previous;
+    major(length) = current.dot(next);
+    next -= major(length) * current;
+    Scalar scale = std::abs(major(length)) + beta;
+    beta = next.norm();
+    side(length++) = beta;
+    if (beta <= std::numeric_limits<Scalar>::epsilon() * scale) {
+      beta = 0;
+      break;
+    }
+    previous.swap(current);
+    current = next / beta;
+  }
+  if (last_beta) {
+    *last_beta = beta;
+  }
+  tridiagonal_symmetric::TridiagonalSymmetric<Scalar> diagonals;
+  diagonals.set_diagonals(major.head(length), side.head(length - 1));
+  return diagonals;
+}
+
+// Encloses the spectrum by the extreme Ritz values of a Lanczos run widened
+// by their residual norms.
+template <typename Scalar>
+Bounds<Scalar> estimate_bounds(const Operator<Scalar>& apply, int size,
+                               int steps = 30, Scalar precision = 1e-12,
+                               std::uint64_t seed = 0) {
+  using Algorithm = schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  assert(size >= 1);
+  Scalar last_beta;
+  tridiagonal_symmetric::TridiagonalSymmetric<Scalar> diagonals = run_lanczos(
+      apply, make_probe<Scalar>(size, seed), std::min(steps, size),
+      &last_beta);
+  int length = diagonals.get_size();
+  DynamicVector<Scalar> ritz_values;
+  typename Algorithm::DynamicMatrix vectors;
+  Algorithm(precision).run_tridiagonal(diagonals, &ritz_values, &vectors);
+  Bounds<Scalar> bounds{ritz_values(0), ritz_values(0)};
+  for (int index = 0; index < length; ++index) {
+    Scalar residual = last_beta * std::abs(vectors(length - 1, index));
+    bounds.lower = std::min(bounds.lower, ritz_values(index) - residual);
+    bounds.upper = std::max(bounds.upper, ritz_values(index) + residual);
+  }
+  return bounds;
+}
+
+// Kernel polynomial method: the Chebyshev moments tr T_k(B) / n of the
+// operator B mapped onto [-1, 1] are estimated by probe averages, damped by
+// the Jackson kernel and integrated exactly over every bin.
+template <typename Scalar>
+class KernelPolynomialMethod {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using DynamicVector = spectral_density::DynamicVector<Scalar>;
+  using Operator = spectral_density::Operator<Scalar>;
+  using Bounds = spectral_density::Bounds<Scalar>;
+  using Histogram = spectral_density::Histogram<Scalar>;
+
+  KernelPolynomialMethod(int moments, int probes,
+                         int number_of_threads = default_number_of_threads(),
+                         std::uint64_t seed = 0)
+      : moments_(moments),
+        probes_(probes),
+        number_of_threads_(number_of_threads),
+        seed_(seed) {
+    assert(moments >= 2);
+    assert(probes >= 1);
+  }
+
+  // bounds must enclose the spectrum, see estimate_bounds().
+  void run(const Operator& apply, int size, Bounds bounds,
+           Histogram* histogram) {
+    assert(histogram);
+    assert(bounds.lower < bounds.upper);
+    trace_recorder::TraceSpan span("kernel polynomial method",
+                                   "spectral_density", size);
+    center_ = (bounds.upper + bounds.lower) / 2;
+    radius_ = (bounds.upper - bounds.lower) / 2 * (1 + margin);
+    std::vector<DynamicVector> probe_moments(probes_);
+    for_each_probe(probes_, number_of_threads_, [&](int probe) {
+      probe_moments[probe] =
+          find_probe_moments(apply, make_probe<Scalar>(size, seed_ + probe));
+    });
+    DynamicVector moments = DynamicVector::Zero(moments_);
+    for (const DynamicVector& probe_moment : probe_moments) {
+      moments += probe_moment;
+    }
+    moments /= Scalar(probes_) * size;
+    apply_jackson_kernel(&moments);
+    fill_histogram(moments, size, histogram);
+  }
+
+ private:
+  static constexpr const Scalar margin = 0.01;
+
+  // r^T T_k(B) r for k < moments_, two moments per product by means of
+  // T_{2k} = 2 T_k^2 - T_0 and T_{2k+1} = 2 T_{k+1} T_k - T_1.
+  DynamicVector find_probe_moments(const Operator& apply,
+                                   const DynamicVector& probe) const {
+    DynamicVector moments(moments_);
+    DynamicVector previous = probe;
+    DynamicVector current(probe.rows());
+    DynamicVector next(probe.rows());
+    apply_scaled(apply, previous, &current);
+    moments(0) = previous.squaredNorm();
+    moments(1) = previous.dot(current);
+    for (int k = 1; 2 * k < moments_; ++k) {
+      moments(2 * k) = 2 * current.squaredNorm() - moments(0);
+      if (2 * k + 1 == moments_) {
+        break;
+      }
+      apply_scaled(apply, current, &next);
+      next = 2 * next - previous;
+      moments(2 * k + 1) = 2 * next.dot(current) - moments(1);
+      previous.swap(current);
+      current.swap(next);
+    }
+    return moments;
+  }
+
+  void apply_scaled(const Operator& apply, const DynamicVector& input,
+                    DynamicVector* output) const {
+    apply(input, output);
+    *output -= center_ * input;
+    *output /= radius_;
+  }
+
+  void apply_jackson_kernel(DynamicVector* moments) const {
+    Scalar angle = std::acos(Scalar(-1)) / (moments_ + 1);
+    for (int k = 0; k < moments_; ++k) {
+      (*moments)(k) *= ((moments_ - k + 1) * std::cos(angle * k) +
+                        std::sin(angle * k) / std::tan(angle)) /
+                       (moments_ + 1);
+    }
+  }
+
+  // With x = cos(theta) the density sum_k c_k mu_k T_k(x) / (pi sqrt(1 - x^2))
+  // integrates to sum_k c_k mu_k sin(k theta) / (k pi) in closed form.
+  void fill_histogram(const DynamicVector& moments, int size,
+                      Histogram* histogram) const {
+    Scalar pi = std::acos(Scalar(-1));
+    auto primitive = [&](Scalar value) {
+      Scalar x = std::clamp((value - center_) / radius_, Scalar(-1),
+                            Scalar(1));
+      Scalar theta = std::acos(x);
+      Scalar sum = moments(0) * theta;
+      for (int k = 1; k < moments_; ++k) {
+        sum += 2 * moments(k) * std::sin(k * theta) / k;
+      }
+      return sum / pi;
+    };
+    Scalar left = primitive(histogram->lower);
+    for (int bin = 0; bin < histogram->get_bins(); ++bin) {
+      Scalar right = primitive(histogram->get_edge(bin + 1));
+      histogram->counts(bin) = (left - right) * size;
+      left = right;
+    }
+  }
+
+  int moments_;
+  int probes_;
+  int number_of_threads_;
+  std::uint64_t seed_;
+  Scalar center_;
+  Scalar radius_;
+};
+
+// Stochastic Lanczos quadrature: for every probe, the eigenvalues of the
+// Lanczos tridiagonal and the squared first components of its eigenvectors
+// are the nodes and weights of a Gauss quadrature of the spectral measure.
+template <typename Scalar>
+class StochasticLanczosQuadrature {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Algorithm = schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using DynamicMatrix = Algorithm::DynamicMatrix;
+  using DynamicVector = spectral_density::DynamicVector<Scalar>;
+  using Operator = spectral_density::Operator<Scalar>;
+  using Histogram = spectral_density::Histogram<Scalar>;
+  using Precision = Scalar;
+
+  struct Quadrature {
+    DynamicVector nodes;
+    DynamicVector weights;
+  };
+
+  StochasticLanczosQuadrature(
+      int steps, int probes, Precision precision = 1e-12,
+      int number_of_threads = default_number_of_threads(),
+      std::uint64_t seed = 0)
+      : steps_(steps),
+        probes_(probes),
+        precision_(precision),
+        number_of_threads_(number_of_threads),
+        seed_(seed) {
+    assert(steps >= 1);
+    assert(probes >= 1);
+    assert(precision >= 0);
+  }
+
+  // Nodes outside [histogram->lower, histogram->upper] are dropped.
+  void run(const Operator& apply, int size, Histogram* histogram) {
+    assert(histogram);
+    trace_recorder::TraceSpan span("stochastic lanczos quadrature",
+                                   "spectral_density", size);
+    std::vector<Quadrature> quadratures(probes_);
+    for_each_probe(probes_, number_of_threads_, [&](int probe) {
+      quadratures[probe] =
+          find_quadrature(apply, make_probe<Scalar>(size, seed_ + probe));
+    });
+    histogram->counts.setZero();
+    Scalar scale = Scalar(size) / probes_;
+    for (const Quadrature& quadrature : quadratures) {
+      for (int node = 0; node < quadrature.nodes.rows(); ++node) {
+        int bin = find_bin(*histogram, quadrature.nodes(node));
+        if (bin >= 0) {
+          histogram->counts(bin) += scale * quadrature.weights(node);
+        }
+      }
+    }
+  }
+
+  Quadrature find_quadrature(const Operator& apply,
+                             const DynamicVector& probe) const {
+    int steps = std::min<int>(steps_, probe.rows());
+    Quadrature quadrature;
+    DynamicMatrix vectors;
+    Algorithm(precision_).run_tridiagonal(run_lanczos(apply, probe, steps),
+                                          &quadrature.nodes, &vectors);
+    quadrature.weights = vectors.row(0).transpose().cwiseAbs2();
+    return quadrature;
+  }
+
+ private:
+  static int find_bin(const Histogram& histogram, Scalar value) {
+    if (value < histogram.lower || value > histogram.upper) {
+      return -1;
+    }
+    int bin = (value - histogram.lower) / histogram.get_bin_width();
+    return std::min(bin, histogram.get_bins() - 1);
+  }
+
+  int steps_;
+  int probes_;
+  Precision precision_;
+  int number_of_threads_;
+  std::uint64_t seed_;
+};
+
+}  // namespace spectral_density
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef _SCHUR_DECOMPOSITION_STREAMING_HESSENBERG_REDUCTION_H
+#define _SCHUR_DECOMPOSITION_STREAMING_HESSENBERG_REDUCTION_H
+
+#include <functional>
+#include <thread>
+
+#include "../eigen/Eigen/Dense"
+#include "bounded_queue.h"
+#include "hessenberg_reduction.h"
+#include "householder_reflection.h"
+#include "memory_policy.h"
+#include "trace_recorder.h"
+
+namespace streaming_hessenberg_reduction {
+
+// Hessenberg reduction of a matrix that arrives as panels of consecutive
+// columns, e.g. while it is read from a file or a pipe. A producer thread
+// pulls the panels from the source into a bounded queue and the calling
+// thread ingests them as they come.
+//
+// Only the first step of the reduction can run before the last column
+// arrives: its reflector P_0 depends on column 0 alone, while the right
+// update of P_0 mixes all columns, so every later reflector depends on the
+// whole matrix. Ingestion therefore copies each panel into place, applies
+// P_0 to it from the left and accumulates its contribution to (P_0 A) v_0;
+// the right update of P_0 is then a rank-1 update, and the remaining n - 3
+// steps run when the matrix is complete. The time of the load is hidden
+// behind the ingestion but not behind the O(n^3) steps that follow.
+template <typename Scalar,
+          class Allocator = memory_policy::DefaultAllocator<Scalar>>
+class StreamingHessenbergReduction {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using HessenbergReduction =
+      hessenberg_reduction::HessenbergReduction<Scalar, Allocator>;
+  using HouseholderReflector = HessenbergReduction::HouseholderReflector;
+  using DynamicMatrix = HessenbergReduction::DynamicMatrix;
+  using DynamicVector = HessenbergReduction::DynamicVector;
+  // Stores the next panel of size rows and at least one column and returns
+  // true, or returns false once all columns have been delivered.
+  using PanelSource = std::function<bool(DynamicMatrix* panel)>;
+
+  StreamingHessenbergReduction(int queue_capacity = 4,
+                               Allocator allocator = Allocator())
+      : queue_capacity_(queue_capacity), allocator_(std::move(allocator)) {
+    assert(queue_capacity >= 1);
+  }
+
+  // Same output as HessenbergReduction::run() on the assembled matrix.
+  // backtrace may be nullptr when the transform is not needed.
+  void run(int size, const PanelSource& source, DynamicMatrix* data,
+           DynamicMatrix* backtrace) {
+    assert(size >= 1);
+    assert(data);
+    trace_recorder::TraceSpan span("streaming hessenberg reduction",
+                                   "streaming_hessenberg_reduction", size);
+    allocator_.allocate(data, size, size);
+    p_data_ = data;
+    received_cols_ = 0;
+    bounded_queue::BoundedQueue<DynamicMatrix> queue(queue_capacity_);
+    std::thread producer([&]() { produce(source, &queue); });
+    DynamicMatrix panel;
+    while (queue.pop(&panel)) {
+      ingest(panel);
+    }
+    producer.join();
+    assert(received_cols_ == size);
+    finish_first_step(backtrace);
+    HessenbergReduction reduction(allocator_);
+    reduction.resume(1, data, backtrace);
+    p_data_ = nullptr;
+  }
+
+  int get_queue_capacity() const { return queue_capacity_; }
+
+ private:
+  void produce(const PanelSource& source,
+               bounded_queue::BoundedQueue<DynamicMatrix>* queue) {
+    DynamicMatrix panel;
+    while (source(&panel)) {
+      assert(panel.rows() == size() && panel.cols() >= 1);
+      queue->push(std::move(panel));
+    }
+    queue->close();
+  }
+
+  void ingest(const DynamicMatrix& panel) {
+    trace_recorder::TraceSpan span("panel ingestion",
+                                   "streaming_hessenberg_reduction",
+                                   panel.cols());
+    int first = received_cols_;
+    assert(first + panel.cols() <= size());
+    p_data_->middleCols(first, panel.cols()) = panel;
+    received_cols_ += panel.cols();
+    if (size() < 3) {
+      return;
+    }
+    if (first == 0) {
+      reflector_ = HouseholderReflector(p_data_->col(0).tail(size() - 1));
+      product_.setZero(size());
+    }
+    auto cols = p_data_->middleCols(first, panel.cols());
+    reflector_.reflect_left(p_data_->block(1, first, size() - 1,
+                                           panel.cols()));
+    const DynamicVector& direction = reflector_.direction();
+    for (int col = std::max(first, 1); col < received_cols_; ++col) {
+      product_ += cols.col(col - first) * direction(col - 1);
+    }
+  }
+
+  // (P_0 A) P_0 = P_0 A - 2 ((P_0 A) v_0) v_0^T on the columns 1, ...
+  void finish_first_step(DynamicMatrix* backtrace) {
+    if (backtrace) {
+      allocator_.allocate(backtrace, size(), size());
+      backtrace->setIdentity();
+    }
+    if (size() < 3) {
+      return;
+    }
+    const DynamicVector& direction = reflector_.direction();
+    p_data_->rightCols(size() - 1).noalias() -=
+        2 * product_ * direction.transpose();
+    if (backtrace) {
+      reflector_.reflect_right(backtrace->block(0, 1, size(), size() - 1));
+    }
+  }
+
+  int size() const { return p_data_->rows(); }
+
+  int queue_capacity_;
+  Allocator allocator_;
+  DynamicMatrix* p_data_ = nullptr;
+  int received_cols_ = 0;
+  HouseholderReflector reflector_;
+  DynamicVector product_;
+};
+
+}  // namespace streaming_hessenberg_reduction
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef _SCHUR_DECOMPOSITION_SYMMETRIC_DRIVER_H
+#define _SCHUR_DECOMPOSITION_SYMMETRIC_DRIVER_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "compact_eigenbasis.h"
+#include "hessenberg_reduction.h"
+#include "pipelined_tridiagonal_qr.h"
+#include "schur_decomposition_symmetric.h"
+#include "trace_recorder.h"
+#include "tridiagonal_symmetric.h"
+
+namespace symmetric_driver {
+
+enum class Engine {
+  // Cyclic Jacobi rotations on the dense matrix.
+  kJacobi,
+  // Tridiagonalization and Givens QR with a dense unitary, or none.
+  kImplicitQR,
+  // Tridiagonalization and Givens QR with the compact eigenbasis, applied
+  // to the requested columns only.
+  kCompactQR,
+  // Tridiagonalization and the multi-sweep QR on several threads.
+  kPipelinedQR,
+  // Tridiagonalization and Sturm sequence bisection of the requested
+  // eigenvalues.
+  kBisection,
+};
+
+inline const char* engine_name(Engine engine) {
+  switch (engine) {
+    case Engine::kJacobi:
+      return "jacobi";
+    case Engine::kImplicitQR:
+      return "implicit_qr";
+    case Engine::kCompactQR:
+      return "compact_qr";
+    case Engine::kPipelinedQR:
+      return "pipelined_qr";
+    case Engine::kBisection:
+      return "bisection";
+  }
+  return "unknown";
+}
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Where the driver switches engines. The defaults come from
+// benchmark_symmetric_driver on random matrices; rerun it to tune them for
+// another machine.
+struct Crossovers {
+  // Jacobi is used up to this size, where its sweeps are cheaper than the
+  // reduction, and for any matrix whose off-diagonal part is below
+  // jacobi_offdiagonal_ratio of its diagonal in Frobenius norm, where it
+  // converges in a few sweeps.
+  int jacobi_size_max = 10;
+  double jacobi_offdiagonal_ratio = 1e-2;
+  // Bisection is used for eigenvalues only when count is at most this part
+  // of the size.
+  double bisection_fraction = 0.25;
+  // The pipelined QR is used from this size on, given at least two
+  // threads. On one core it loses to the compact eigenbasis at all sizes
+  // up to 256, so this is a conservative bound for several cores.
+  int pipelined_size_min = 512;
+  // The compact eigenbasis is used when the number of eigenvectors is at
+  // most this part of the size. Applying it to all columns still beats the
+  // dense accumulation by about two times on one thread.
+  double compact_fraction = 1.;
+};
+
+// Eigenvalues and optionally eigenvectors of a symmetric matrix, for all of
+// them or the index range [first, first + count) of the eigenvalues sorted
+// increasingly, as in LAPACK's xSYEVR. choose_engine() picks the engine from
+// the size, the range and whether vectors are wanted; the engine of the last
+// run is available from get_last_engine() and names its trace span.
+template <typename Scalar>
+class SymmetricDriver {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using SymmetricAlgorithm =
+      schur_decomposition_symmetric::SchurDecomposition<Scalar>;
+  using PipelinedAlgorithm =
+      pipelined_tridiagonal_qr::PipelinedTridiagonalQR<Scalar>;
+  using CompactEigenbasis = SymmetricAlgorithm::CompactEigenbasis;
+  using TridiagonalSymmetric =
+      tridiagonal_symmetric::TridiagonalSymmetric<Scalar>;
+  using HessenbergReduction = hessenberg_reduction::HessenbergReduction<Scalar>;
+  using DynamicMatrix = SymmetricAlgorithm::DynamicMatrix;
+  using DynamicVector = SymmetricAlgorithm::DynamicVector;
+
+  // Sweeps in flight per batch of the pipelined QR.
+  static constexpr const int pipelined_sweeps = 4;
+
+  SymmetricDriver(Precision precision, Crossovers crossovers = Crossovers(),
+                  int number_of_threads = default_number_of_threads())
+      : precision_(precision),
+        crossovers_(crossovers),
+        number_of_threads_(number_of_threads) {
+    assert(precision >= 0);
+    assert(number_of_threads >= 1);
+  }
+
+  // count = -1 asks for the eigenvalues from first to the last one.
+  // eigenvectors receives the matching columns, or may be nullptr.
+  void run(const DynamicMatrix& data, DynamicVector* eigenvalues,
+           DynamicMatrix* eigenvectors, int first = 0, int count = -1) {
+    assert(data.rows() == data.cols());
+    assert(eigenvalues);
+    int size = data.rows();
+    if (count == -1) {
+      count = size - first;
+    }
+    assert(first >= 0 && count >= 0 && first + count <= size);
+    last_engine_ = choose_engine(data, count, eigenvectors);
+    trace_recorder::TraceSpan span(engine_name(last_engine_),
+                                   "symmetric_driver", size);
+    switch (last_engine_) {
+      case Engine::kJacobi:
+        run_jacobi(data, eigenvalues, eigenvectors, first, count);
+        return;
+      case Engine::kBisection:
+        run_bisection(data, eigenvalues, first, count);
+        return;
+      case Engine::kCompactQR:
+        run_compact_qr(data, eigenvalues, eigenvectors, first, count);
+        return;
+      case Engine::kImplicitQR:
+      case Engine::kPipelinedQR:
+        run_full_qr(data, eigenvalues, eigenvectors, first, count);
+        return;
+    }
+  }
+
+  Engine choose_engine(const DynamicMatrix& data, int count,
+                       bool vectors) const {
+    int size = data.rows();
+    if (size <= crossovers_.jacobi_size_max || is_nearly_diagonal(data)) {
+      return Engine::kJacobi;
+    }
+    if (!vectors && count <= crossovers_.bisection_fraction * size) {
+      return Engine::kBisection;
+    }
+    if (number_of_threads_ >= 2 && size >= crossovers_.pipelined_size_min) {
+      return Engine::kPipelinedQR;
+    }
+    if (vectors && count <= crossovers_.compact_fraction * size) {
+      return Engine::kCompactQR;
+    }
+    return Engine::kImplicitQR;
+  }
+
+  Engine get_last_engine() const { return last_engine_; }
+
+  const Crossovers& get_crossovers() const { return crossovers_; }
+
+  Precision get_precision() const { return precision_; }
+
+ private:
+  bool is_nearly_diagonal(const DynamicMatrix& data) const {
+    Scalar ratio = crossovers_.jacobi_offdiagonal_ratio;
+    return off_diagonal_norm(data) <=
+           ratio * ratio * data.diagonal().squaredNorm();
+  }
+
+  // Squared Frobenius norm of the part below the diagonal, summed directly
+  // since the difference of the full and diagonal norms would lose it.
+  static Scalar off_diagonal_norm(const DynamicMatrix& data) {
+    Scalar norm = 0;
+    for (int col = 0; col + 1 < data.cols(); ++col) {
+      norm += data.col(col).tail(data.rows() - col - 1).squaredNorm();
+    }
+    return norm;
+  }
+
+  // Cyclic Jacobi, sweeping until the off-diagonal part is negligible next
+  // to the matrix.
+  void run_jacobi(const DynamicMatrix& data, DynamicVector* eigenvalues,
+                  DynamicMatrix* eigenvectors, int first, int count) {
+    int size = data.rows();
+    DynamicMatrix work = data;
+    DynamicMatrix basis;
+    if (eigenvectors) {
+      basis.setIdentity(size, size);
+    }
+    Scalar relative =
+        std::max(precision_, std::numeric_limits<Scalar>::epsilon());
+    Scalar tolerance = relative * relative * work.squaredNorm();
+    while (off_diagonal_norm(work) > tolerance) {
+      for (int row = 0; row + 1 < size; ++row) {
+        for (int col = row + 1; col < size; ++col) {
+          rotate_jacobi(row, col, &work, eigenvectors ? &basis : nullptr);
+        }
+      }
+    }
+    DynamicVector all = work.diagonal();
+    select(all, eigenvectors ? &basis : nullptr, first, count, eigenvalues,
+           eigenvectors);
+  }
+
+  // Zeroes work(row, col) by the symmetric Schur rotation of the 2 x 2
+  // block on row and col.
+  static void rotate_jacobi(int row, int col, DynamicMatrix* work,
+                            DynamicMatrix* basis) {
+    Eigen::JacobiRotation<Scalar> rotation;
+    if (!rotation.makeJacobi(*work, row, col)) {
+      return;
+    }
+    work->applyOnTheLeft(row, col, rotation.adjoint());
+    work->applyOnTheRight(row, col, rotation);
+    (*work)(row, col) = (*work)(col, row) = 0;
+    if (basis) {
+      basis->applyOnTheRight(row, col, rotation);
+    }
+  }
+
+  void run_bisection(const DynamicMatrix& data, DynamicVector* eigenvalues,
+                     int first, int count) {
+    DynamicMatrix hessenberg_form = data;
+    HessenbergReduction().run(&hessenberg_form, nullptr);
+    TridiagonalSymmetric diagonals =
+        TridiagonalSymmetric::extract_diagonals(hessenberg_form);
+    const DynamicVector& major = diagonals.get_major_diagonal();
+    const DynamicVector& side = diagonals.get_side_diagonal();
+    Scalar lower = std::numeric_limits<Scalar>::max();
+    Scalar upper = std::numeric_limits<Scalar>::lowest();
+    for (int index = 0; index < major.rows(); ++index) {
+      Scalar radius = (index > 0 ? std::abs(side(index - 1)) : 0) +
+                      (index + 1 < major.rows() ? std::abs(side(index)) : 0);
+      lower = std::min(lower, major(index) - radius);
+      upper = std::max(upper, major(index) + radius);
+    }
+    Scalar tolerance =
+        std::max(precision_, std::numeric_limits<Scalar>::epsilon()) *
+        std::max(std::abs(lower), std::abs(upper));
+    eigenvalues->resize(count);
+    for (int index = 0; index < count; ++index) {
+      Scalar left = lower;
+      Scalar right = upper;
+      while (right - left > tolerance) {
+        Scalar middle = left + (right - left) / 2;
+        if (middle == left || middle == right) {
+          break;
+        }
+        if (count_below(major, side, middle) > first + index) {
+          right = middle;
+        } else {
+          left = middle;
+        }
+      }
+      (*eigenvalues)(index) = left + (right - left) / 2;
+    }
+  }
+
+  // Number of eigenvalues below shift, the number of negative pivots of
+  // the LDL^T factorization of T - shift I.
+  static int count_below(const DynamicVector& major, const DynamicVector& side,
+                         Scalar shift) {
+    Scalar safe_minimum = std::numeric_limits<Scalar>::min();
+    int negative = 0;
+    Scalar pivot = 1;
+    for (int index = 0; index < major.rows(); ++index) {
+      Scalar coupling = index > 0 ? side(index - 1) * side(index - 1) : 0;
+      pivot = major(index) - shift - coupling / pivot;
+      if (std::abs(pivot) < safe_minimum) {
+        pivot = -safe_minimum;
+      }
+      negative += pivot < 0;
+    }
+    return negative;
+  }
+
+  void run_compact_qr(const DynamicMatrix& data, DynamicVector* eigenvalues,
+                      DynamicMatrix* eigenvectors, int first, int count) {
+    DynamicVector all;
+    CompactEigenbasis basis;
+    SymmetricAlgorithm(precision_).run(data, &all, &basis);
+    std::vector<int> order = sort_increasingly(all);
+    eigenvalues->resize(count);
+    eigenvectors->setZero(data.rows(), count);
+    for (int index = 0; index < count; ++index) {
+      (*eigenvalues)(index) = all(order[first + index]);
+      (*eigenvectors)(order[first + index], index) = 1;
+    }
+    basis.apply(eigenvectors);
+  }
+
+  void run_full_qr(const DynamicMatrix& data, DynamicVector* eigenvalues,
+                   DynamicMatrix* eigenvectors, int first, int count) {
+    DynamicVector all;
+    DynamicMatrix basis;
+    DynamicMatrix* p_basis = eigenvectors ? &basis : nullptr;
+    if (last_engine_ == Engine::kPipelinedQR) {
+      PipelinedAlgorithm(precision_, pipelined_sweeps, number_of_threads_)
+          .run(data, &all, p_basis);
+    } else if (p_basis) {
+      SymmetricAlgorithm(precision_).run(data, &all, p_basis);
+    } else {
+      SymmetricAlgorithm(precision_).run(data, &all);
+    }
+    select(all, p_basis, first, count, eigenvalues, eigenvectors);
+  }
+
+  static std::vector<int> sort_increasingly(const DynamicVector& values) {
+    std::vector<int> order(values.rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int left, int right) {
+      return values(left) < values(right);
+    });
+    return order;
+  }
+
+  static void select(const DynamicVector& all, const DynamicMatrix* basis,
+                     int first, int count, DynamicVector* eigenvalues,
+                     DynamicMatrix* eigenvectors) {
+    std::vector<int> order = sort_increasingly(all);
+    eigenvalues->resize(count);
+    if (eigenvectors) {
+      eigenvectors->resize(all.rows(), count);
+    }
+    for (int index = 0; index < count; ++index) {
+      (*eigenvalues)(index) = all(order[first + index]);
+      if (eigenvectors) {
+        eigenvectors->col(index) = basis->col(order[first + index]);
+      }
+    }
+  }
+
+  Precision precision_;
+  Crossovers crossovers_;
+  int number_of_threads_;
+  Engine last_engine_ = Engine::kImplicitQR;
+};
+
+}  // namespace symmetric_driver
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef _SCHUR_DECOMPOSITION_TRACE_RECORDER_H
+#define _SCHUR_DECOMPOSITION_TRACE_RECORDER_H
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace trace_recorder {
+
+using Clock = std::chrono::steady_clock;
+
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  std::int64_t start_ns;
+  std::int64_t duration_ns;
+  int argument;
+};
+
+// Single writer ring buffer owned by one thread. Once full, the oldest events
+// are overwritten.
+class ThreadBuffer {
+ public:
+  static constexpr const std::size_t capacity = std::size_t(1) << 16;
+
+  ThreadBuffer(int thread_id) : thread_id_(thread_id), events_(capacity) {}
+
+  void push(const TraceEvent& event) {
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    events_[head % capacity] = event;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  template <class Visitor>
+  void for_each(Visitor visitor) const {
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    std::uint64_t first = head > capacity ? head - capacity : 0;
+    for (std::uint64_t index = first; index < head; ++index) {
+      visitor(events_[index % capacity]);
+    }
+  }
+
+  void clear() { head_.store(0, std::memory_order_release); }
+
+  int get_thread_id() const { return thread_id_; }
+
+ private:
+  int thread_id_;
+  std::vector<TraceEvent> events_;
+  std::atomic<std::uint64_t> head_ = 0;
+};
+
+// Process-wide recorder of task spans. Recording is off by default, so an
+// instrumented region costs one relaxed atomic load. Export and clear() must
+// not run concurrently with traced work.
+class TraceRecorder {
+ public:
+  static TraceRecorder& instance() {
+    static TraceRecorder recorder;
+    return recorder;
+  }
+
+  void enable() { enabled_.store(true, std::memory_order_relaxed); }
+  void disable() { enabled_.store(false, std::memory_order_relaxed); }
+  bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void record(const TraceEvent& event) { thread_buffer()->push(event); }
+
+  std::int64_t now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                origin_)
+        .count();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+      buffer->clear();
+    }
+  }
+
+  // Writes the recorded spans in the Chrome trace event format, which is
+  // also read by Perfetto.
+  void export_chrome_trace(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+      buffer->for_each([&](const TraceEvent& event) {
+        out << (first ? "\n" : ",\n");
+        write_event(out, event, buffer->get_thread_id());
+        first = false;
+      });
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+ private:
+  TraceRecorder() : origin_(Clock::now()) {}
+
+  ThreadBuffer* thread_buffer() {
+    static thread_local ThreadBuffer* buffer = register_thread();
+    return buffer;
+  }
+
+  ThreadBuffer* register_thread() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    int thread_id = static_cast<int>(buffers_.size());
+    buffers_.push_back(std::make_unique<ThreadBuffer>(thread_id));
+    return buffers_.back().get();
+  }
+
+  static void write_event(std::ostream& out, const TraceEvent& event,
+                          int thread_id) {
+    out << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+        << "\",\"ph\":\"X\",\"ts\":" << event.start_ns / 1000.
+        << ",\"dur\":" << event.duration_ns / 1000.
+        << ",\"pid\":1,\"tid\":" << thread_id
+        << ",\"args\":{\"size\":" << event.argument << "}}";
+  }
+
+  std::atomic<bool> enabled_ = false;
+  Clock::time_point origin_;
+  std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// Records the lifetime of a scope as one span. name and category must be
+// string literals (or otherwise outlive the recorder).
+class TraceSpan {
+ public:
+  TraceSpan(const char* name, const char* category, int argument = 0) {
+    TraceRecorder& recorder = TraceRecorder::instance();
+    if (recorder.is_enabled()) {
+      event_ = {name, category, recorder.now_ns(), 0, argument};
+      active_ = true;
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  ~TraceSpan() {
+    if (active_) {
+      TraceRecorder& recorder = TraceRecorder::instance();
+      event_.duration_ns = recorder.now_ns() - event_.start_ns;
+      recorder.record(event_);
+    }
+  }
+
+ private:
+  TraceEvent event_;
+  bool active_ = false;
+};
+
+}  // namespace trace_recorder
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef _SCHUR_DECOMPOSITION_TRANSFER_FUNCTION_H
+#define _SCHUR_DECOMPOSITION_TRANSFER_FUNCTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "hessenberg_reduction.h"
+#include "trace_recorder.h"
+
+namespace transfer_function {
+
+inline int default_number_of_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Transfer function G(s) = C (sI - A)^{-1} B of the system with state matrix
+// A (n x n), input matrix B (n x m) and output matrix C (p x n).
+//
+// A = Q H Q^T is reduced to upper Hessenberg form once, so that
+// G(s) = (C Q) (sI - H)^{-1} (Q^T B). Every shifted system is solved by the
+// QR factorization of sI - H with n - 1 complex Givens rotations, and the m
+// right-hand sides are rotated and back substituted as one block, in
+// O(n^2 m) per frequency instead of the O(n^3) of a dense LU. Batches of
+// frequencies are split over threads, each with its own work buffers.
+//
+// At an eigenvalue of A the shifted system is singular and the result is
+// not finite.
+template <typename Scalar>
+class TransferFunction {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using HessenbergReduction = hessenberg_reduction::HessenbergReduction<Scalar>;
+  using DynamicMatrix = HessenbergReduction::DynamicMatrix;
+  using Complex = std::complex<Scalar>;
+  using ComplexMatrix = Eigen::Matrix<Complex, -1, -1>;
+  using ComplexVector = Eigen::Matrix<Complex, -1, 1>;
+
+  TransferFunction(const DynamicMatrix& state, const DynamicMatrix& input,
+                   const DynamicMatrix& output,
+                   int number_of_threads = default_number_of_threads())
+      : hessenberg_form_(state), number_of_threads_(number_of_threads) {
+    assert(state.rows() == state.cols());
+    assert(input.rows() == state.rows());
+    assert(output.cols() == state.rows());
+    assert(number_of_threads >= 1);
+    trace_recorder::TraceSpan span("transfer function setup",
+                                   "transfer_function", state.rows());
+    HessenbergReduction reduction;
+    reduction.run(&hessenberg_form_, &unitary_);
+    projected_input_.noalias() = unitary_.transpose() * input;
+    projected_output_.noalias() = output * unitary_;
+  }
+
+  // Solves (shift I - A) solution = rhs.
+  void solve(Complex shift, const ComplexMatrix& rhs,
+             ComplexMatrix* solution) const {
+    assert(solution);
+    assert(rhs.rows() == size());
+    RowMajorMatrix factor;
+    RowMajorMatrix block = unitary_.transpose().template cast<Complex>() * rhs;
+    solve_hessenberg(shift, &factor, &block);
+    solution->noalias() = unitary_.template cast<Complex>() * block;
+  }
+
+  // response receives the p x m matrix G(frequency).
+  void evaluate(Complex frequency, ComplexMatrix* response) const {
+    assert(response);
+    RowMajorMatrix factor;
+    RowMajorMatrix block;
+    evaluate(frequency, &factor, &block, response);
+  }
+
+  // responses receives G(frequencies(k)) for every k.
+  void evaluate(const ComplexVector& frequencies,
+                std::vector<ComplexMatrix>* responses) const {
+    assert(responses);
+    trace_recorder::TraceSpan span("transfer function batch",
+                                   "transfer_function", frequencies.size());
+    int count = frequencies.size();
+    responses->resize(count);
+    for_each_thread(std::min(number_of_threads_, std::max(count, 1)),
+                    [&](int thread, int threads) {
+                      RowMajorMatrix factor;
+                      RowMajorMatrix block;
+                      int begin = count * thread / threads;
+                      int end = count * (thread + 1) / threads;
+                      for (int index = begin; index < end; ++index) {
+                        evaluate(frequencies(index), &factor, &block,
+                                 &(*responses)[index]);
+                      }
+                    });
+  }
+
+  const DynamicMatrix& get_hessenberg_form() const { return hessenberg_form_; }
+
+  const DynamicMatrix& get_unitary() const { return unitary_; }
+
+  int get_number_of_threads() const { return number_of_threads_; }
+
+ private:
+  // Row-major storage keeps the two rows of a rotation contiguous.
+  using RowMajorMatrix = Eigen::Matrix<Complex, -1, -1, Eigen::RowMajor>;
+
+  void evaluate(Complex frequency, RowMajorMatrix* factor,
+                RowMajorMatrix* block, ComplexMatrix* response) const {
+    *block = projected_input_.template cast<Complex>();
+    solve_hessenberg(frequency, factor, block);
+    response->noalias() = projected_output_.template cast<Complex>() * *block;
+  }
+
+  // block = (shift I - H)^{-1} block, factor is work space.
+  void solve_hessenberg(Complex shift, RowMajorMatrix* factor,
+                        RowMajorMatrix* block) const {
+    *factor = -hessenberg_form_.template cast<Complex>();
+    factor->diagonal().array() += shift;
+    for (int row = 0; row + 1 < size(); ++row) {
+      eliminate_subdiagonal(row, factor, block);
+    }
+    factor->template triangularView<Eigen::Upper>().solveInPlace(*block);
+  }
+
+  // Rotation [c s; -conj(s) c] of the rows row and row + 1 with real c that
+  // zeros factor(row + 1, row), as LAPACK's zlartg.
+  static void eliminate_subdiagonal(int row, RowMajorMatrix* factor,
+                                    RowMajorMatrix* block) {
+    Complex first = (*factor)(row, row);
+    Complex second = (*factor)(row + 1, row);
+    if (second == Complex(0)) {
+      return;
+    }
+    Scalar modulus = std::hypot(std::abs(first), std::abs(second));
+    Scalar cos = std::abs(first) / modulus;
+    Complex phase = first == Complex(0) ? Complex(1)
+                                        : first / std::abs(first);
+    Complex sin = phase * std::conj(second) / modulus;
+    rotate_rows(cos, sin, row, row, factor);
+    (*factor)(row + 1, row) = 0;
+    rotate_rows(cos, sin, row, 0, block);
+  }
+
+  static void rotate_rows(Scalar cos, Complex sin, int row, int first_col,
+                          RowMajorMatrix* data) {
+    Complex* upper = &(*data)(row, 0);
+    Complex* lower = &(*data)(row + 1, 0);
+    for (int col = first_col; col < data->cols(); ++col) {
+      Complex x = upper[col];
+      Complex y = lower[col];
+      upper[col] = cos * x + sin * y;
+      lower[col] = cos * y - std::conj(sin) * x;
+    }
+  }
+
+  template <class Work>
+  static void for_each_thread(int threads, const Work& work) {
+    if (threads <= 1) {
+      work(0, 1);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int thread = 0; thread < threads; ++thread) {
+      workers.emplace_back([&, thread]() { work(thread, threads); });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  int size() const { return hessenberg_form_.rows(); }
+
+  DynamicMatrix hessenberg_form_;
+  DynamicMatrix unitary_;
+  DynamicMatrix projected_input_;
+  DynamicMatrix projected_output_;
+  int number_of_threads_;
+};
+
+}  // namespace transfer_function
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef _SCHUR_DECOMPOSITION_TRIDIAGONAL_NONSYMMETRIC_H
+#define _SCHUR_DECOMPOSITION_TRIDIAGONAL_NONSYMMETRIC_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "trace_recorder.h"
+
+namespace tridiagonal_nonsymmetric {
+
+template <class Scalar>
+class TridiagonalNonsymmetric {
+ public:
+  using DynamicMatrix = Eigen::Matrix<Scalar, -1, -1>;
+  using DynamicVector = Eigen::Matrix<Scalar, -1, 1>;
+
+  TridiagonalNonsymmetric() = default;
+
+  TridiagonalNonsymmetric(int size)
+      : major_diagonal_(DynamicVector(size)),
+        upper_diagonal_(DynamicVector(size - 1)),
+        lower_diagonal_(DynamicVector(size - 1)) {
+    assert(size >= 1);
+  }
+
+  DynamicVector& get_major_diagonal() { return major_diagonal_; }
+
+  const DynamicVector& get_major_diagonal() const { return major_diagonal_; }
+
+  DynamicVector& get_upper_diagonal() { return upper_diagonal_; }
+
+  const DynamicVector& get_upper_diagonal() const { return upper_diagonal_; }
+
+  DynamicVector& get_lower_diagonal() { return lower_diagonal_; }
+
+  const DynamicVector& get_lower_diagonal() const { return lower_diagonal_; }
+
+  void set_diagonals(DynamicVector new_major, DynamicVector new_upper,
+                     DynamicVector new_lower) {
+    assert(new_major.rows() == new_upper.rows() + 1);
+    assert(new_upper.rows() == new_lower.rows());
+    major_diagonal_ = std::move(new_major);
+    upper_diagonal_ = std::move(new_upper);
+    lower_diagonal_ = std::move(new_lower);
+  }
+
+  static TridiagonalNonsymmetric extract_diagonals(const DynamicMatrix& data) {
+    TridiagonalNonsymmetric tmp;
+    tmp.set_diagonals(data.diagonal(0), data.diagonal(1), data.diagonal(-1));
+    return tmp;
+  }
+
+  DynamicMatrix to_dense() const {
+    DynamicMatrix dense = DynamicMatrix::Zero(get_size(), get_size());
+    dense.diagonal(0) = major_diagonal_;
+    dense.diagonal(1) = upper_diagonal_;
+    dense.diagonal(-1) = lower_diagonal_;
+    return dense;
+  }
+
+  int get_size() const {
+    assert(major_diagonal_.rows() == upper_diagonal_.rows() + 1);
+    return major_diagonal_.rows();
+  }
+
+ private:
+  DynamicVector major_diagonal_;
+  DynamicVector upper_diagonal_;
+  DynamicVector lower_diagonal_;
+};
+
+// All eigenvalues of a real nonsymmetric tridiagonal matrix T in O(n^2) time
+// and O(n) memory, by the Ehrlich-Aberth iteration of Bini, Gemignani and
+// Tisseur on det(z - T).
+//
+// det(z - T) depends on the side diagonals only through the products
+// d_k = T(k, k + 1) T(k + 1, k), and its leading minors p_k follow the
+// three-term recurrence p_{k+1} = (z - a_k) p_k - d_{k-1} p_{k-1}. The
+// Newton correction p_n / p_n' is computed from the ratios p_k / p_{k-1},
+// which neither overflow nor underflow, in O(n) per eigenvalue; the Aberth
+// correction couples the n approximations in another O(n), and complex
+// eigenvalues need no special treatment. T first splits at every negligible
+// d_k. The iteration converges cubically to simple eigenvalues; a multiple
+// or badly conditioned eigenvalue limits its accuracy, as for any backward
+// stable method.
+template <typename Scalar>
+class AberthSolver {
+  static_assert(std::is_arithmetic_v<Scalar>,
+                "Scalar must be arithmetic type!");
+
+ public:
+  using Precision = Scalar;
+  using TridiagonalNonsymmetric =
+      tridiagonal_nonsymmetric::TridiagonalNonsymmetric<Scalar>;
+  using DynamicVector = TridiagonalNonsymmetric::DynamicVector;
+  using Complex = std::complex<Scalar>;
+  using ComplexVector = Eigen::Matrix<Complex, -1, 1>;
+
+  AberthSolver(Precision precision, int max_iterations = 200)
+      : precision_(precision), max_iterations_(max_iterations) {
+    assert(precision > 0);
+    assert(max_iterations >= 1);
+  }
+
+  // eigenvalues receives the eigenvalues of the blocks of T in order, those
+  // of a block in no particular order. An eigenvalue whose imaginary part is
+  // within the precision of the norm of its block is returned as real.
+  void run(const TridiagonalNonsymmetric& data, ComplexVector* eigenvalues) {
+    assert(eigenvalues);
+    int size = data.get_size();
+    trace_recorder::TraceSpan span("aberth iteration",
+                                   "tridiagonal_nonsymmetric", size);
+    p_major_ = &data.get_major_diagonal();
+    products_ = data.get_upper_diagonal().cwiseProduct(
+        data.get_lower_diagonal());
+    eigenvalues->resize(size);
+    p_eigenvalues_ = eigenvalues;
+    iterations_ = 0;
+    is_converged_ = true;
+    int first = 0;
+    for (int index = 1; index <= size; ++index) {
+      if (index == size || is_negligible(index - 1)) {
+        solve_block(first, index - first);
+        first = index;
+      }
+    }
+    p_major_ = nullptr;
+    p_eigenvalues_ = nullptr;
+  }
+
+  // Largest number of sweeps over the approximations taken by a block in the
+  // last run().
+  int get_iterations() const { return iterations_; }
+
+  // False when a block of the last run() stopped at max_iterations.
+  bool is_converged() const { return is_converged_; }
+
+ private:
+  // d_k is negligible next to the diagonal, as the side diagonal entries
+  // sqrt(|d_k|) of the balanced matrix would be in NeighbourDeflation.
+  bool is_negligible(int index) const {
+    Scalar scale = std::abs(major(index)) + std::abs(major(index + 1));
+    return std::abs(products_(index)) <= precision_ * precision_ * scale *
+                                             scale;
+  }
+
+  void solve_block(int first, int length) {
+    if (length == 1) {
+      eigenvalue(first) = major(first);
+      return;
+    }
+    if (length == 2) {
+      Scalar half_trace = (major(first) + major(first + 1)) / 2;
+      Scalar half_gap = (major(first) - major(first + 1)) / 2;
+      Complex root =
+          std::sqrt(Complex(half_gap * half_gap + products_(first)));
+      eigenvalue(first) = half_trace + root;
+      eigenvalue(first + 1) = half_trace - root;
+      return;
+    }
+    // The eigenvalues of the two halves, with the coupling d_k between them
+    // dropped, are close to those of the block: a rank-one change moves
+    // them little, so a few sweeps refine them.
+    int half = length / 2;
+    solve_block(first, half);
+    solve_block(first + half, length - half);
+    Scalar scale = std::max(balanced_norm(first, length),
+                            std::numeric_limits<Scalar>::min());
+    // The halves are moved apart by a small offset: equal halves give equal
+    // starting points, which the Aberth correction cannot separate, and an
+    // eigenvalue of a 1 x 1 half zeroes a ratio of the recurrence.
+    Scalar offset = std::sqrt(precision_) * scale;
+    for (int index = first; index < first + length; ++index) {
+      eigenvalue(index) += std::polar(
+          offset, index < first + half ? offset_angle : -offset_angle);
+    }
+    std::vector<bool> converged(length, false);
+    std::vector<Scalar> last_steps(length, std::numeric_limits<Scalar>::max());
+    Scalar noise_level = std::sqrt(precision_) * scale;
+    int remaining = length;
+    int iteration = 0;
+    for (; remaining > 0 && iteration < max_iterations_; ++iteration) {
+      for (int index = 0; index < length; ++index) {
+        if (converged[index]) {
+          continue;
+        }
+        Complex correction = aberth_step(first, length, index, scale);
+        eigenvalue(first + index) -= correction;
+        Scalar step = std::abs(correction);
+        // A small step that no longer shrinks is rounding noise: the point
+        // is as accurate as the evaluation of p allows.
+        if (step <= precision_ * scale ||
+            (step <= noise_level && step >= last_steps[index])) {
+          converged[index] = true;
+          --remaining;
+        }
+        last_steps[index] = step;
+      }
+    }
+    iterations_ = std::max(iterations_, iteration);
+    is_converged_ = is_converged_ && remaining == 0;
+    for (int index = first; index < first + length; ++index) {
+      if (std::abs(eigenvalue(index).imag()) <= precision_ * scale) {
+        eigenvalue(index).imag(0);
+      }
+    }
+  }
+
+  // Infinity norm of the balanced block, whose side diagonal entries are
+  // both sqrt(|d_k|); it bounds the eigenvalues of the block.
+  Scalar balanced_norm(int first, int length) const {
+    Scalar norm = 0;
+    for (int index = first; index < first + length; ++index) {
+      Scalar row = std::abs(major(index));
+      if (index > first) {
+        row += std::sqrt(std::abs(products_(index - 1)));
+      }
+      if (index + 1 < first + length) {
+        row += std::sqrt(std::abs(products_(index)));
+      }
+      norm = std::max(norm, row);
+    }
+    return norm;
+  }
+
+  // z_i - z_i' = N / (1 - N sum_{j != i} 1 / (z_i - z_j)) for the Newton
+  // correction N = p(z_i) / p'(z_i), with the newest approximations z_j.
+  Complex aberth_step(int first, int length, int index, Scalar scale) const {
+    Complex point = eigenvalue(first + index);
+    Complex log_derivative = logarithmic_derivative(first, length, point,
+                                                    scale);
+    if (log_derivative == Complex(0)) {
+      // p' vanishes at the point; any small move leaves it.
+      return precision_ * scale;
+    }
+    Complex newton = Scalar(1) / log_derivative;
+    Complex repulsion = 0;
+    for (int other = 0; other < length; ++other) {
+      if (other != index) {
+        repulsion += Scalar(1) / (point - eigenvalue(first + other));
+      }
+    }
+    return newton / (Scalar(1) - newton * repulsion);
+  }
+
+  // p'(z) / p(z) = sum_k r_k' / r_k for the ratios r_k = p_k / p_{k-1}, with
+  // r_{k+1} = z - a_k - d_{k-1} / r_k and r_{k+1}' = 1 + d_{k-1} r_k' / r_k^2.
+  // A zero ratio is moved off zero by the precision, as in a Sturm count.
+  Complex logarithmic_derivative(int first, int length, Complex point,
+                                 Scalar scale) const {
+    Complex ratio = point - major(first);
+    Complex ratio_derivative = 1;
+    Scalar safe_ratio = precision_ * scale;
+    if (ratio == Complex(0)) {
+      ratio = safe_ratio;
+    }
+    Complex sum = ratio_derivative / ratio;
+    for (int index = first + 1; index < first + length; ++index) {
+      Complex quotient = products_(index - 1) / ratio;
+      ratio_derivative = Scalar(1) + quotient * ratio_derivative / ratio;
+      ratio = point - major(index) - quotient;
+      if (ratio == Complex(0)) {
+        ratio = safe_ratio;
+      }
+      sum += ratio_derivative / ratio;
+    }
+    return sum;
+  }
+
+  Scalar major(int index) const { return (*p_major_)(index); }
+
+  Complex& eigenvalue(int index) { return (*p_eigenvalues_)(index); }
+
+  const Complex& eigenvalue(int index) const {
+    return (*p_eigenvalues_)(index);
+  }
+
+  static constexpr const Scalar offset_angle = 0.4;
+
+  Precision precision_;
+  int max_iterations_;
+  const DynamicVector* p_major_ = nullptr;
+  DynamicVector products_;
+  ComplexVector* p_eigenvalues_ = nullptr;
+  int iterations_ = 0;
+  bool is_converged_ = true;
+};
+
+}  // namespace tridiagonal_nonsymmetric
+
+#endif
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/batch_executor.h"
+
+namespace test_batch_executor {
+
+using std::cout;
+using std::max;
+using BatchExecutor = batch_executor::BatchExecutor<double>;
+using CostModel = BatchExecutor::CostModel;
+using Estimate = BatchExecutor::Estimate;
+using Result = BatchExecutor::Result;
+using Solver = BatchExecutor::Solver;
+using Variant = BatchExecutor::Variant;
+using DynamicMatrix = BatchExecutor::DynamicMatrix;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 10;
+constexpr const int jobs_max = 12;
+constexpr const int matrix_size_max = 60;
+constexpr const int number_of_threads = 4;
+constexpr const Solver solvers[] = {Solver::kSchurDecomposition,
+                                    Solver::kSymmetricSchurDecomposition,
+                                    Solver::kHessenbergReduction};
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int job) {
+  cout << "test failed in BatchExecutor (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "job:\t" << job << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+// The estimates grow with the size and the unitary, and the peak memory is
+// the prediction of memory_budget.
+bool cost_model_check() {
+  CostModel model;
+  model.calibrate(input_precision, {16, 32}, 1);
+  for (Solver solver : solvers) {
+    for (bool unitary : {false, true}) {
+      if (!(model.get_flop_rate(solver, unitary) > 0)) {
+        process_check_failed("flop rate", 0, 0, int(solver));
+        return false;
+      }
+    }
+    Estimate previous;
+    for (int size = 1; size <= matrix_size_max; ++size) {
+      Estimate values = model.estimate(solver, size, Variant::kInPlace);
+      Estimate full = model.estimate(solver, size, Variant::kFull);
+      if (values.seconds <= previous.seconds ||
+          values.flops <= previous.flops ||
+          values.bytes_moved < values.flops ||
+          full.peak_bytes !=
+              memory_budget::predict_peak_bytes<double>(Variant::kFull,
+                                                        size) ||
+          full.peak_bytes <= values.peak_bytes) {
+        process_check_failed("estimate", values.seconds, 0, size);
+        return false;
+      }
+      previous = values;
+    }
+  }
+  return true;
+}
+
+bool result_check(const DynamicMatrix& data, Solver solver,
+                  bool need_unitary, const Result& result, int test_id,
+                  int job) {
+  int size = data.rows();
+  if (!need_unitary) {
+    bool is_empty = result.unitary.size() == 0;
+    bool has_output = solver == Solver::kSymmetricSchurDecomposition
+                          ? result.eigenvalues.rows() == size
+                          : result.schur_form.rows() == size;
+    if (!is_empty || !has_output) {
+      process_check_failed("output", 0, test_id, job);
+      return false;
+    }
+    return true;
+  }
+  DynamicMatrix form = result.schur_form;
+  if (solver == Solver::kSymmetricSchurDecomposition) {
+    form = result.eigenvalues.asDiagonal();
+  }
+  double scale = max(norm(data), 1.);
+  double delta = norm(result.unitary * form * result.unitary.transpose() -
+                      data) /
+                 scale;
+  if (delta > result_precision) {
+    process_check_failed("restore", delta, test_id, job);
+    return false;
+  }
+  return true;
+}
+
+bool batch_executor_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> job_counts(1, jobs_max);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::uniform_int_distribution<int> solver_indices(0, 2);
+  std::bernoulli_distribution unitaries;
+  BatchExecutor executor(input_precision, CostModel(), number_of_threads);
+  std::vector<DynamicMatrix> inputs;
+  std::vector<Solver> job_solvers;
+  std::vector<bool> need_unitaries;
+  int jobs = job_counts(*gen);
+  for (int job = 0; job < jobs; ++job) {
+    int size = sizes(*gen);
+    DynamicMatrix data = DynamicMatrix::Random(size, size);
+    Solver solver = solvers[solver_indices(*gen)];
+    if (solver == Solver::kSymmetricSchurDecomposition) {
+      data += data.transpose().eval();
+    }
+    bool need_unitary = unitaries(*gen);
+    inputs.push_back(data);
+    job_solvers.push_back(solver);
+    need_unitaries.push_back(need_unitary);
+    if (executor.submit(data, solver, need_unitary) != job) {
+      process_check_failed("index", 0, test_id, job);
+      return false;
+    }
+  }
+  double predicted = executor.predict_seconds();
+  executor.run();
+  const std::vector<int>& order = executor.get_order();
+  if (int(order.size()) != jobs || !(predicted > 0)) {
+    process_check_failed("order size", predicted, test_id, 0);
+    return false;
+  }
+  for (int position = 1; position < jobs; ++position) {
+    if (executor.get_result(order[position]).estimate.seconds >
+        executor.get_result(order[position - 1]).estimate.seconds) {
+      process_check_failed("largest first", 0, test_id, order[position]);
+      return false;
+    }
+  }
+  for (int job = 0; job < jobs; ++job) {
+    if (!result_check(inputs[job], job_solvers[job], need_unitaries[job],
+                      executor.get_result(job), test_id, job)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  if (!cost_model_check()) {
+    return;
+  }
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!batch_executor_check(test_id, &gen)) {
+      return;
+    }
+  }
+  cout << "Passed BatchExecutor stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max jobs: " << jobs_max << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_batch_executor
@@ -0,0 +1,3 @@
+namespace test_batch_executor {
+void run();
+}  // namespace test_batch_executor
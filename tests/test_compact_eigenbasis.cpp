@@ -0,0 +1,103 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+
+namespace test_compact_eigenbasis {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Algorithm = schur_decomposition_symmetric::SchurDecomposition<double>;
+using CompactEigenbasis = Algorithm::CompactEigenbasis;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 50;
+constexpr const int matrix_size_max = 100;
+constexpr const int block_cols = 3;
+
+void process_check_failed(const char* method, double delta, int test_id,
+                          int size) {
+  cout << "test failed in CompactEigenbasis::" << method
+       << "(), wrong result:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+bool run_test(int size, int test_id, std::size_t* compact_bytes,
+              std::size_t* dense_bytes) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += data.transpose().eval();
+  Algorithm algorithm(input_precision);
+  DynamicVector eigenvalues;
+  DynamicMatrix unitary;
+  algorithm.run(data, &eigenvalues, &unitary);
+  DynamicVector compact_eigenvalues;
+  CompactEigenbasis basis;
+  algorithm.run(data, &compact_eigenvalues, &basis);
+  double delta = (eigenvalues - compact_eigenvalues).cwiseAbs().maxCoeff();
+  if (delta > result_precision) {
+    process_check_failed("run", delta, test_id, size);
+    return false;
+  }
+  DynamicMatrix materialized;
+  basis.materialize(&materialized);
+  delta = norm(materialized - unitary);
+  if (delta > result_precision) {
+    process_check_failed("materialize", delta, test_id, size);
+    return false;
+  }
+  DynamicMatrix block = DynamicMatrix::Random(size, block_cols);
+  DynamicMatrix applied = block;
+  basis.apply(&applied);
+  delta = norm(applied - unitary * block);
+  if (delta > result_precision) {
+    process_check_failed("apply", delta, test_id, size);
+    return false;
+  }
+  applied = block;
+  basis.apply_transpose(&applied);
+  delta = norm(applied - unitary.transpose() * block);
+  if (delta > result_precision) {
+    process_check_failed("apply_transpose", delta, test_id, size);
+    return false;
+  }
+  *compact_bytes += basis.get_storage_bytes();
+  *dense_bytes += unitary.size() * sizeof(double);
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::size_t compact_bytes = 0;
+  std::size_t dense_bytes = 0;
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!run_test(sizes(gen), test_id, &compact_bytes, &dense_bytes)) return;
+  }
+  cout << "Passed compact eigenbasis stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Storage, compact / dense: " << compact_bytes << " / "
+       << dense_bytes << " bytes\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_compact_eigenbasis
@@ -0,0 +1,3 @@
+namespace test_compact_eigenbasis {
+void run();
+}  // namespace test_compact_eigenbasis
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/diagonal_plus_low_rank.h"
+
+namespace test_diagonal_plus_low_rank {
+
+using std::cout;
+using std::max;
+using DiagonalPlusLowRank = diagonal_plus_low_rank::DiagonalPlusLowRank<double>;
+using LowRankEigenbasis = DiagonalPlusLowRank::LowRankEigenbasis;
+using DynamicMatrix = DiagonalPlusLowRank::DynamicMatrix;
+using DynamicVector = DiagonalPlusLowRank::DynamicVector;
+
+enum class ProblemKind { kRandom, kRepeatedDiagonal, kSparseFactor };
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 200;
+constexpr const int matrix_size_max = 80;
+constexpr const int rank_max = 6;
+constexpr const ProblemKind problem_kinds[] = {
+    ProblemKind::kRandom, ProblemKind::kRepeatedDiagonal,
+    ProblemKind::kSparseFactor};
+
+void process_check_failed(const char* check, double delta, int size,
+                          int test_id) {
+  cout << "test failed in DiagonalPlusLowRank (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+// Repeated diagonal entries and factors with zero rows both exercise the
+// deflation.
+void generate_problem(ProblemKind kind, int size, int rank,
+                      DynamicVector* diagonal, DynamicMatrix* factor,
+                      std::mt19937* gen) {
+  *diagonal = DynamicVector::Random(size);
+  *factor = DynamicMatrix::Random(size, rank);
+  if (kind == ProblemKind::kRepeatedDiagonal) {
+    std::uniform_int_distribution<int> values(-2, 2);
+    for (int index = 0; index < size; ++index) {
+      (*diagonal)(index) = values(*gen);
+    }
+  } else if (kind == ProblemKind::kSparseFactor) {
+    std::bernoulli_distribution is_zero(0.5);
+    for (int index = 0; index < size; ++index) {
+      if (is_zero(*gen)) {
+        factor->row(index).setZero();
+      }
+    }
+  }
+}
+
+bool diagonal_plus_low_rank_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::uniform_int_distribution<int> ranks(0, rank_max);
+  int size = sizes(*gen);
+  int rank = ranks(*gen);
+  ProblemKind kind = problem_kinds[test_id % std::size(problem_kinds)];
+  DynamicVector diagonal;
+  DynamicMatrix factor;
+  generate_problem(kind, size, rank, &diagonal, &factor, gen);
+  DynamicMatrix data = diagonal.asDiagonal();
+  data += factor * factor.transpose();
+  DiagonalPlusLowRank algorithm(input_precision);
+  DynamicVector eigenvalues;
+  LowRankEigenbasis basis;
+  algorithm.run(diagonal, factor, &eigenvalues, &basis);
+  if (eigenvalues.rows() != size || !algorithm.is_converged()) {
+    process_check_failed("output", eigenvalues.rows(), size, test_id);
+    return false;
+  }
+  double scale = max(norm(data), 1.);
+  Eigen::SelfAdjointEigenSolver<DynamicMatrix> reference(
+      data, Eigen::EigenvaluesOnly);
+  double delta = norm(eigenvalues - reference.eigenvalues()) / scale;
+  if (delta > result_precision) {
+    process_check_failed("eigenvalues", delta, size, test_id);
+    return false;
+  }
+  DynamicMatrix eigenvectors;
+  basis.materialize(&eigenvectors);
+  delta = norm(eigenvectors.transpose() * eigenvectors -
+               DynamicMatrix::Identity(size, size));
+  if (delta > result_precision) {
+    process_check_failed("orthogonality", delta, size, test_id);
+    return false;
+  }
+  delta = norm(data * eigenvectors -
+               eigenvectors * eigenvalues.asDiagonal()) /
+          scale;
+  if (delta > result_precision) {
+    process_check_failed("residual", delta, size, test_id);
+    return false;
+  }
+  DynamicMatrix block = DynamicMatrix::Random(size, 3);
+  DynamicMatrix product = block;
+  basis.apply_transpose(&product);
+  delta = norm(product - eigenvectors.transpose() * block) /
+          max(norm(block), 1.);
+  if (delta > result_precision) {
+    process_check_failed("apply transpose", delta, size, test_id);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!diagonal_plus_low_rank_check(test_id, &gen)) {
+      return;
+    }
+  }
+  cout << "Passed DiagonalPlusLowRank stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max rank: " << rank_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_diagonal_plus_low_rank
@@ -0,0 +1,3 @@
+namespace test_diagonal_plus_low_rank {
+void run();
+}  // namespace test_diagonal_plus_low_rank
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/hamiltonian_schur_decomposition.h"
+
+namespace test_hamiltonian_schur_decomposition {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Hamiltonian =
+    hamiltonian_schur_decomposition::HamiltonianSchurDecomposition<double>;
+using DynamicMatrix = Hamiltonian::DynamicMatrix;
+using ComplexVector = Hamiltonian::ComplexVector;
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-10;
+// Eigenvalues of H are recovered from those of H^2, which halves their
+// relative accuracy near zero.
+constexpr const double squared_precision = 1e-6;
+constexpr const int number_of_tests = 50;
+constexpr const int half_size_max = 30;
+
+void process_eigenvalues_check_failed(const char* method, double delta,
+                                      int test_id, int size) {
+  cout << "test failed in HamiltonianSchurDecomposition::" << method
+       << "(), wrong eigenvalues:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_bad_restore(double delta, int test_id, int size) {
+  cout << "test failed in HamiltonianSchurDecomposition::"
+          "run_skew_hamiltonian(), wrong restore:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_not_symplectic(const DynamicMatrix& unitary, int test_id,
+                            int size) {
+  cout << "test failed in HamiltonianSchurDecomposition::"
+          "run_skew_hamiltonian(), unitary is not symplectic:\n\n";
+  cout << "unitary:\n" << unitary << "\n\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+// Largest distance from an eigenvalue of computed to the closest not yet used
+// eigenvalue of expected.
+double eigenvalues_distance(const ComplexVector& computed,
+                            const ComplexVector& expected) {
+  double delta = 0.;
+  std::vector<bool> is_used(expected.size(), false);
+  for (int i = 0; i < computed.size(); ++i) {
+    int closest = -1;
+    for (int j = 0; j < expected.size(); ++j) {
+      if (!is_used[j] && (closest < 0 || abs(expected(j) - computed(i)) <
+                                             abs(expected(closest) -
+                                                 computed(i)))) {
+        closest = j;
+      }
+    }
+    is_used[closest] = true;
+    delta = max(delta, abs(expected(closest) - computed(i)));
+  }
+  return delta;
+}
+
+// The spectra here are symmetric about the imaginary axis, on which the
+// double shift QR algorithm without exceptional shifts can stall, so the
+// reference comes from Eigen.
+ComplexVector find_eigenvalues(const DynamicMatrix& data) {
+  return Eigen::EigenSolver<DynamicMatrix>(data, false).eigenvalues();
+}
+
+DynamicMatrix make_symmetric(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  return data + data.transpose();
+}
+
+DynamicMatrix make_skew_symmetric(int size) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  return data - data.transpose();
+}
+
+bool is_symplectic(const DynamicMatrix& unitary) {
+  int half = unitary.rows() / 2;
+  DynamicMatrix identity = DynamicMatrix::Identity(2 * half, 2 * half);
+  return norm(unitary.transpose() * unitary - identity) < result_precision &&
+         norm(unitary.topLeftCorner(half, half) -
+              unitary.bottomRightCorner(half, half)) < result_precision &&
+         norm(unitary.topRightCorner(half, half) +
+              unitary.bottomLeftCorner(half, half)) < result_precision;
+}
+
+bool hamiltonian_check(int half, int test_id) {
+  DynamicMatrix hamiltonian(2 * half, 2 * half);
+  DynamicMatrix a = DynamicMatrix::Random(half, half);
+  hamiltonian << a, make_symmetric(half), make_symmetric(half),
+      -a.transpose();
+  Hamiltonian solver(input_precision);
+  ComplexVector eigenvalues;
+  solver.run(hamiltonian, &eigenvalues);
+  ComplexVector spectrum;
+  Hamiltonian::complete_spectrum(eigenvalues, &spectrum);
+  double delta = eigenvalues_distance(spectrum, find_eigenvalues(hamiltonian));
+  if (delta > squared_precision * max(1., norm(hamiltonian))) {
+    process_eigenvalues_check_failed("run", delta, test_id, 2 * half);
+    return false;
+  }
+  return true;
+}
+
+bool skew_hamiltonian_check(int half, int test_id) {
+  DynamicMatrix data(2 * half, 2 * half);
+  DynamicMatrix n = DynamicMatrix::Random(half, half);
+  data << n, make_skew_symmetric(half), make_skew_symmetric(half),
+      n.transpose();
+  Hamiltonian solver(input_precision);
+  ComplexVector eigenvalues;
+  DynamicMatrix unitary;
+  solver.run_skew_hamiltonian(data, &eigenvalues, &unitary);
+  if (!is_symplectic(unitary)) {
+    process_not_symplectic(unitary, test_id, 2 * half);
+    return false;
+  }
+  double delta = norm(data - unitary * solver.get_reduced_form() *
+                                 unitary.transpose());
+  if (delta > result_precision) {
+    process_bad_restore(delta, test_id, 2 * half);
+    return false;
+  }
+  ComplexVector doubled(2 * half);
+  doubled << eigenvalues, eigenvalues;
+  delta = eigenvalues_distance(doubled, find_eigenvalues(data));
+  // Every eigenvalue is double, which leaves it only half of its digits in
+  // the reference solver.
+  if (delta > squared_precision * max(1., norm(data))) {
+    process_eigenvalues_check_failed("run_skew_hamiltonian", delta, test_id,
+                                     2 * half);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, half_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!hamiltonian_check(sizes(gen), test_id)) return;
+    if (!skew_hamiltonian_check(sizes(gen), test_id)) return;
+  }
+  cout << "Passed Hamiltonian Schur decomposition stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << 2 * half_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n";
+  cout << "Precision of squared eigenvalues: " << squared_precision
+       << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_hamiltonian_schur_decomposition
@@ -0,0 +1,3 @@
+namespace test_hamiltonian_schur_decomposition {
+void run();
+}  // namespace test_hamiltonian_schur_decomposition
@@ -10,10 +10,13 @@ using std::cout;
 using std::max;
 using Algorithm = hessenberg_reduction::HessenbergReduction<double>;
 using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
 
 constexpr const long double result_precision = 1e-11;
 constexpr const int number_of_tests = 200;
 constexpr const int matrix_size_max = 200;
+constexpr const int number_of_update_tests = 20;
+constexpr const int update_size_max = 60;
 
 bool is_hessenberg_form(const DynamicMatrix& data, int size) {
   return data.block(1, 0, size - 1, size - 1)
@@ -88,6 +91,53 @@ bool simple_check(int size, int test_id) {
   return true;
 }
 
+bool update_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(1, 1);
+  DynamicMatrix hessenberg_form = data;
+  DynamicMatrix backtrace = DynamicMatrix::Identity(1, 1);
+  Algorithm reduction;
+  for (int cur_size = 1; cur_size < size; ++cur_size) {
+    DynamicVector column = DynamicVector::Random(cur_size);
+    DynamicVector row = DynamicVector::Random(cur_size);
+    double corner = DynamicVector::Random(1)(0);
+    reduction.update(column, row, corner, &hessenberg_form, &backtrace);
+
+    data.conservativeResize(cur_size + 1, cur_size + 1);
+    data.col(cur_size).head(cur_size) = column;
+    data.row(cur_size).head(cur_size) = row.transpose();
+    data(cur_size, cur_size) = corner;
+  }
+  if (!is_hessenberg_form(hessenberg_form, size)) {
+    process_hessenberg_check_failed(hessenberg_form, data, test_id, size);
+    return false;
+  }
+  if (!backtrace.isUnitary()) {
+    process_unitary_check_failed(data, backtrace, test_id, size);
+    return false;
+  }
+  DynamicMatrix restored_data =
+      backtrace * hessenberg_form * backtrace.transpose();
+  if (!are_indistinguishable(data, restored_data, size)) {
+    process_bad_restore(data, restored_data, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_update_testing() {
+  for (int size = 1; size <= update_size_max; ++size) {
+    for (int test_id = 1; test_id <= number_of_update_tests; ++test_id) {
+      srand(test_id);
+      if (!update_check(size, test_id)) return;
+    }
+  }
+
+  cout << "Passed HessenbergReduction::update() stress testing\n";
+  cout << "Number of tests: " << number_of_update_tests << "\n";
+  cout << "Maximum matrix size: " << update_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
 void run_stress_testing() {
   for (int size = 1; size <= matrix_size_max; ++size) {
     for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
@@ -102,6 +152,9 @@ void run_stress_testing() {
   cout << "Result precision: " << result_precision << "\n\n\n";
 }
 
-void run() { run_stress_testing(); }
+void run() {
+  run_stress_testing();
+  run_update_testing();
+}
 
 }  // namespace test_hessenberg_reduction
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/joint_diagonalization.h"
+
+namespace test_joint_diagonalization {
+
+using std::cout;
+using std::max;
+using JointDiagonalization =
+    joint_diagonalization::JointDiagonalization<double>;
+using DynamicMatrix = JointDiagonalization::DynamicMatrix;
+using DynamicVector = Eigen::Matrix<double, -1, 1>;
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-9;
+constexpr const double noise_level = 1e-3;
+constexpr const int number_of_tests = 100;
+constexpr const int matrix_size_max = 40;
+constexpr const int matrices_max = 30;
+constexpr const int number_of_threads = 4;
+
+void process_check_failed(const char* check, double delta, int size,
+                          int test_id) {
+  cout << "test failed in JointDiagonalization (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+DynamicMatrix random_orthogonal(int size) {
+  return DynamicMatrix::Random(size, size).householderQr().householderQ();
+}
+
+// Matrices V A_k V^T with a common orthogonal V and diagonal A_k, plus a
+// symmetric perturbation of the given level.
+std::vector<DynamicMatrix> generate_matrices(int size, int count,
+                                             double noise) {
+  DynamicMatrix common = random_orthogonal(size);
+  std::vector<DynamicMatrix> matrices;
+  for (int index = 0; index < count; ++index) {
+    DynamicVector diagonal = DynamicVector::Random(size);
+    DynamicMatrix perturbation = DynamicMatrix::Random(size, size);
+    matrices.push_back(common * diagonal.asDiagonal() * common.transpose() +
+                       noise * (perturbation + perturbation.transpose()));
+  }
+  return matrices;
+}
+
+bool result_check(const std::vector<DynamicMatrix>& inputs,
+                  const std::vector<DynamicMatrix>& outputs,
+                  const DynamicMatrix& basis, int test_id) {
+  int size = basis.rows();
+  double delta = norm(basis.transpose() * basis -
+                      DynamicMatrix::Identity(size, size));
+  if (delta > result_precision) {
+    process_check_failed("orthogonality", delta, size, test_id);
+    return false;
+  }
+  for (int index = 0; index < int(inputs.size()); ++index) {
+    double scale = max(norm(inputs[index]), 1.);
+    delta = norm(basis.transpose() * inputs[index] * basis - outputs[index]) /
+            scale;
+    if (delta > result_precision) {
+      process_check_failed("restore", delta, size, test_id);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool joint_diagonalization_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::uniform_int_distribution<int> counts(1, matrices_max);
+  int size = sizes(*gen);
+  int count = counts(*gen);
+  bool is_noisy = test_id % 4 == 0;
+  std::vector<DynamicMatrix> inputs =
+      generate_matrices(size, count, is_noisy ? noise_level : 0.);
+  std::vector<DynamicMatrix> outputs = inputs;
+  DynamicMatrix basis;
+  JointDiagonalization algorithm(input_precision, 100, number_of_threads);
+  algorithm.run(&outputs, &basis);
+  if (!result_check(inputs, outputs, basis, test_id)) {
+    return false;
+  }
+  // Each rotation maximizes the diagonal, so the off-diagonal part never
+  // grows; without noise it vanishes.
+  double before = JointDiagonalization::off_diagonal_norm(inputs);
+  double after = JointDiagonalization::off_diagonal_norm(outputs);
+  if (after > before * (1 + result_precision) + result_precision) {
+    process_check_failed("off-diagonal growth", after - before, size,
+                         test_id);
+    return false;
+  }
+  if (!is_noisy) {
+    double delta = std::sqrt(after) / max(std::sqrt(before), 1.);
+    if (delta > result_precision || !algorithm.is_converged()) {
+      process_check_failed("off-diagonal", delta, size, test_id);
+      return false;
+    }
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!joint_diagonalization_check(test_id, &gen)) {
+      return;
+    }
+  }
+  cout << "Passed JointDiagonalization stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max matrices: " << matrices_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_joint_diagonalization
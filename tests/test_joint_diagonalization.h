@@ -0,0 +1,3 @@
+namespace test_joint_diagonalization {
+void run();
+}  // namespace test_joint_diagonalization
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/kronecker_operator.h"
+
+namespace test_kronecker_operator {
+
+using std::abs;
+using std::cout;
+using std::max;
+using kronecker_operator::Structure;
+using KroneckerOperator = kronecker_operator::KroneckerOperator<double>;
+using DynamicMatrix = KroneckerOperator::DynamicMatrix;
+using DynamicVector = KroneckerOperator::DynamicVector;
+using ComplexVector = KroneckerOperator::ComplexVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-8;
+constexpr const int number_of_tests = 100;
+constexpr const int factors_max = 3;
+constexpr const int factor_size_max = 7;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int size) {
+  cout << "test failed in KroneckerOperator (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+DynamicMatrix kronecker(const DynamicMatrix& left,
+                        const DynamicMatrix& right) {
+  DynamicMatrix result(left.rows() * right.rows(), left.cols() * right.cols());
+  for (int row = 0; row < left.rows(); ++row) {
+    for (int col = 0; col < left.cols(); ++col) {
+      result.block(row * right.rows(), col * right.cols(), right.rows(),
+                   right.cols()) = left(row, col) * right;
+    }
+  }
+  return result;
+}
+
+DynamicMatrix materialize(Structure structure,
+                          const std::vector<DynamicMatrix>& factors) {
+  DynamicMatrix result = factors[0];
+  for (std::size_t index = 1; index < factors.size(); ++index) {
+    const DynamicMatrix& next = factors[index];
+    if (structure == Structure::kProduct) {
+      result = kronecker(result, next);
+    } else {
+      result = kronecker(result, DynamicMatrix::Identity(next.rows(),
+                                                         next.rows())) +
+               kronecker(DynamicMatrix::Identity(result.rows(),
+                                                 result.rows()),
+                         next);
+    }
+  }
+  return result;
+}
+
+// Largest distance from an eigenvalue of found to the closest not yet used
+// eigenvalue of expected.
+double eigenvalues_distance(const ComplexVector& found,
+                            const ComplexVector& expected) {
+  double delta = 0.;
+  std::vector<bool> is_used(expected.size(), false);
+  for (int i = 0; i < found.size(); ++i) {
+    int closest = -1;
+    for (int j = 0; j < expected.size(); ++j) {
+      if (!is_used[j] &&
+          (closest < 0 ||
+           abs(expected(j) - found(i)) < abs(expected(closest) - found(i)))) {
+        closest = j;
+      }
+    }
+    is_used[closest] = true;
+    delta = max(delta, abs(expected(closest) - found(i)));
+  }
+  return delta;
+}
+
+bool kronecker_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> counts(1, factors_max);
+  Structure structure =
+      test_id % 2 == 0 ? Structure::kProduct : Structure::kSum;
+  bool symmetric = test_id % 4 < 2;
+  // A 1 x 1 factor is symmetric.
+  std::uniform_int_distribution<int> sizes(symmetric ? 1 : 2,
+                                           factor_size_max);
+  std::vector<DynamicMatrix> factors(counts(*gen));
+  for (DynamicMatrix& factor : factors) {
+    int size = sizes(*gen);
+    factor = DynamicMatrix::Random(size, size);
+    if (symmetric) {
+      factor += factor.transpose().eval();
+    }
+  }
+  DynamicMatrix dense = materialize(structure, factors);
+  int size = dense.rows();
+  KroneckerOperator kronecker_operator(structure, factors, input_precision);
+  if (kronecker_operator.get_size() != size ||
+      kronecker_operator.is_symmetric() != symmetric) {
+    process_check_failed("shape", 0, test_id, size);
+    return false;
+  }
+  DynamicVector vector = DynamicVector::Random(size);
+  DynamicVector result;
+  kronecker_operator.apply(vector, &result);
+  double delta = (result - dense * vector).cwiseAbs().maxCoeff();
+  if (delta > result_precision) {
+    process_check_failed("apply", delta, test_id, size);
+    return false;
+  }
+  DynamicVector restored;
+  kronecker_operator.apply_basis(vector, &result);
+  kronecker_operator.apply_basis_transpose(result, &restored);
+  delta = (restored - vector).cwiseAbs().maxCoeff();
+  if (delta > result_precision) {
+    process_check_failed("orthogonal basis", delta, test_id, size);
+    return false;
+  }
+  const ComplexVector& eigenvalues = kronecker_operator.get_eigenvalues();
+  if (symmetric) {
+    for (int index = 0; index < size; ++index) {
+      DynamicVector column;
+      kronecker_operator.apply_basis(DynamicVector::Unit(size, index),
+                                     &column);
+      kronecker_operator.apply(column, &result);
+      delta = max(delta, (result - eigenvalues(index).real() * column)
+                             .cwiseAbs()
+                             .maxCoeff());
+    }
+  } else {
+    Eigen::EigenSolver<DynamicMatrix> solver(dense, false);
+    delta = eigenvalues_distance(eigenvalues, solver.eigenvalues());
+  }
+  if (delta > result_precision) {
+    process_check_failed("eigenvalues", delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!kronecker_check(test_id, &gen)) return;
+  }
+  cout << "Passed Kronecker operator stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max number of factors: " << factors_max << "\n";
+  cout << "Max factor size: " << factor_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_kronecker_operator
@@ -0,0 +1,3 @@
+namespace test_kronecker_operator {
+void run();
+}  // namespace test_kronecker_operator
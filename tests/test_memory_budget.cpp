@@ -0,0 +1,179 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/memory_budget.h"
+
+namespace test_memory_budget {
+
+using std::cout;
+using std::max;
+using memory_budget::MemoryReport;
+using memory_budget::Requirements;
+using memory_budget::Variant;
+using Algorithm = memory_budget::SchurDecomposition<double>;
+using SymmetricAlgorithm = memory_budget::SymmetricSchurDecomposition<double>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = SymmetricAlgorithm::DynamicVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-11;
+constexpr const double peak_tolerance = 0.05;
+constexpr const std::size_t allocator_cache_bytes = std::size_t(1) << 16;
+constexpr const int number_of_tests = 5;
+constexpr const int matrix_sizes[] = {64, 128, 256};
+
+void process_plan_check_failed(const MemoryReport& report, Variant expected,
+                               int size) {
+  cout << "test failed in memory_budget::plan():\n\n";
+  cout << "expected variant:\t" << memory_budget::variant_name(expected)
+       << "\n";
+  cout << "chosen variant:\t" << memory_budget::variant_name(report.variant)
+       << "\n";
+  cout << "budget:\t" << report.budget_bytes << "\n";
+  cout << "predicted peak:\t" << report.predicted_peak_bytes << "\n";
+  cout << "size:\t" << size << "\n";
+}
+
+void process_run_check_failed(const char* solver, const MemoryReport& report,
+                              double delta, int test_id, int size) {
+  cout << "test failed in memory_budget::" << solver << "::run():\n\n";
+  cout << "variant:\t" << memory_budget::variant_name(report.variant) << "\n";
+  cout << "predicted peak:\t" << report.predicted_peak_bytes << "\n";
+  cout << "actual peak:\t" << report.actual_peak_bytes << "\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+bool peak_is_predicted(const MemoryReport& report) {
+  double predicted = report.predicted_peak_bytes;
+  return report.actual_peak_bytes <=
+         predicted * (1 + peak_tolerance) + allocator_cache_bytes;
+}
+
+std::size_t predict(Variant variant, int size) {
+  return memory_budget::predict_peak_bytes<double>(variant, size);
+}
+
+bool plan_check(int size) {
+  Algorithm algorithm(input_precision, 0);
+  Requirements keep_input;
+  Requirements overwrite_input;
+  overwrite_input.may_overwrite_input = true;
+  Requirements eigenvalues_only;
+  eigenvalues_only.need_unitary = false;
+  eigenvalues_only.may_overwrite_input = true;
+
+  struct Case {
+    std::size_t budget;
+    Requirements requirements;
+    Variant expected;
+    bool fits;
+  } cases[] = {
+      {predict(Variant::kFull, size), keep_input, Variant::kFull, true},
+      {predict(Variant::kFull, size) - 1, keep_input, Variant::kFull, false},
+      {predict(Variant::kFull, size) - 1, overwrite_input, Variant::kInPlace,
+       true},
+      {predict(Variant::kEigenvaluesOnly, size), eigenvalues_only,
+       Variant::kEigenvaluesOnly, true},
+      {predict(Variant::kInPlaceEigenvaluesOnly, size), eigenvalues_only,
+       Variant::kInPlaceEigenvaluesOnly, true},
+  };
+  for (const Case& test_case : cases) {
+    algorithm.set_budget(test_case.budget);
+    MemoryReport report = algorithm.plan(size, test_case.requirements);
+    if (report.variant != test_case.expected ||
+        report.fits != test_case.fits) {
+      process_plan_check_failed(report, test_case.expected, size);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool nonsymmetric_check(int size, Variant variant, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  DynamicMatrix old_data = data;
+  Requirements requirements;
+  requirements.need_unitary =
+      variant == Variant::kFull || variant == Variant::kInPlace;
+  requirements.may_overwrite_input = variant != Variant::kFull &&
+                                     variant != Variant::kEigenvaluesOnly;
+  Algorithm algorithm(input_precision, predict(variant, size));
+  DynamicMatrix schur_form;
+  DynamicMatrix unitary;
+  MemoryReport report =
+      algorithm.run(&data, &schur_form, &unitary, requirements);
+  double delta = 0;
+  if (requirements.need_unitary) {
+    delta = norm(old_data - unitary * schur_form * unitary.transpose());
+  }
+  if (!report.fits || report.variant != variant || delta > result_precision ||
+      schur_form.rows() != size || !peak_is_predicted(report)) {
+    process_run_check_failed("SchurDecomposition", report, delta, test_id,
+                             size);
+    return false;
+  }
+  return true;
+}
+
+bool symmetric_check(int size, Variant variant, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += (DynamicMatrix)data.transpose();
+  DynamicMatrix old_data = data;
+  Requirements requirements;
+  requirements.need_unitary =
+      variant == Variant::kFull || variant == Variant::kInPlace;
+  requirements.may_overwrite_input = variant != Variant::kFull &&
+                                     variant != Variant::kEigenvaluesOnly;
+  SymmetricAlgorithm algorithm(input_precision, predict(variant, size));
+  DynamicVector eigenvalues;
+  DynamicMatrix unitary;
+  MemoryReport report =
+      algorithm.run(&data, &eigenvalues, &unitary, requirements);
+  double delta = 0;
+  if (requirements.need_unitary) {
+    delta = norm(old_data -
+                 unitary * eigenvalues.asDiagonal() * unitary.transpose());
+  }
+  if (!report.fits || report.variant != variant || delta > result_precision ||
+      eigenvalues.rows() != size || !peak_is_predicted(report)) {
+    process_run_check_failed("SymmetricSchurDecomposition", report, delta,
+                             test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  for (int size : matrix_sizes) {
+    if (!plan_check(size)) return;
+    for (Variant variant : memory_budget::variants) {
+      for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+        srand(test_id);
+        if (!nonsymmetric_check(size, variant, test_id)) return;
+        if (!symmetric_check(size, variant, test_id)) return;
+      }
+    }
+  }
+  cout << "Passed memory budget stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Matrix sizes: 64, 128, 256\n";
+  cout << "Peak tolerance: " << peak_tolerance << " + "
+       << allocator_cache_bytes << " bytes\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_memory_budget
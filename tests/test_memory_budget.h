@@ -0,0 +1,3 @@
+namespace test_memory_budget {
+void run();
+}  // namespace test_memory_budget
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/memory_policy.h"
+#include "../schur_decomposition/schur_decomposition.h"
+
+namespace test_memory_policy {
+
+using std::cout;
+using std::max;
+using HugePageAllocator = memory_policy::HugePageAllocator<double>;
+using Algorithm =
+    schur_decomposition::SchurDecomposition<double, HugePageAllocator>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+
+constexpr const long double input_precision = 1e-12;
+constexpr const long double result_precision = 1e-11;
+constexpr const int number_of_tests = 20;
+constexpr const int matrix_size_max = 100;
+
+void process_allocation_check_failed(const DynamicMatrix& buffer, int rows,
+                                     int cols) {
+  cout << "test failed in HugePageAllocator::allocate():\n\n";
+  cout << "requested:\t" << rows << " x " << cols << "\n";
+  cout << "allocated:\t" << buffer.rows() << " x " << buffer.cols() << "\n";
+  cout << "address:\t" << buffer.data() << "\n";
+}
+
+void process_bad_restore(const DynamicMatrix& old_data,
+                         const DynamicMatrix& restored_data, int test_id,
+                         int size) {
+  cout << "test failed in SchurDecomposition::run() with HugePageAllocator, "
+          "wrong restore:\n\n";
+  cout << "input: M =\n" << old_data << "\n\n";
+  cout << "restored: M =\n" << restored_data << "\n\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data, int size) {
+  double max_element = 0.;
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+bool allocation_check(int rows, int cols) {
+  HugePageAllocator allocator(0);
+  DynamicMatrix buffer;
+  allocator.allocate(&buffer, rows, cols);
+  bool aligned =
+      reinterpret_cast<std::uintptr_t>(buffer.data()) % EIGEN_MAX_ALIGN_BYTES ==
+      0;
+  if (buffer.rows() != rows || buffer.cols() != cols || !aligned) {
+    process_allocation_check_failed(buffer, rows, cols);
+    return false;
+  }
+  return true;
+}
+
+bool simple_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  DynamicMatrix result;
+  DynamicMatrix backtrace;
+  Algorithm algorithm(input_precision, HugePageAllocator(0));
+  algorithm.run(data, &result, &backtrace);
+  DynamicMatrix restored_data = backtrace * result * backtrace.transpose();
+  if (norm(data - restored_data, size) > result_precision) {
+    process_bad_restore(data, restored_data, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  for (int size = 1; size <= matrix_size_max; ++size) {
+    if (!allocation_check(size, size + 1)) return;
+    for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+      srand(test_id);
+      if (!simple_check(size, test_id)) return;
+    }
+  }
+  cout << "Passed HugePageAllocator stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Maximum matrix size: " << matrix_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_memory_policy
@@ -0,0 +1,3 @@
+namespace test_memory_policy {
+void run();
+}  // namespace test_memory_policy
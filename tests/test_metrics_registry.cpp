@@ -0,0 +1,222 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/metrics_registry.h"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+
+namespace test_metrics_registry {
+
+using std::cout;
+using std::string;
+using metrics_registry::MetricsRegistry;
+using Algorithm = schur_decomposition::SchurDecomposition<double>;
+using SymmetricAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<double>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = SymmetricAlgorithm::DynamicVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_size = 20;
+constexpr const int large_matrix_size = 80;
+constexpr const int number_of_runs = 5;
+constexpr const int number_of_threads = 4;
+
+string export_metrics() {
+  std::ostringstream out;
+  MetricsRegistry::instance().export_prometheus(out);
+  return out.str();
+}
+
+// Value of the sample whose name and labels are exactly series, or -1.
+double find_sample(const string& metrics, const string& series) {
+  string prefix = series + " ";
+  for (size_t pos = metrics.find(prefix); pos != string::npos;
+       pos = metrics.find(prefix, pos + 1)) {
+    if (pos == 0 || metrics[pos - 1] == '\n') {
+      return std::stod(metrics.substr(pos + prefix.size()));
+    }
+  }
+  return -1;
+}
+
+void process_check_failed(const char* check, const string& metrics) {
+  cout << "test failed in MetricsRegistry (" << check << "):\n\n";
+  cout << "exported metrics:\n" << metrics.substr(0, 4000) << "\n";
+}
+
+bool solver_calls_check() {
+  Algorithm algorithm(input_precision);
+  int sweeps = 0;
+  for (int run = 0; run < number_of_runs; ++run) {
+    DynamicMatrix data = DynamicMatrix::Random(matrix_size, matrix_size);
+    DynamicMatrix result;
+    DynamicMatrix unitary;
+    algorithm.run(data, &result, &unitary);
+    sweeps += algorithm.get_iterations();
+  }
+  SymmetricAlgorithm symmetric_algorithm(input_precision);
+  DynamicMatrix data = DynamicMatrix::Random(large_matrix_size,
+                                             large_matrix_size);
+  data += data.transpose().eval();
+  DynamicVector eigenvalues;
+  symmetric_algorithm.run(data, &eigenvalues);
+
+  string metrics = export_metrics();
+  string schur = "{solver=\"schur_decomposition\"";
+  string symmetric = "{solver=\"schur_decomposition_symmetric\"";
+  string hessenberg = "{solver=\"hessenberg_reduction\"";
+  bool passed =
+      find_sample(metrics, "schur_solver_duration_seconds_count" + schur +
+                               ",size_class=\"64\"}") == number_of_runs &&
+      find_sample(metrics, "schur_solver_duration_seconds_count" + schur +
+                               ",size_class=\"16\"}") == 0 &&
+      find_sample(metrics, "schur_solver_duration_seconds_count" + symmetric +
+                               ",size_class=\"256\"}") == 1 &&
+      find_sample(metrics, "schur_solver_duration_seconds_count" +
+                               hessenberg + ",size_class=\"64\"}") ==
+          number_of_runs &&
+      find_sample(metrics, "schur_solver_sweeps_count" + schur + "}") ==
+          number_of_runs &&
+      find_sample(metrics, "schur_solver_sweeps_sum" + schur + "}") ==
+          sweeps &&
+      find_sample(metrics, "schur_solver_sweeps_sum" + symmetric + "}") ==
+          symmetric_algorithm.get_iterations() &&
+      find_sample(metrics, "schur_solver_over_iteration_budget_total" +
+                               schur + "}") == 0 &&
+      find_sample(metrics, "schur_solver_allocations_total" + schur + "}") ==
+          number_of_runs &&
+      find_sample(metrics, "schur_solver_allocations_total" + hessenberg +
+                               "}") == number_of_runs &&
+      find_sample(metrics, "schur_solver_allocated_bytes_total" + symmetric +
+                               "}") == large_matrix_size * large_matrix_size *
+                                           sizeof(double);
+  if (!passed) {
+    process_check_failed("solver calls", metrics);
+  }
+  return passed;
+}
+
+// Buckets are cumulative and the +Inf bucket holds every call.
+bool buckets_check() {
+  MetricsRegistry& registry = MetricsRegistry::instance();
+  registry.record_call(metrics_registry::Solver::kSchurDecomposition, 10,
+                       500, 5);
+  registry.record_call(metrics_registry::Solver::kSchurDecomposition, 10,
+                       50'000'000, 50'000);
+  string metrics = export_metrics();
+  string labels = "solver=\"schur_decomposition\",size_class=\"16\"";
+  string sweeps_labels = "solver=\"schur_decomposition\"";
+  bool passed =
+      find_sample(metrics, "schur_solver_duration_seconds_bucket{" + labels +
+                               ",le=\"0.000010\"}") == 1 &&
+      find_sample(metrics, "schur_solver_duration_seconds_bucket{" + labels +
+                               ",le=\"0.010000\"}") == 1 &&
+      find_sample(metrics, "schur_solver_duration_seconds_bucket{" + labels +
+                               ",le=\"0.100000\"}") == 2 &&
+      find_sample(metrics, "schur_solver_duration_seconds_bucket{" + labels +
+                               ",le=\"+Inf\"}") == 2 &&
+      find_sample(metrics, "schur_solver_sweeps_bucket{" + sweeps_labels +
+                               ",le=\"10\"}") == 1 &&
+      find_sample(metrics, "schur_solver_sweeps_bucket{" + sweeps_labels +
+                               ",le=\"+Inf\"}") == 2 &&
+      find_sample(metrics, "schur_solver_over_iteration_budget_total{" +
+                               sweeps_labels + "}") == 1;
+  if (!passed) {
+    process_check_failed("cumulative buckets", metrics);
+  }
+  return passed;
+}
+
+bool disabled_check() {
+  MetricsRegistry& registry = MetricsRegistry::instance();
+  registry.disable();
+  Algorithm algorithm(input_precision);
+  DynamicMatrix data = DynamicMatrix::Random(matrix_size, matrix_size);
+  DynamicMatrix result;
+  algorithm.run(data, &result);
+  registry.enable();
+  string metrics = export_metrics();
+  if (find_sample(metrics, "schur_solver_allocations_total{solver=\"schur_"
+                           "decomposition\"}") != 0 ||
+      find_sample(metrics, "schur_solver_sweeps_count{solver=\"schur_"
+                           "decomposition\"}") != 0) {
+    process_check_failed("disabled registry", metrics);
+    return false;
+  }
+  return true;
+}
+
+bool threads_check() {
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < number_of_threads; ++thread) {
+    threads.emplace_back([] {
+      Algorithm algorithm(input_precision);
+      for (int run = 0; run < number_of_runs; ++run) {
+        DynamicMatrix data = DynamicMatrix::Random(matrix_size, matrix_size);
+        DynamicMatrix result;
+        algorithm.run(data, &result);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  string metrics = export_metrics();
+  if (find_sample(metrics, "schur_solver_sweeps_count{solver=\"schur_"
+                           "decomposition\"}") !=
+      number_of_threads * number_of_runs) {
+    process_check_failed("per-thread counters", metrics);
+    return false;
+  }
+  return true;
+}
+
+bool file_check() {
+  string path = "test_metrics_registry.prom";
+  if (!MetricsRegistry::instance().write_prometheus_file(path)) {
+    process_check_failed("file export", "");
+    return false;
+  }
+  std::ifstream in(path);
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  std::remove(path.c_str());
+  string metrics = export_metrics();
+  if (contents.str() != metrics) {
+    process_check_failed("file export", contents.str());
+    return false;
+  }
+  return true;
+}
+
+void run_testing() {
+  MetricsRegistry& registry = MetricsRegistry::instance();
+  registry.reset();
+  registry.enable();
+  bool passed = solver_calls_check();
+  registry.reset();
+  passed = passed && buckets_check();
+  registry.reset();
+  passed = passed && disabled_check();
+  registry.reset();
+  passed = passed && threads_check();
+  passed = passed && file_check();
+  registry.disable();
+  registry.reset();
+  if (!passed) return;
+
+  cout << "Passed MetricsRegistry testing\n";
+  cout << "Number of runs: " << number_of_runs << "\n";
+  cout << "Number of threads: " << number_of_threads << "\n\n\n";
+}
+
+void run() { run_testing(); }
+
+}  // namespace test_metrics_registry
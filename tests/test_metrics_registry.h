@@ -0,0 +1,3 @@
+namespace test_metrics_registry {
+void run();
+}  // namespace test_metrics_registry
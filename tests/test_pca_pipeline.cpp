@@ -0,0 +1,128 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/pca_pipeline.h"
+
+namespace test_pca_pipeline {
+
+using std::cout;
+using std::max;
+using PcaPipeline = pca_pipeline::PcaPipeline<double>;
+using DynamicMatrix = PcaPipeline::DynamicMatrix;
+using DynamicVector = PcaPipeline::DynamicVector;
+
+constexpr const double result_precision = 1e-9;
+constexpr const double algorithm_precision = 1e-12;
+constexpr const int number_of_tests = 50;
+constexpr const int features_max = 60;
+constexpr const int samples_max = 400;
+constexpr const int chunk_size_max = 50;
+constexpr const int number_of_threads = 4;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int features, int samples) {
+  cout << "test failed in PcaPipeline (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "features:\t" << features << "\n";
+  cout << "samples:\t" << samples << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+// Feeds the rows of data in chunks of random size.
+void feed(const DynamicMatrix& data, std::mt19937* gen,
+          PcaPipeline* pipeline) {
+  std::uniform_int_distribution<int> chunk_sizes(1, chunk_size_max);
+  int next = 0;
+  pipeline->add_chunks([&](DynamicMatrix* chunk) {
+    if (next == data.rows()) {
+      return false;
+    }
+    int rows = std::min<int>(chunk_sizes(*gen), data.rows() - next);
+    *chunk = data.middleRows(next, rows);
+    next += rows;
+    return true;
+  });
+}
+
+bool pca_pipeline_check(int features, int samples, int test_id,
+                        std::mt19937* gen) {
+  std::uniform_int_distribution<int> counts(0, features);
+  // Columns with different scales and a large offset, to catch a loss of
+  // precision in the centering.
+  DynamicMatrix data = DynamicMatrix::Random(samples, features) *
+                       DynamicVector::Random(features).asDiagonal();
+  data.rowwise() += DynamicVector::Constant(features, 1e3).transpose();
+  DynamicVector mean = data.colwise().mean().transpose();
+  DynamicMatrix centered = data.rowwise() - mean.transpose();
+  DynamicMatrix covariance =
+      centered.transpose() * centered / double(samples - 1);
+  double scale = max(covariance.cwiseAbs().maxCoeff(), 1e-3);
+
+  PcaPipeline pipeline(features, algorithm_precision, number_of_threads);
+  feed(data, gen, &pipeline);
+  double delta = (pipeline.get_mean() - mean).cwiseAbs().maxCoeff() / 1e3;
+  if (pipeline.get_samples_count() != samples || delta > result_precision) {
+    process_check_failed("mean", delta, test_id, features, samples);
+    return false;
+  }
+  int count = counts(*gen);
+  DynamicVector variances;
+  DynamicMatrix components;
+  pipeline.compute(count, &variances, &components);
+
+  Eigen::SelfAdjointEigenSolver<DynamicMatrix> solver(covariance);
+  DynamicVector expected = solver.eigenvalues().reverse().head(count);
+  delta = count == 0 ? 0. : (variances - expected).cwiseAbs().maxCoeff();
+  if (delta / scale > result_precision) {
+    process_check_failed("variances", delta, test_id, features, samples);
+    return false;
+  }
+  DynamicMatrix residual =
+      covariance * components - components * variances.asDiagonal();
+  DynamicMatrix gram = components.transpose() * components;
+  delta = count == 0 ? 0. : residual.cwiseAbs().maxCoeff() / scale;
+  delta = max(delta, count == 0 ? 0.
+                                : (gram - DynamicMatrix::Identity(count, count))
+                                      .cwiseAbs()
+                                      .maxCoeff());
+  if (delta > result_precision) {
+    process_check_failed("components", delta, test_id, features, samples);
+    return false;
+  }
+
+  PcaPipeline serial(features, algorithm_precision, 1);
+  feed(data, gen, &serial);
+  DynamicVector serial_variances;
+  DynamicMatrix serial_components;
+  serial.compute(count, &serial_variances, &serial_components);
+  delta = count == 0 ? 0.
+                     : (serial_variances - variances).cwiseAbs().maxCoeff();
+  if (delta / scale > result_precision) {
+    process_check_failed("threads", delta, test_id, features, samples);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> features(1, features_max);
+  std::uniform_int_distribution<int> samples(2, samples_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!pca_pipeline_check(features(gen), samples(gen), test_id, &gen)) {
+      return;
+    }
+  }
+  cout << "Passed PCA pipeline stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max features: " << features_max << "\n";
+  cout << "Max samples: " << samples_max << "\n";
+  cout << "Number of threads: " << number_of_threads << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_pca_pipeline
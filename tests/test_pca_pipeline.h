@@ -0,0 +1,3 @@
+namespace test_pca_pipeline {
+void run();
+}  // namespace test_pca_pipeline
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/periodic_schur_decomposition.h"
+
+namespace test_periodic_schur_decomposition {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Periodic = periodic_schur_decomposition::PeriodicSchurDecomposition<
+    double>;
+using Algorithm = Periodic::Algorithm;
+using DynamicMatrix = Periodic::DynamicMatrix;
+using ComplexVector = Periodic::ComplexVector;
+using Factors = Periodic::Factors;
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 100;
+constexpr const int matrix_size_max = 40;
+constexpr const int factors_count_max = 4;
+
+void process_bad_restore(double delta, int factor, int test_id, int size) {
+  cout << "test failed in PeriodicSchurDecomposition::run(), wrong "
+          "restore:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "factor:\t" << factor << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_not_schur_form(const DynamicMatrix& result, int factor,
+                            int test_id, int size) {
+  cout << "test failed in PeriodicSchurDecomposition::run(), factor is not "
+          "in Schur form:\n\n";
+  cout << "result:\n" << result << "\n\n";
+  cout << "factor:\t" << factor << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_eigenvalues_check_failed(double delta, int test_id, int size) {
+  cout << "test failed in PeriodicSchurDecomposition::run(), wrong "
+          "eigenvalues:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+bool near_zero(double val) { return abs(val) < result_precision; }
+
+bool is_triangular(const DynamicMatrix& data) {
+  return data.isUpperTriangular(result_precision);
+}
+
+// No two consecutive subdiagonal entries may be nonzero.
+bool is_quasi_triangular(const DynamicMatrix& data) {
+  int size = data.rows();
+  if (size > 1 &&
+      !data.bottomLeftCorner(size - 1, size - 1).isUpperTriangular(
+          result_precision)) {
+    return false;
+  }
+  for (int i = 2; i < size; ++i) {
+    if (!near_zero(data(i, i - 1)) && !near_zero(data(i - 1, i - 2))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Largest distance from an eigenvalue of computed to the closest not yet used
+// eigenvalue of expected.
+double eigenvalues_distance(const ComplexVector& computed,
+                            const ComplexVector& expected) {
+  double delta = 0.;
+  std::vector<bool> is_used(expected.size(), false);
+  for (int i = 0; i < computed.size(); ++i) {
+    int closest = -1;
+    for (int j = 0; j < expected.size(); ++j) {
+      if (!is_used[j] && (closest < 0 || abs(expected(j) - computed(i)) <
+                                             abs(expected(closest) -
+                                                 computed(i)))) {
+        closest = j;
+      }
+    }
+    is_used[closest] = true;
+    delta = max(delta, abs(expected(closest) - computed(i)));
+  }
+  return delta;
+}
+
+bool run_test(int size, int factors_count, int test_id) {
+  Factors factors(factors_count);
+  DynamicMatrix product = DynamicMatrix::Identity(size, size);
+  for (DynamicMatrix& factor : factors) {
+    factor = DynamicMatrix::Random(size, size);
+    product = factor * product;
+  }
+  Periodic periodic(input_precision);
+  Factors schur_factors;
+  Factors unitaries;
+  periodic.run(factors, &schur_factors, &unitaries);
+  for (int index = 0; index < factors_count; ++index) {
+    const DynamicMatrix& result = schur_factors[index];
+    bool is_last = index + 1 == factors_count;
+    if (is_last ? !is_quasi_triangular(result) : !is_triangular(result)) {
+      process_not_schur_form(result, index, test_id, size);
+      return false;
+    }
+    const DynamicMatrix& left = unitaries[(index + 1) % factors_count];
+    double delta = norm(factors[index] -
+                        left * result * unitaries[index].transpose());
+    if (delta > result_precision) {
+      process_bad_restore(delta, index, test_id, size);
+      return false;
+    }
+  }
+  ComplexVector computed;
+  Periodic::extract_eigenvalues(schur_factors, &computed);
+  Algorithm algorithm(input_precision);
+  DynamicMatrix schur_form;
+  algorithm.run(product, &schur_form);
+  ComplexVector expected;
+  Algorithm::extract_eigenvalues(schur_form, &expected);
+  double delta = eigenvalues_distance(computed, expected);
+  if (delta > result_precision * max(1., norm(product))) {
+    process_eigenvalues_check_failed(delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::uniform_int_distribution<int> counts(1, factors_count_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!run_test(sizes(gen), counts(gen), test_id)) return;
+  }
+  cout << "Passed periodic Schur decomposition stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max number of factors: " << factors_count_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_periodic_schur_decomposition
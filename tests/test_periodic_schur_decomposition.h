@@ -0,0 +1,3 @@
+namespace test_periodic_schur_decomposition {
+void run();
+}  // namespace test_periodic_schur_decomposition
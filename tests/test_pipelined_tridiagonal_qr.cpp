@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/pipelined_tridiagonal_qr.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+
+namespace test_pipelined_tridiagonal_qr {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Pipelined = pipelined_tridiagonal_qr::PipelinedTridiagonalQR<double>;
+using SymmetricAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<double>;
+using DynamicMatrix = Pipelined::DynamicMatrix;
+using DynamicVector = Pipelined::DynamicVector;
+
+constexpr const double input_precision = 1e-13;
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 30;
+constexpr const int matrix_size_max = 150;
+constexpr const int sweeps = 4;
+constexpr const int number_of_threads = 4;
+
+void process_check_failed(const char* kind, double delta, int test_id,
+                          int size) {
+  cout << "test failed in PipelinedTridiagonalQR::run(), wrong " << kind
+       << ":\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+DynamicVector sorted(DynamicVector values) {
+  std::sort(values.data(), values.data() + values.size());
+  return values;
+}
+
+bool run_test(int size, int test_id, int* batches, int* pipelined_sweeps) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += data.transpose().eval();
+  Pipelined pipelined(input_precision, sweeps, number_of_threads);
+  DynamicVector eigenvalues;
+  DynamicMatrix unitary;
+  pipelined.run(data, &eigenvalues, &unitary);
+  double delta = norm(data - unitary * eigenvalues.asDiagonal() *
+                                 unitary.transpose());
+  if (delta > result_precision) {
+    process_check_failed("restore", delta, test_id, size);
+    return false;
+  }
+  SymmetricAlgorithm algorithm(input_precision);
+  DynamicVector expected;
+  algorithm.run(data, &expected);
+  delta = norm(sorted(eigenvalues) - sorted(expected));
+  if (delta > result_precision) {
+    process_check_failed("eigenvalues", delta, test_id, size);
+    return false;
+  }
+  // The pipeline keeps the order of the sequential sweeps, so the result
+  // does not depend on the number of threads.
+  Pipelined sequential(input_precision, sweeps, 1);
+  DynamicVector sequential_eigenvalues;
+  DynamicMatrix sequential_unitary;
+  sequential.run(data, &sequential_eigenvalues, &sequential_unitary);
+  if (sequential_eigenvalues != eigenvalues ||
+      sequential_unitary != unitary) {
+    process_check_failed("result with one thread", 0., test_id, size);
+    return false;
+  }
+  *batches += pipelined.get_batches();
+  *pipelined_sweeps += pipelined.get_sweeps();
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  int batches = 0;
+  int pipelined_sweeps = 0;
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!run_test(sizes(gen), test_id, &batches, &pipelined_sweeps)) return;
+  }
+  cout << "Passed pipelined tridiagonal QR stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Sweeps in flight: " << sweeps << ", threads: "
+       << number_of_threads << "\n";
+  cout << "Batches / sweeps: " << batches << " / " << pipelined_sweeps
+       << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_pipelined_tridiagonal_qr
@@ -0,0 +1,3 @@
+namespace test_pipelined_tridiagonal_qr {
+void run();
+}  // namespace test_pipelined_tridiagonal_qr
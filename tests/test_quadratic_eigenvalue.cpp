@@ -0,0 +1,104 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/quadratic_eigenvalue.h"
+
+namespace test_quadratic_eigenvalue {
+
+using std::cout;
+using QuadraticEigensolver =
+    quadratic_eigenvalue::QuadraticEigensolver<double>;
+using DynamicMatrix = QuadraticEigensolver::DynamicMatrix;
+using Complex = QuadraticEigensolver::Complex;
+using ComplexVector = QuadraticEigensolver::ComplexVector;
+using ComplexMatrix = Eigen::Matrix<Complex, -1, -1>;
+
+enum class ProblemKind { kRandom, kBadlyScaled, kSingularMass };
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 150;
+constexpr const int matrix_size_max = 30;
+constexpr const ProblemKind problem_kinds[] = {
+    ProblemKind::kRandom, ProblemKind::kBadlyScaled,
+    ProblemKind::kSingularMass};
+
+void process_check_failed(const char* check, double delta, int size,
+                          int test_id) {
+  cout << "test failed in QuadraticEigensolver (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+// Backward error of an eigenvalue, sigma_min(Q(l)) over
+// |l|^2 |M| + |l| |C| + |K|, evaluated with the reversed polynomial in
+// m = 1 / l for large eigenvalues.
+double backward_error(const DynamicMatrix& mass, const DynamicMatrix& damping,
+                      const DynamicMatrix& stiffness, Complex eigenvalue) {
+  bool is_large = std::abs(eigenvalue) > 1;
+  Complex point = is_large ? Complex(1) / eigenvalue : eigenvalue;
+  const DynamicMatrix& leading = is_large ? stiffness : mass;
+  const DynamicMatrix& trailing = is_large ? mass : stiffness;
+  ComplexMatrix value = point * point * leading.cast<Complex>() +
+                        point * damping.cast<Complex>() +
+                        trailing.cast<Complex>();
+  double scale = std::norm(point) * leading.norm() +
+                 std::abs(point) * damping.norm() + trailing.norm();
+  Eigen::JacobiSVD<ComplexMatrix> svd(value);
+  return svd.singularValues().minCoeff() / scale;
+}
+
+bool quadratic_eigenvalue_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  int size = sizes(*gen);
+  ProblemKind kind = problem_kinds[test_id % std::size(problem_kinds)];
+  DynamicMatrix mass = DynamicMatrix::Random(size, size);
+  DynamicMatrix damping = DynamicMatrix::Random(size, size);
+  DynamicMatrix stiffness = DynamicMatrix::Random(size, size);
+  if (kind == ProblemKind::kBadlyScaled) {
+    mass *= 1e-5;
+    damping *= 1e-1;
+    stiffness *= 1e5;
+  } else if (kind == ProblemKind::kSingularMass) {
+    mass.col(0).setZero();
+  }
+  QuadraticEigensolver algorithm(input_precision);
+  ComplexVector eigenvalues;
+  algorithm.run(mass, damping, stiffness, &eigenvalues);
+  if (eigenvalues.rows() != 2 * size ||
+      algorithm.is_reversed() != (kind == ProblemKind::kSingularMass)) {
+    process_check_failed("output", eigenvalues.rows(), size, test_id);
+    return false;
+  }
+  for (Complex eigenvalue : eigenvalues) {
+    if (std::isinf(eigenvalue.real())) {
+      continue;
+    }
+    double delta = backward_error(mass, damping, stiffness, eigenvalue);
+    if (!(delta <= result_precision)) {
+      process_check_failed("backward error", delta, size, test_id);
+      return false;
+    }
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!quadratic_eigenvalue_check(test_id, &gen)) {
+      return;
+    }
+  }
+  cout << "Passed QuadraticEigensolver stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_quadratic_eigenvalue
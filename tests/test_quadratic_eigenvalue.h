@@ -0,0 +1,3 @@
+namespace test_quadratic_eigenvalue {
+void run();
+}  // namespace test_quadratic_eigenvalue
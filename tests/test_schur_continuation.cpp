@@ -0,0 +1,171 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_continuation.h"
+
+namespace test_schur_continuation {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Continuation = schur_continuation::SchurContinuation<double>;
+using Algorithm = Continuation::Algorithm;
+using DynamicMatrix = Continuation::DynamicMatrix;
+using ComplexVector = Continuation::ComplexVector;
+using Point = Continuation::Point;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 10;
+constexpr const int matrix_size_max = 60;
+constexpr const double parameter_step = 0.02;
+
+void process_eigenvalues_check_failed(const Point& point, double delta,
+                                      int test_id, int size) {
+  cout << "test failed in SchurContinuation::track(), wrong eigenvalues:\n\n";
+  cout << "parameter:\t" << point.parameter << "\n";
+  cout << "tracked eigenvalues:\n" << point.eigenvalues << "\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_bad_restore(double delta, int test_id, int size) {
+  cout << "test failed in SchurContinuation::track(), wrong restore:\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_step_check_failed(double delta, int test_id) {
+  cout << "test failed in SchurContinuation::track(), wrong step control:\n\n";
+  cout << "smallest step = " << delta << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+// Largest distance from an eigenvalue of tracked to the closest not yet used
+// eigenvalue of expected.
+double eigenvalues_distance(const ComplexVector& tracked,
+                            ComplexVector expected) {
+  double delta = 0.;
+  std::vector<bool> is_used(expected.size(), false);
+  for (int i = 0; i < tracked.size(); ++i) {
+    int closest = -1;
+    for (int j = 0; j < expected.size(); ++j) {
+      if (!is_used[j] && (closest < 0 || abs(expected(j) - tracked(i)) <
+                                             abs(expected(closest) -
+                                                 tracked(i)))) {
+        closest = j;
+      }
+    }
+    is_used[closest] = true;
+    delta = max(delta, abs(expected(closest) - tracked(i)));
+  }
+  return delta;
+}
+
+bool tracking_check(int size, int test_id, int* newton_steps,
+                    int* continued_iterations, int* fresh_iterations) {
+  DynamicMatrix base = DynamicMatrix::Random(size, size);
+  DynamicMatrix direction = DynamicMatrix::Random(size, size);
+  auto family = [&](double parameter) -> DynamicMatrix {
+    return base + parameter * direction;
+  };
+  Continuation continuation(input_precision);
+  std::vector<Point> path;
+  continuation.track(family, 0., 1., parameter_step, &path);
+  for (std::size_t index = 1; index < path.size(); ++index) {
+    const Point& point = path[index];
+    Algorithm algorithm(input_precision);
+    DynamicMatrix schur_form;
+    algorithm.run(family(point.parameter), &schur_form);
+    ComplexVector expected;
+    Algorithm::extract_eigenvalues(schur_form, &expected);
+    double delta = eigenvalues_distance(point.eigenvalues, expected);
+    if (delta > result_precision) {
+      process_eigenvalues_check_failed(point, delta, test_id, size);
+      return false;
+    }
+    *newton_steps += point.newton_steps;
+    *continued_iterations += point.iterations;
+    *fresh_iterations += algorithm.get_iterations();
+  }
+  const DynamicMatrix& unitary = continuation.get_unitary();
+  double delta = norm(family(1.) - unitary * continuation.get_schur_form() *
+                                       unitary.transpose());
+  if (delta > result_precision) {
+    process_bad_restore(delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+// Two real eigenvalues 1 - t and t cross at t = 1/2; the step has to shrink
+// around the crossing and nowhere else.
+bool step_control_check(int test_id) {
+  constexpr const int size = 6;
+  DynamicMatrix basis =
+      Eigen::HouseholderQR<DynamicMatrix>(DynamicMatrix::Random(size, size))
+          .householderQ();
+  auto family = [&](double parameter) -> DynamicMatrix {
+    Eigen::VectorXd diagonal(size);
+    diagonal << 1. - parameter, parameter, 3., 4., 5., 6.;
+    return basis * diagonal.asDiagonal() * basis.transpose();
+  };
+  Continuation continuation(input_precision);
+  std::vector<Point> path;
+  continuation.track(family, 0., 1., 0.1, &path);
+  double smallest_step = 1.;
+  for (std::size_t index = 1; index + 1 < path.size(); ++index) {
+    double step = path[index].parameter - path[index - 1].parameter;
+    smallest_step = std::min(smallest_step, step);
+    double middle = (path[index].parameter + path[index - 1].parameter) / 2;
+    if (step < 0.1 - 1e-12 && abs(middle - 0.5) > 0.25) {
+      process_step_check_failed(step, test_id);
+      return false;
+    }
+  }
+  if (smallest_step >= 0.1 - 1e-12 || path.back().parameter != 1.) {
+    process_step_check_failed(smallest_step, test_id);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(2, matrix_size_max);
+  int newton_steps = 0;
+  int continued_iterations = 0;
+  int fresh_iterations = 0;
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!tracking_check(sizes(gen), test_id, &newton_steps,
+                        &continued_iterations, &fresh_iterations)) {
+      return;
+    }
+    if (!step_control_check(test_id)) return;
+  }
+  cout << "Passed Schur continuation stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Newton steps: " << newton_steps << "\n";
+  cout << "QR sweeps, continued / from scratch: " << continued_iterations
+       << " / " << fresh_iterations << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_schur_continuation
@@ -5,6 +5,7 @@
 #include <random>
 
 #include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/hessenberg_reduction.h"
 #include "../schur_decomposition/schur_decomposition.h"
 
 namespace test_schur_decomposition {
@@ -15,11 +16,14 @@ using std::max;
 using std::min;
 using Algorithm = schur_decomposition::SchurDecomposition<double>;
 using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
 
 constexpr const long double input_precision = 1e-12;
 constexpr const long double result_precision = 1e-11;
 constexpr const int number_of_tests = 200;
 constexpr const int matrix_size_max = 200;
+constexpr const int number_of_continuation_tests = 20;
+constexpr const int continuation_size_max = 60;
 
 void process_triangular_check_failed(const DynamicMatrix& data,
                                      const DynamicMatrix& result, int test_id,
@@ -108,6 +112,57 @@ bool simple_check(int size, int test_id) {
   return true;
 }
 
+bool continuation_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  DynamicMatrix result;
+  DynamicMatrix backtrace;
+  Algorithm algorithm(input_precision);
+  algorithm.run(data, &result, &backtrace);
+
+  DynamicVector column = DynamicVector::Random(size);
+  DynamicVector row = DynamicVector::Random(size);
+  double corner = DynamicVector::Random(1)(0);
+  Algorithm::HessenbergReduction reduction;
+  reduction.update(column, row, corner, &result, &backtrace);
+  algorithm.run_hessenberg(&result, &backtrace);
+
+  data.conservativeResize(size + 1, size + 1);
+  data.col(size).head(size) = column;
+  data.row(size).head(size) = row.transpose();
+  data(size, size) = corner;
+  if (!is_quasi_triangular(result, size + 1)) {
+    process_triangular_check_failed(data, result, test_id, size + 1);
+    return false;
+  }
+  if (!backtrace.isUnitary()) {
+    process_unitary_check_failed(data, backtrace, test_id, size + 1);
+    return false;
+  }
+  DynamicMatrix restored_data = backtrace * result * backtrace.transpose();
+  if (!are_indistinguishable(data, restored_data, size + 1)) {
+    process_bad_restore(data, restored_data, test_id,
+                        norm(data - restored_data, size + 1), size + 1);
+    return false;
+  }
+  return true;
+}
+
+void run_continuation_testing() {
+  for (int size = 1; size <= continuation_size_max; ++size) {
+    for (int test_id = 1; test_id <= number_of_continuation_tests;
+         ++test_id) {
+      srand(test_id);
+      if (!continuation_check(size, test_id)) return;
+    }
+  }
+
+  cout << "Passed SchurDecomposition::run_hessenberg() stress testing\n";
+  cout << "Number of tests: " << number_of_continuation_tests << "\n";
+  cout << "Maximum matrix size: " << continuation_size_max + 1 << "\n";
+  cout << "Input precision: " << input_precision << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
 void run_stress_testing() {
   for (int size = 1; size <= matrix_size_max; ++size) {
     for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
@@ -123,6 +178,9 @@ void run_stress_testing() {
   cout << "Result precision: " << result_precision << "\n\n\n";
 }
 
-void run() { run_stress_testing(); }
+void run() {
+  run_stress_testing();
+  run_continuation_testing();
+}
 
 }  // namespace test_schur_decomposition
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_decomposition_skew_symmetric.h"
+
+namespace test_schur_decomposition_skew_symmetric {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Algorithm = schur_decomposition_skew_symmetric::SchurDecomposition<
+    double>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 100;
+constexpr const int matrix_size_max = 60;
+constexpr const int low_rank = 4;
+
+void process_bad_restore(const char* kind, double delta, int test_id,
+                         int size) {
+  cout << "test failed in skew-symmetric SchurDecomposition::run(), wrong "
+       << kind << ":\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_wrong_frequencies(const DynamicVector& frequencies, int test_id,
+                               int size) {
+  cout << "test failed in skew-symmetric SchurDecomposition::run(), wrong "
+          "frequencies:\n\n";
+  cout << "frequencies:\n" << frequencies << "\n\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+// Rank 2 * low_rank for sizes above it, which leaves a kernel to split off.
+DynamicMatrix make_skew_symmetric(int size, bool is_low_rank) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  if (is_low_rank && size > 2 * low_rank) {
+    DynamicMatrix left = DynamicMatrix::Random(size, low_rank);
+    data = left * DynamicMatrix::Random(low_rank, size);
+  }
+  return data - data.transpose();
+}
+
+bool run_test(int size, bool is_low_rank, int test_id) {
+  DynamicMatrix data = make_skew_symmetric(size, is_low_rank);
+  // The upper triangle must not be read.
+  DynamicMatrix input = data;
+  input.triangularView<Eigen::StrictlyUpper>() =
+      DynamicMatrix::Random(size, size);
+  Algorithm algorithm(input_precision);
+  DynamicVector frequencies;
+  DynamicMatrix unitary;
+  algorithm.run(input, &frequencies, &unitary);
+  for (int index = 0; index < frequencies.rows(); ++index) {
+    if (frequencies(index) < 0 ||
+        (index > 0 && frequencies(index) > frequencies(index - 1))) {
+      process_wrong_frequencies(frequencies, test_id, size);
+      return false;
+    }
+  }
+  double delta = norm(unitary.transpose() * unitary -
+                      DynamicMatrix::Identity(size, size));
+  if (delta > result_precision) {
+    process_bad_restore("unitary", delta, test_id, size);
+    return false;
+  }
+  DynamicMatrix canonical_form;
+  Algorithm::make_canonical_form(frequencies, size, &canonical_form);
+  delta = norm(data - unitary * canonical_form * unitary.transpose());
+  if (delta > result_precision) {
+    process_bad_restore("restore", delta, test_id, size);
+    return false;
+  }
+  DynamicVector without_unitary;
+  algorithm.run(input, &without_unitary);
+  delta = (without_unitary - frequencies).cwiseAbs().maxCoeff();
+  if (delta > result_precision) {
+    process_bad_restore("frequencies without unitary", delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!run_test(sizes(gen), test_id % 2 == 0, test_id)) return;
+  }
+  cout << "Passed skew-symmetric Schur decomposition stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Input precision: " << input_precision << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_schur_decomposition_skew_symmetric
@@ -0,0 +1,3 @@
+namespace test_schur_decomposition_skew_symmetric {
+void run();
+}  // namespace test_schur_decomposition_skew_symmetric
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_dispatcher.h"
+
+namespace test_schur_dispatcher {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Path = schur_dispatcher::Path;
+using Thresholds = schur_dispatcher::Thresholds;
+using SchurDispatcher = schur_dispatcher::SchurDispatcher<double>;
+using DynamicMatrix = SchurDispatcher::DynamicMatrix;
+using ComplexVector = SchurDispatcher::ComplexVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 60;
+constexpr const int matrix_size_max = 160;
+constexpr const int window_min_max = 24;
+
+void process_check_failed(const char* check, Path path, double delta,
+                          int test_id, int size) {
+  cout << "test failed in SchurDispatcher (" << check << ", "
+       << schur_dispatcher::path_name(path) << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+// Largest entry that breaks the quasi upper triangular form: anything
+// below the subdiagonal and the smaller of two adjacent subdiagonal entries.
+double distance_to_quasi_triangular(const DynamicMatrix& result) {
+  int size = result.rows();
+  double delta = 0;
+  for (int col = 0; col < size; ++col) {
+    for (int row = col + 2; row < size; ++row) {
+      delta = max(delta, abs(result(row, col)));
+    }
+    if (col + 2 < size) {
+      delta = max(delta, std::min(abs(result(col + 1, col)),
+                                  abs(result(col + 2, col + 1))));
+    }
+  }
+  return delta;
+}
+
+bool schur_dispatcher_check(const DynamicMatrix& data,
+                            const Thresholds& thresholds, Path expected,
+                            int test_id) {
+  int size = data.rows();
+  SchurDispatcher dispatcher(input_precision, thresholds);
+  DynamicMatrix result;
+  DynamicMatrix unitary;
+  dispatcher.run(data, &result, &unitary);
+  Path path = dispatcher.get_last_path();
+  if (path != expected) {
+    process_check_failed("path", path, 0, test_id, size);
+    return false;
+  }
+  double scale = max(norm(data), 1.);
+  double delta = distance_to_quasi_triangular(result) / scale;
+  if (delta > result_precision) {
+    process_check_failed("quasi triangular", path, delta, test_id, size);
+    return false;
+  }
+  delta = norm(unitary.transpose() * unitary -
+               DynamicMatrix::Identity(size, size));
+  if (delta > result_precision) {
+    process_check_failed("unitary", path, delta, test_id, size);
+    return false;
+  }
+  delta = norm(unitary * result * unitary.transpose() - data) / scale;
+  if (delta > result_precision) {
+    process_check_failed("restore", path, delta, test_id, size);
+    return false;
+  }
+  DynamicMatrix schur_form_only;
+  dispatcher.run(data, &schur_form_only, nullptr);
+  if (schur_form_only != result) {
+    process_check_failed("no unitary", path, norm(schur_form_only - result),
+                         test_id, size);
+    return false;
+  }
+  return true;
+}
+
+// Random matrices, and matrices that stall the plain Francis shift or split
+// into blocks from the start.
+DynamicMatrix make_matrix(int size, int kind) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  if (kind == 1) {
+    data.setZero();
+    for (int index = 0; index < size; ++index) {
+      data((index + 1) % size, index) = 1;
+    }
+  } else if (kind == 2) {
+    int half = size / 2;
+    data.block(half, 0, size - half, half).setZero();
+  }
+  return data;
+}
+
+bool run_configurations(const DynamicMatrix& data, int window_min,
+                        int test_id) {
+  int size = data.rows();
+  Thresholds defaults;
+  Path expected = size <= defaults.fixed_size_max ? Path::kFixedSize
+                  : size >= defaults.aggressive_size_min
+                      ? Path::kAggressiveDeflation
+                      : Path::kDoubleShift;
+  Thresholds aggressive;
+  aggressive.fixed_size_max = 0;
+  aggressive.aggressive_size_min = 0;
+  aggressive.window_min = window_min;
+  Thresholds double_shift;
+  double_shift.fixed_size_max = 0;
+  double_shift.aggressive_size_min = matrix_size_max + 1;
+  return schur_dispatcher_check(data, defaults, expected, test_id) &&
+         schur_dispatcher_check(data, aggressive, Path::kAggressiveDeflation,
+                                test_id) &&
+         schur_dispatcher_check(data, double_shift, Path::kDoubleShift,
+                                test_id);
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  std::uniform_int_distribution<int> tiny_sizes(
+      1, schur_dispatcher::fixed_size_limit);
+  std::uniform_int_distribution<int> windows(3, window_min_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    int size = test_id % 3 == 0 ? tiny_sizes(gen) : sizes(gen);
+    DynamicMatrix data = make_matrix(size, test_id % 4 == 1 ? test_id / 4 % 3
+                                                            : 0);
+    if (!run_configurations(data, windows(gen), test_id)) return;
+  }
+  cout << "Passed Schur dispatcher stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_schur_dispatcher
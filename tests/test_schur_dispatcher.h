@@ -0,0 +1,3 @@
+namespace test_schur_dispatcher {
+void run();
+}  // namespace test_schur_dispatcher
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../eigen/Eigen/Sparse"
+#include "../schur_decomposition/shift_invert.h"
+
+namespace test_shift_invert {
+
+using std::cout;
+using std::max;
+using ShiftInvertSolver = shift_invert::ShiftInvertSolver<double>;
+using SparseMatrix = ShiftInvertSolver::SparseMatrix;
+using DynamicMatrix = ShiftInvertSolver::DynamicMatrix;
+using DynamicVector = ShiftInvertSolver::DynamicVector;
+using Complex = ShiftInvertSolver::Complex;
+using ComplexVector = ShiftInvertSolver::ComplexVector;
+using ComplexMatrix = ShiftInvertSolver::ComplexMatrix;
+using Triplet = Eigen::Triplet<double>;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-8;
+constexpr const int number_of_tests = 60;
+constexpr const int matrix_size_max = 200;
+constexpr const int count_max = 6;
+constexpr const double density = 0.03;
+
+void process_check_failed(const char* check, double delta, int size,
+                          int test_id) {
+  cout << "test failed in ShiftInvertSolver (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+// A random sparse matrix with a nonzero diagonal, symmetric on request.
+SparseMatrix generate_matrix(int size, bool is_symmetric, std::mt19937* gen) {
+  std::uniform_int_distribution<int> indices(0, size - 1);
+  std::uniform_real_distribution<double> values(-1, 1);
+  std::vector<Triplet> entries;
+  for (int index = 0; index < size; ++index) {
+    entries.emplace_back(index, index, 4 * values(*gen));
+  }
+  int off_diagonal = std::max(1, int(density * size * size));
+  for (int entry = 0; entry < off_diagonal; ++entry) {
+    int row = indices(*gen);
+    int col = indices(*gen);
+    double value = values(*gen);
+    entries.emplace_back(row, col, value);
+    if (is_symmetric) {
+      entries.emplace_back(col, row, value);
+    }
+  }
+  SparseMatrix data(size, size);
+  data.setFromTriplets(entries.begin(), entries.end());
+  return data;
+}
+
+// The count reference eigenvalues nearest to shift must match the result
+// as multisets; the last of them is compared by distance only, since a tie
+// in distance may pick either of two eigenvalues.
+bool values_check(ComplexVector reference, const ComplexVector& result,
+                  double shift, double scale, int test_id) {
+  int size = reference.rows();
+  int count = result.rows();
+  std::sort(reference.data(), reference.data() + size,
+            [&](Complex left, Complex right) {
+              return std::abs(left - shift) < std::abs(right - shift);
+            });
+  std::vector<bool> is_matched(count, false);
+  for (int index = 0; index < count; ++index) {
+    double best = std::numeric_limits<double>::infinity();
+    int best_index = -1;
+    for (int other = 0; other < count; ++other) {
+      double distance = std::abs(reference(index) - result(other));
+      if (!is_matched[other] && distance < best) {
+        best = distance;
+        best_index = other;
+      }
+    }
+    double tail = std::abs(std::abs(reference(index) - shift) -
+                           std::abs(result(best_index) - shift));
+    if (best > result_precision * scale &&
+        !(index + 1 == count && tail <= result_precision * scale)) {
+      process_check_failed("eigenvalues", best / scale, size, test_id);
+      return false;
+    }
+    is_matched[best_index] = true;
+  }
+  return true;
+}
+
+bool symmetric_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> sizes(count_max + 1, matrix_size_max);
+  std::uniform_int_distribution<int> counts(1, count_max);
+  std::uniform_real_distribution<double> shifts(-2, 2);
+  int size = sizes(*gen);
+  int count = counts(*gen);
+  double shift = shifts(*gen);
+  SparseMatrix data = generate_matrix(size, true, gen);
+  DynamicMatrix dense = data;
+  double scale = max(norm(dense), 1.);
+  ShiftInvertSolver algorithm(input_precision);
+  DynamicVector eigenvalues;
+  DynamicMatrix eigenvectors;
+  algorithm.run_symmetric(data, shift, count, &eigenvalues, &eigenvectors);
+  if (!algorithm.is_converged() || eigenvalues.rows() != count) {
+    process_check_failed("convergence", 0, size, test_id);
+    return false;
+  }
+  double delta = norm(dense * eigenvectors -
+                      eigenvectors * eigenvalues.asDiagonal()) /
+                 scale;
+  if (delta > result_precision) {
+    process_check_failed("residual", delta, size, test_id);
+    return false;
+  }
+  Eigen::SelfAdjointEigenSolver<DynamicMatrix> reference(
+      dense, Eigen::EigenvaluesOnly);
+  return values_check(reference.eigenvalues().cast<Complex>(),
+                      eigenvalues.cast<Complex>(), shift, scale, test_id);
+}
+
+bool nonsymmetric_check(int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> sizes(count_max + 1, matrix_size_max);
+  std::uniform_int_distribution<int> counts(1, count_max);
+  std::uniform_real_distribution<double> shifts(-2, 2);
+  int size = sizes(*gen);
+  int count = counts(*gen);
+  double shift = shifts(*gen);
+  SparseMatrix data = generate_matrix(size, false, gen);
+  DynamicMatrix dense = data;
+  double scale = max(norm(dense), 1.);
+  ShiftInvertSolver algorithm(input_precision);
+  ComplexVector eigenvalues;
+  ComplexMatrix eigenvectors;
+  algorithm.run(data, shift, count, &eigenvalues, &eigenvectors);
+  if (!algorithm.is_converged() || eigenvalues.rows() != count) {
+    process_check_failed("convergence", 0, size, test_id);
+    return false;
+  }
+  ComplexMatrix residual = dense.cast<Complex>() * eigenvectors -
+                           eigenvectors * eigenvalues.asDiagonal();
+  double delta = residual.cwiseAbs().maxCoeff() / scale;
+  if (delta > result_precision) {
+    process_check_failed("residual", delta, size, test_id);
+    return false;
+  }
+  Eigen::EigenSolver<DynamicMatrix> reference(dense, false);
+  return values_check(reference.eigenvalues(), eigenvalues, shift, scale,
+                      test_id);
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    bool is_passed = test_id % 2 == 0 ? symmetric_check(test_id, &gen)
+                                      : nonsymmetric_check(test_id, &gen);
+    if (!is_passed) {
+      return;
+    }
+  }
+  cout << "Passed ShiftInvertSolver stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max count: " << count_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_shift_invert
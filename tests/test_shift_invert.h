@@ -0,0 +1,3 @@
+namespace test_shift_invert {
+void run();
+}  // namespace test_shift_invert
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/memory_policy.h"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/schur_decomposition_symmetric.h"
+#include "../schur_decomposition/solver_policy.h"
+
+namespace test_solver_policy {
+
+using std::abs;
+using std::cout;
+using std::max;
+using DefaultAllocator = memory_policy::DefaultAllocator<double>;
+using Algorithm = schur_decomposition::SchurDecomposition<double>;
+using EigenvaluesAlgorithm =
+    schur_decomposition::SchurDecomposition<double, DefaultAllocator,
+                                            solver_policy::SkipUnitary>;
+using ConservativeAlgorithm = schur_decomposition::SchurDecomposition<
+    double, DefaultAllocator, solver_policy::AccumulateUnitary,
+    solver_policy::ExceptionalDoubleShift<double>,
+    solver_policy::AhuesTisseurDeflation<double>>;
+using SymmetricAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<double>;
+using SymmetricEigenvaluesAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<
+        double, DefaultAllocator, solver_policy::SkipUnitary>;
+using SymmetricConservativeAlgorithm =
+    schur_decomposition_symmetric::SchurDecomposition<
+        double, DefaultAllocator, solver_policy::AccumulateUnitary,
+        solver_policy::WilkinsonShift<double>,
+        solver_policy::AhuesTisseurDeflation<double>>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+using DynamicVector = Algorithm::DynamicVector;
+using ComplexVector = Algorithm::ComplexVector;
+
+constexpr const double input_precision = 1e-12;
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 50;
+constexpr const int matrix_size_max = 60;
+constexpr const int permutation_size_max = 16;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int size) {
+  cout << "test failed in solver policies (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+// Largest entry below the subdiagonal, or on it next to another nonzero
+// subdiagonal entry.
+double distance_to_quasi_triangular(const DynamicMatrix& data) {
+  double delta = 0.;
+  for (int col = 0; col < data.cols(); ++col) {
+    for (int row = col + 2; row < data.rows(); ++row) {
+      delta = max(delta, abs(data(row, col)));
+    }
+    if (col + 2 < data.rows() && data(col + 1, col) != 0) {
+      delta = max(delta, abs(data(col + 2, col + 1)));
+    }
+  }
+  return delta;
+}
+
+// Eigenvalues-only instantiations do the same arithmetic as a run without a
+// unitary.
+bool skip_unitary_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  DynamicMatrix expected;
+  DynamicMatrix result;
+  Algorithm(input_precision).run(data, &expected);
+  EigenvaluesAlgorithm(input_precision).run(data, &result);
+  if (result != expected) {
+    process_check_failed("skipped unitary", norm(result - expected), test_id,
+                         size);
+    return false;
+  }
+  data += data.transpose().eval();
+  DynamicVector expected_eigenvalues;
+  DynamicVector eigenvalues;
+  SymmetricAlgorithm(input_precision).run(data, &expected_eigenvalues);
+  SymmetricEigenvaluesAlgorithm(input_precision).run(data, &eigenvalues);
+  if (eigenvalues != expected_eigenvalues) {
+    process_check_failed(
+        "skipped unitary, symmetric",
+        (eigenvalues - expected_eigenvalues).cwiseAbs().maxCoeff(), test_id,
+        size);
+    return false;
+  }
+  return true;
+}
+
+bool restore_check(const DynamicMatrix& data, int test_id) {
+  DynamicMatrix schur_form;
+  DynamicMatrix unitary;
+  ConservativeAlgorithm(input_precision).run(data, &schur_form, &unitary);
+  double delta = max(norm(data - unitary * schur_form * unitary.transpose()),
+                     distance_to_quasi_triangular(schur_form));
+  if (delta > result_precision) {
+    process_check_failed("conservative policies", delta, test_id,
+                         data.rows());
+    return false;
+  }
+  return true;
+}
+
+bool symmetric_restore_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  data += data.transpose().eval();
+  DynamicVector eigenvalues;
+  DynamicMatrix unitary;
+  SymmetricConservativeAlgorithm(input_precision)
+      .run(data, &eigenvalues, &unitary);
+  double delta = norm(data - unitary * eigenvalues.asDiagonal() *
+                                 unitary.transpose());
+  if (delta > result_precision) {
+    process_check_failed("conservative policies, symmetric", delta, test_id,
+                         size);
+    return false;
+  }
+  return true;
+}
+
+// The cyclic shift has its eigenvalues on the unit circle, symmetric about
+// zero for even sizes, and is a fixed point of plain double shift sweeps.
+bool permutation_check(int size, int test_id) {
+  DynamicMatrix data = DynamicMatrix::Zero(size, size);
+  for (int index = 0; index < size; ++index) {
+    data((index + 1) % size, index) = 1;
+  }
+  DynamicMatrix schur_form;
+  DynamicMatrix unitary;
+  ConservativeAlgorithm(input_precision).run(data, &schur_form, &unitary);
+  ComplexVector eigenvalues;
+  ConservativeAlgorithm::extract_eigenvalues(schur_form, &eigenvalues);
+  double delta = (eigenvalues.cwiseAbs().array() - 1.).abs().maxCoeff();
+  if (delta > result_precision) {
+    process_check_failed("exceptional shifts", delta, test_id, size);
+    return false;
+  }
+  return restore_check(data, test_id);
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(3, matrix_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    int size = sizes(gen);
+    if (!skip_unitary_check(size, test_id)) return;
+    if (!restore_check(DynamicMatrix::Random(size, size), test_id)) return;
+    if (!symmetric_restore_check(size, test_id)) return;
+  }
+  for (int size = 3; size <= permutation_size_max; ++size) {
+    if (!permutation_check(size, size)) return;
+  }
+  cout << "Passed solver policy stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max permutation size: " << permutation_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_solver_policy
@@ -0,0 +1,3 @@
+namespace test_solver_policy {
+void run();
+}  // namespace test_solver_policy
@@ -0,0 +1,166 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/spectral_density.h"
+
+namespace test_spectral_density {
+
+using std::abs;
+using std::cout;
+using KernelPolynomialMethod =
+    spectral_density::KernelPolynomialMethod<double>;
+using StochasticLanczosQuadrature =
+    spectral_density::StochasticLanczosQuadrature<double>;
+using Histogram = spectral_density::Histogram<double>;
+using Bounds = spectral_density::Bounds<double>;
+using Operator = spectral_density::Operator<double>;
+using DynamicMatrix = Eigen::MatrixXd;
+using DynamicVector = Eigen::VectorXd;
+
+constexpr const int laplacian_size = 20000;
+constexpr const int dense_size = 400;
+constexpr const int number_of_tests = 3;
+constexpr const int bins = 20;
+constexpr const int moments = 200;
+constexpr const int lanczos_steps = 100;
+constexpr const int probes = 16;
+constexpr const int number_of_threads = 4;
+constexpr const double result_precision = 0.1;
+
+void process_histogram_check_failed(const char* method,
+                                    const Histogram& expected,
+                                    const Histogram& result, double delta,
+                                    int test_id, int size) {
+  cout << "test failed in " << method << "::run():\n\n";
+  cout << "expected counts:\n" << expected.counts.transpose() << "\n\n";
+  cout << "estimated counts:\n" << result.counts.transpose() << "\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_bounds_check_failed(const Bounds& bounds, double lower,
+                                 double upper, int test_id) {
+  cout << "test failed in spectral_density::estimate_bounds():\n\n";
+  cout << "spectrum:\t[" << lower << ", " << upper << "]\n";
+  cout << "bounds:\t[" << bounds.lower << ", " << bounds.upper << "]\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+void process_thread_check_failed(int test_id) {
+  cout << "test failed in KernelPolynomialMethod::run():\n\n";
+  cout << "result depends on the number of threads\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+Histogram count_eigenvalues(const DynamicVector& eigenvalues, double lower,
+                            double upper) {
+  Histogram histogram(lower, upper, bins);
+  for (int i = 0; i < eigenvalues.rows(); ++i) {
+    int bin = (eigenvalues(i) - lower) / histogram.get_bin_width();
+    histogram.counts(std::clamp(bin, 0, bins - 1)) += 1;
+  }
+  return histogram;
+}
+
+// Sum of the count errors relative to the number of eigenvalues.
+double histogram_error(const Histogram& expected, const Histogram& result) {
+  return (expected.counts - result.counts).cwiseAbs().sum() /
+         expected.counts.sum();
+}
+
+bool histograms_check(const Operator& apply, const DynamicVector& eigenvalues,
+                      int test_id) {
+  int size = eigenvalues.rows();
+  double lower = eigenvalues.minCoeff();
+  double upper = eigenvalues.maxCoeff();
+  Bounds bounds = spectral_density::estimate_bounds<double>(apply, size);
+  if (bounds.lower > lower + 1e-8 || bounds.upper < upper - 1e-8) {
+    process_bounds_check_failed(bounds, lower, upper, test_id);
+    return false;
+  }
+  Histogram expected = count_eigenvalues(eigenvalues, lower, upper);
+
+  Histogram kpm(lower, upper, bins);
+  KernelPolynomialMethod(moments, probes, number_of_threads, test_id)
+      .run(apply, size, bounds, &kpm);
+  double delta = histogram_error(expected, kpm);
+  if (delta > result_precision) {
+    process_histogram_check_failed("KernelPolynomialMethod", expected, kpm,
+                                   delta, test_id, size);
+    return false;
+  }
+  Histogram serial(lower, upper, bins);
+  KernelPolynomialMethod(moments, probes, 1, test_id)
+      .run(apply, size, bounds, &serial);
+  if (serial.counts != kpm.counts) {
+    process_thread_check_failed(test_id);
+    return false;
+  }
+
+  Histogram slq(lower, upper, bins);
+  StochasticLanczosQuadrature(lanczos_steps, probes, 1e-12, number_of_threads,
+                              test_id)
+      .run(apply, size, &slq);
+  delta = histogram_error(expected, slq);
+  if (delta > result_precision) {
+    process_histogram_check_failed("StochasticLanczosQuadrature", expected,
+                                   slq, delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+// The path graph Laplacian has eigenvalues 2 - 2 cos(k pi / (n + 1)).
+bool laplacian_check(int test_id) {
+  Operator apply = [](const DynamicVector& input, DynamicVector* output) {
+    int size = input.rows();
+    output->resize(size);
+    for (int i = 0; i < size; ++i) {
+      (*output)(i) = 2 * input(i) - (i > 0 ? input(i - 1) : 0.) -
+                     (i + 1 < size ? input(i + 1) : 0.);
+    }
+  };
+  DynamicVector eigenvalues(laplacian_size);
+  double pi = std::acos(-1.);
+  for (int k = 1; k <= laplacian_size; ++k) {
+    eigenvalues(k - 1) = 2 - 2 * std::cos(k * pi / (laplacian_size + 1));
+  }
+  return histograms_check(apply, eigenvalues, test_id);
+}
+
+// Two clusters hidden by a random orthogonal basis.
+bool dense_check(int test_id) {
+  DynamicVector eigenvalues = DynamicVector::Random(dense_size);
+  eigenvalues.head(dense_size / 4).array() += 3;
+  DynamicMatrix basis = Eigen::HouseholderQR<DynamicMatrix>(
+                            DynamicMatrix::Random(dense_size, dense_size))
+                            .householderQ();
+  DynamicMatrix data =
+      basis * eigenvalues.asDiagonal() * basis.transpose();
+  Operator apply = [&](const DynamicVector& input, DynamicVector* output) {
+    output->noalias() = data * input;
+  };
+  return histograms_check(apply, eigenvalues, test_id);
+}
+
+void run_stress_testing() {
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!laplacian_check(test_id)) return;
+    if (!dense_check(test_id)) return;
+  }
+  cout << "Passed spectral density stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Matrix sizes: " << laplacian_size << " (matrix-free), "
+       << dense_size << "\n";
+  cout << "Moments: " << moments << ", Lanczos steps: " << lanczos_steps
+       << ", probes: " << probes << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_spectral_density
@@ -0,0 +1,3 @@
+namespace test_spectral_density {
+void run();
+}  // namespace test_spectral_density
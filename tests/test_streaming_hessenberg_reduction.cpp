@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/hessenberg_reduction.h"
+#include "../schur_decomposition/streaming_hessenberg_reduction.h"
+
+namespace test_streaming_hessenberg_reduction {
+
+using std::abs;
+using std::cout;
+using std::max;
+using Streaming =
+    streaming_hessenberg_reduction::StreamingHessenbergReduction<double>;
+using HessenbergReduction = Streaming::HessenbergReduction;
+using DynamicMatrix = Streaming::DynamicMatrix;
+using PanelSource = Streaming::PanelSource;
+
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 100;
+constexpr const int matrix_size_max = 80;
+constexpr const int panel_width_max = 12;
+constexpr const int queue_capacity_max = 3;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int size) {
+  cout << "test failed in StreamingHessenbergReduction (" << check
+       << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const DynamicMatrix& data) {
+  double max_element = 0.;
+  for (int i = 0; i < data.rows(); ++i) {
+    for (int j = 0; j < data.cols(); ++j)
+      max_element = max(abs(data(i, j)), max_element);
+  }
+  return max_element;
+}
+
+double distance_to_hessenberg(const DynamicMatrix& data) {
+  double delta = 0.;
+  for (int col = 0; col < data.cols(); ++col) {
+    for (int row = col + 2; row < data.rows(); ++row) {
+      delta = max(delta, abs(data(row, col)));
+    }
+  }
+  return delta;
+}
+
+// Delivers data in panels of random widths.
+PanelSource make_source(const DynamicMatrix& data, std::mt19937* gen) {
+  return [&data, gen, first = 0](DynamicMatrix* panel) mutable {
+    if (first == data.cols()) {
+      return false;
+    }
+    std::uniform_int_distribution<int> widths(1, panel_width_max);
+    int width = std::min(widths(*gen), int(data.cols()) - first);
+    *panel = data.middleCols(first, width);
+    first += width;
+    return true;
+  };
+}
+
+bool streaming_check(int size, int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> capacities(1, queue_capacity_max);
+  DynamicMatrix data = DynamicMatrix::Random(size, size);
+  Streaming streaming(capacities(*gen));
+  DynamicMatrix result;
+  DynamicMatrix backtrace;
+  streaming.run(size, make_source(data, gen), &result, &backtrace);
+  double delta = max(norm(data - backtrace * result * backtrace.transpose()),
+                     distance_to_hessenberg(result));
+  if (delta > result_precision) {
+    process_check_failed("restore", delta, test_id, size);
+    return false;
+  }
+  DynamicMatrix expected = data;
+  HessenbergReduction().run(&expected, nullptr);
+  DynamicMatrix eigenvalues_only;
+  streaming.run(size, make_source(data, gen), &eigenvalues_only, nullptr);
+  delta = max(norm(result - expected), norm(eigenvalues_only - expected));
+  if (delta > result_precision) {
+    process_check_failed("batch reduction", delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!streaming_check(sizes(gen), test_id, &gen)) return;
+  }
+  cout << "Passed streaming Hessenberg reduction stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Max panel width: " << panel_width_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_streaming_hessenberg_reduction
@@ -0,0 +1,3 @@
+namespace test_streaming_hessenberg_reduction {
+void run();
+}  // namespace test_streaming_hessenberg_reduction
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <random>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/symmetric_driver.h"
+
+namespace test_symmetric_driver {
+
+using std::cout;
+using std::max;
+using Crossovers = symmetric_driver::Crossovers;
+using Engine = symmetric_driver::Engine;
+using SymmetricDriver = symmetric_driver::SymmetricDriver<double>;
+using DynamicMatrix = SymmetricDriver::DynamicMatrix;
+using DynamicVector = SymmetricDriver::DynamicVector;
+
+constexpr const double result_precision = 1e-9;
+constexpr const double algorithm_precision = 1e-12;
+constexpr const int number_of_tests = 40;
+constexpr const int matrix_size_max = 80;
+constexpr const int number_of_threads = 4;
+
+void process_check_failed(const char* check, Engine engine, double delta,
+                          int test_id, int size) {
+  cout << "test failed in SymmetricDriver (" << check << ", "
+       << symmetric_driver::engine_name(engine) << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+// Crossovers that make choose_engine() pick engine for any request of the
+// matching kind; kBisection needs a request without vectors and kCompactQR
+// one with vectors.
+Crossovers force(Engine engine) {
+  Crossovers crossovers;
+  crossovers.jacobi_size_max = engine == Engine::kJacobi ? 1 << 30 : 0;
+  crossovers.jacobi_offdiagonal_ratio = 0;
+  crossovers.bisection_fraction = engine == Engine::kBisection ? 1 : -1;
+  crossovers.compact_fraction = engine == Engine::kCompactQR ? 1 : -1;
+  crossovers.pipelined_size_min =
+      engine == Engine::kPipelinedQR ? 0 : 1 << 30;
+  return crossovers;
+}
+
+double norm(const DynamicMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+bool symmetric_driver_check(const DynamicMatrix& data, Engine engine,
+                            bool vectors, int test_id, std::mt19937* gen) {
+  int size = data.rows();
+  std::uniform_int_distribution<int> firsts(0, size);
+  int first = firsts(*gen);
+  std::uniform_int_distribution<int> counts(0, size - first);
+  int count = counts(*gen);
+  SymmetricDriver driver(algorithm_precision, force(engine),
+                         number_of_threads);
+  DynamicVector eigenvalues;
+  DynamicMatrix eigenvectors;
+  driver.run(data, &eigenvalues, vectors ? &eigenvectors : nullptr, first,
+             count);
+  if (driver.get_last_engine() != engine) {
+    process_check_failed("choice", driver.get_last_engine(), 0, test_id,
+                         size);
+    return false;
+  }
+  Eigen::SelfAdjointEigenSolver<DynamicMatrix> solver(
+      data, Eigen::EigenvaluesOnly);
+  DynamicVector expected = solver.eigenvalues().segment(first, count);
+  double scale = max(norm(data), 1.);
+  double delta = norm(eigenvalues - expected) / scale;
+  if (eigenvalues.rows() != count || delta > result_precision) {
+    process_check_failed("eigenvalues", engine, delta, test_id, size);
+    return false;
+  }
+  if (!vectors) {
+    return true;
+  }
+  DynamicMatrix residual =
+      data * eigenvectors - eigenvectors * eigenvalues.asDiagonal();
+  DynamicMatrix gram = eigenvectors.transpose() * eigenvectors;
+  delta = max(norm(residual) / scale,
+              norm(gram - DynamicMatrix::Identity(count, count)));
+  if (eigenvectors.rows() != size || delta > result_precision) {
+    process_check_failed("eigenvectors", engine, delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+bool default_choice_check(int test_id) {
+  SymmetricDriver driver(algorithm_precision, Crossovers(), 1);
+  DynamicMatrix data = DynamicMatrix::Random(100, 100);
+  data += data.transpose().eval();
+  DynamicMatrix diagonal = DynamicMatrix::Identity(100, 100) * 10.;
+  diagonal(0, 1) = diagonal(1, 0) = 1e-3;
+  Engine expected[] = {Engine::kJacobi, Engine::kJacobi, Engine::kBisection,
+                       Engine::kCompactQR, Engine::kImplicitQR};
+  Engine chosen[] = {driver.choose_engine(data.topLeftCorner(3, 3), 3, true),
+                     driver.choose_engine(diagonal, 100, true),
+                     driver.choose_engine(data, 5, false),
+                     driver.choose_engine(data, 100, true),
+                     driver.choose_engine(data, 100, false)};
+  for (int index = 0; index < 5; ++index) {
+    if (chosen[index] != expected[index]) {
+      process_check_failed("default choice", chosen[index], 0, test_id, 100);
+      return false;
+    }
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  // A matrix of size 1 is diagonal, which always goes to Jacobi.
+  std::uniform_int_distribution<int> sizes(2, matrix_size_max);
+  Engine engines[] = {Engine::kJacobi, Engine::kImplicitQR, Engine::kCompactQR,
+                      Engine::kPipelinedQR, Engine::kBisection};
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    int size = sizes(gen);
+    DynamicMatrix data = DynamicMatrix::Random(size, size);
+    data += data.transpose().eval();
+    for (Engine engine : engines) {
+      for (bool vectors : {false, true}) {
+        if ((engine == Engine::kBisection && vectors) ||
+            (engine == Engine::kCompactQR && !vectors)) {
+          continue;
+        }
+        if (!symmetric_driver_check(data, engine, vectors, test_id, &gen)) {
+          return;
+        }
+      }
+    }
+  }
+  if (!default_choice_check(number_of_tests + 1)) return;
+  cout << "Passed symmetric driver stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Number of threads: " << number_of_threads << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_symmetric_driver
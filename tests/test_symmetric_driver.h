@@ -0,0 +1,3 @@
+namespace test_symmetric_driver {
+void run();
+}  // namespace test_symmetric_driver
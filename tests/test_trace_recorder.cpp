@@ -0,0 +1,128 @@
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/schur_decomposition.h"
+#include "../schur_decomposition/trace_recorder.h"
+
+namespace test_trace_recorder {
+
+using std::cout;
+using std::string;
+using trace_recorder::ThreadBuffer;
+using trace_recorder::TraceRecorder;
+using trace_recorder::TraceSpan;
+using Algorithm = schur_decomposition::SchurDecomposition<double>;
+using DynamicMatrix = Algorithm::DynamicMatrix;
+
+constexpr const double input_precision = 1e-12;
+constexpr const int matrix_size = 20;
+constexpr const int number_of_threads = 4;
+
+int count_occurrences(const string& text, const string& pattern) {
+  int count = 0;
+  for (size_t pos = text.find(pattern); pos != string::npos;
+       pos = text.find(pattern, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+string export_trace() {
+  std::ostringstream out;
+  TraceRecorder::instance().export_chrome_trace(out);
+  return out.str();
+}
+
+void process_check_failed(const char* check, const string& trace) {
+  cout << "test failed in TraceRecorder (" << check << "):\n\n";
+  cout << "exported trace:\n" << trace.substr(0, 2000) << "\n";
+}
+
+bool solver_spans_check() {
+  DynamicMatrix data = DynamicMatrix::Random(matrix_size, matrix_size);
+  DynamicMatrix result;
+  DynamicMatrix backtrace;
+  Algorithm algorithm(input_precision);
+  algorithm.run(data, &result, &backtrace);
+  string trace = export_trace();
+  const char* expected[] = {"\"schur decomposition\"",
+                            "\"hessenberg reduction\"", "\"trailing update\"",
+                            "\"bulge chase\"", "\"deflation window\""};
+  for (const char* name : expected) {
+    if (count_occurrences(trace, name) == 0) {
+      process_check_failed(name, trace);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool disabled_check() {
+  TraceRecorder::instance().disable();
+  { TraceSpan span("ignored", "test"); }
+  TraceRecorder::instance().enable();
+  string trace = export_trace();
+  if (count_occurrences(trace, "\"ignored\"") != 0) {
+    process_check_failed("disabled recorder", trace);
+    return false;
+  }
+  return true;
+}
+
+bool ring_buffer_check() {
+  for (size_t index = 0; index < ThreadBuffer::capacity + 10; ++index) {
+    TraceSpan span("ring", "test");
+  }
+  string trace = export_trace();
+  if (count_occurrences(trace, "\"ring\"") != int(ThreadBuffer::capacity)) {
+    process_check_failed("ring buffer overwrite", trace);
+    return false;
+  }
+  return true;
+}
+
+bool threads_check() {
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < number_of_threads; ++thread) {
+    threads.emplace_back([] { TraceSpan span("worker", "test"); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  string trace = export_trace();
+  string last_tid = "\"tid\":" + std::to_string(number_of_threads);
+  if (count_occurrences(trace, "\"worker\"") != number_of_threads ||
+      count_occurrences(trace, last_tid) == 0) {
+    process_check_failed("per-thread buffers", trace);
+    return false;
+  }
+  return true;
+}
+
+void run_testing() {
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.clear();
+  recorder.enable();
+  bool passed = solver_spans_check();
+  recorder.clear();
+  passed = passed && disabled_check();
+  recorder.clear();
+  passed = passed && ring_buffer_check();
+  recorder.clear();
+  passed = passed && threads_check();
+  recorder.disable();
+  recorder.clear();
+  if (!passed) return;
+
+  cout << "Passed TraceRecorder testing\n";
+  cout << "Ring buffer capacity: " << ThreadBuffer::capacity << "\n";
+  cout << "Number of threads: " << number_of_threads << "\n\n\n";
+}
+
+void run() { run_testing(); }
+
+}  // namespace test_trace_recorder
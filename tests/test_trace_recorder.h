@@ -0,0 +1,3 @@
+namespace test_trace_recorder {
+void run();
+}  // namespace test_trace_recorder
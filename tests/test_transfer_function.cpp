@@ -0,0 +1,106 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/transfer_function.h"
+
+namespace test_transfer_function {
+
+using std::abs;
+using std::cout;
+using std::max;
+using TransferFunction = transfer_function::TransferFunction<double>;
+using DynamicMatrix = TransferFunction::DynamicMatrix;
+using Complex = TransferFunction::Complex;
+using ComplexMatrix = TransferFunction::ComplexMatrix;
+using ComplexVector = TransferFunction::ComplexVector;
+
+constexpr const double result_precision = 1e-9;
+constexpr const int number_of_tests = 50;
+constexpr const int matrix_size_max = 60;
+constexpr const int ports_max = 4;
+constexpr const int number_of_frequencies = 32;
+constexpr const int number_of_threads = 4;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int size) {
+  cout << "test failed in TransferFunction (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+double norm(const ComplexMatrix& data) {
+  return data.size() == 0 ? 0. : data.cwiseAbs().maxCoeff();
+}
+
+// Dense LU of shift I - A, the computation the engine replaces.
+ComplexMatrix solve_dense(const DynamicMatrix& state, Complex shift,
+                          const ComplexMatrix& rhs) {
+  ComplexMatrix shifted = -state.cast<Complex>();
+  shifted.diagonal().array() += shift;
+  return shifted.partialPivLu().solve(rhs);
+}
+
+bool transfer_function_check(int size, int test_id, std::mt19937* gen) {
+  std::uniform_int_distribution<int> ports(1, ports_max);
+  std::uniform_real_distribution<double> parts(-2., 2.);
+  DynamicMatrix state = DynamicMatrix::Random(size, size);
+  DynamicMatrix input = DynamicMatrix::Random(size, ports(*gen));
+  DynamicMatrix output = DynamicMatrix::Random(ports(*gen), size);
+  ComplexVector frequencies(number_of_frequencies);
+  for (int index = 0; index < number_of_frequencies; ++index) {
+    frequencies(index) = Complex(parts(*gen), parts(*gen));
+  }
+  TransferFunction function(state, input, output, number_of_threads);
+  std::vector<ComplexMatrix> responses;
+  function.evaluate(frequencies, &responses);
+  TransferFunction serial(state, input, output, 1);
+  for (int index = 0; index < number_of_frequencies; ++index) {
+    ComplexMatrix expected =
+        output.cast<Complex>() *
+        solve_dense(state, frequencies(index), input.cast<Complex>());
+    double delta = norm(responses[index] - expected) / max(norm(expected), 1.);
+    if (delta > result_precision) {
+      process_check_failed("response", delta, test_id, size);
+      return false;
+    }
+    ComplexMatrix response;
+    serial.evaluate(frequencies(index), &response);
+    if (response != responses[index]) {
+      process_check_failed("threads", norm(response - responses[index]),
+                           test_id, size);
+      return false;
+    }
+  }
+  ComplexMatrix rhs = ComplexMatrix::Random(size, ports(*gen));
+  ComplexMatrix solution;
+  function.solve(frequencies(0), rhs, &solution);
+  ComplexMatrix expected = solve_dense(state, frequencies(0), rhs);
+  double delta = norm(solution - expected) / max(norm(expected), 1.);
+  if (delta > result_precision) {
+    process_check_failed("shifted solve", delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    srand(test_id);
+    if (!transfer_function_check(sizes(gen), test_id, &gen)) return;
+  }
+  cout << "Passed transfer function stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Frequencies per test: " << number_of_frequencies << "\n";
+  cout << "Number of threads: " << number_of_threads << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_transfer_function
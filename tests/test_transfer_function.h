@@ -0,0 +1,3 @@
+namespace test_transfer_function {
+void run();
+}  // namespace test_transfer_function
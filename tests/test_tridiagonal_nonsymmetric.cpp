@@ -0,0 +1,153 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../eigen/Eigen/Dense"
+#include "../schur_decomposition/tridiagonal_nonsymmetric.h"
+
+namespace test_tridiagonal_nonsymmetric {
+
+using std::abs;
+using std::cout;
+using std::max;
+using AberthSolver = tridiagonal_nonsymmetric::AberthSolver<double>;
+using TridiagonalNonsymmetric = AberthSolver::TridiagonalNonsymmetric;
+using DynamicMatrix = TridiagonalNonsymmetric::DynamicMatrix;
+using DynamicVector = TridiagonalNonsymmetric::DynamicVector;
+using ComplexVector = AberthSolver::ComplexVector;
+
+constexpr const double input_precision = 1e-14;
+constexpr const double result_precision = 1e-10;
+constexpr const int number_of_tests = 200;
+constexpr const int matrix_size_max = 120;
+
+void process_check_failed(const char* check, double delta, int test_id,
+                          int size) {
+  cout << "test failed in AberthSolver (" << check << "):\n\n";
+  cout << "delta = " << delta << "\n";
+  cout << "size:\t" << size << "\n";
+  cout << "test id:\t" << test_id << "\n";
+}
+
+// Largest distance from an expected eigenvalue to the computed one it is
+// matched with, each computed one being matched once.
+double match_eigenvalues(const ComplexVector& expected,
+                         const ComplexVector& computed) {
+  std::vector<bool> used(computed.rows(), false);
+  double delta = 0;
+  for (int index = 0; index < expected.rows(); ++index) {
+    int best = -1;
+    for (int other = 0; other < computed.rows(); ++other) {
+      if (!used[other] &&
+          (best < 0 || abs(computed(other) - expected(index)) <
+                           abs(computed(best) - expected(index)))) {
+        best = other;
+      }
+    }
+    used[best] = true;
+    delta = max(delta, abs(computed(best) - expected(index)));
+  }
+  return delta;
+}
+
+// Random side diagonals, side diagonals whose products are all positive
+// (real spectrum), side diagonals with zeros that split the matrix, and
+// Toeplitz matrices, whose halves have equal eigenvalues.
+TridiagonalNonsymmetric make_matrix(int size, int kind, std::mt19937* gen) {
+  std::uniform_real_distribution<double> entries(-1, 1);
+  TridiagonalNonsymmetric data(size);
+  if (kind == 3) {
+    data.get_major_diagonal().setConstant(entries(*gen));
+    data.get_upper_diagonal().setConstant(entries(*gen));
+    data.get_lower_diagonal().setConstant(entries(*gen));
+    return data;
+  }
+  for (int index = 0; index < size; ++index) {
+    data.get_major_diagonal()(index) = entries(*gen);
+    if (index + 1 == size) {
+      break;
+    }
+    double upper = entries(*gen);
+    double lower = entries(*gen);
+    if (kind == 1) {
+      lower = upper > 0 ? abs(lower) : -abs(lower);
+    } else if (kind == 2 && index % 5 == 4) {
+      (index % 2 ? upper : lower) = 0;
+    }
+    data.get_upper_diagonal()(index) = upper;
+    data.get_lower_diagonal()(index) = lower;
+  }
+  return data;
+}
+
+bool is_toeplitz(const TridiagonalNonsymmetric& data) {
+  auto is_constant = [](const DynamicVector& diagonal) {
+    return diagonal.rows() == 0 ||
+           (diagonal.array() == diagonal(0)).all();
+  };
+  return is_constant(data.get_major_diagonal()) &&
+         is_constant(data.get_upper_diagonal()) &&
+         is_constant(data.get_lower_diagonal());
+}
+
+// a + 2 sqrt(b c) cos(k pi / (n + 1)). The eigenvectors of a Toeplitz
+// matrix with |b| != |c| are so ill-conditioned that a dense solver cannot
+// serve as the reference, while the eigenvalues depend on b c alone.
+ComplexVector toeplitz_eigenvalues(const TridiagonalNonsymmetric& data) {
+  int size = data.get_size();
+  double product = size == 1 ? 0
+                             : data.get_upper_diagonal()(0) *
+                                   data.get_lower_diagonal()(0);
+  std::complex<double> root = std::sqrt(std::complex<double>(product));
+  ComplexVector eigenvalues(size);
+  for (int index = 0; index < size; ++index) {
+    eigenvalues(index) = data.get_major_diagonal()(0) +
+                         2. * root * std::cos((index + 1) * M_PI / (size + 1));
+  }
+  return eigenvalues;
+}
+
+bool aberth_solver_check(const TridiagonalNonsymmetric& data, int test_id) {
+  int size = data.get_size();
+  AberthSolver solver(input_precision);
+  ComplexVector eigenvalues;
+  solver.run(data, &eigenvalues);
+  if (!solver.is_converged()) {
+    process_check_failed("convergence", solver.get_iterations(), test_id,
+                         size);
+    return false;
+  }
+  DynamicMatrix dense = data.to_dense();
+  ComplexVector expected = is_toeplitz(data)
+                               ? toeplitz_eigenvalues(data)
+                               : Eigen::EigenSolver<DynamicMatrix>(dense, false)
+                                     .eigenvalues();
+  double scale = max(dense.cwiseAbs().maxCoeff(), 1.);
+  double delta = eigenvalues.rows() == size
+                     ? match_eigenvalues(expected, eigenvalues) / scale
+                     : 1.;
+  if (delta > result_precision) {
+    process_check_failed("eigenvalues", delta, test_id, size);
+    return false;
+  }
+  return true;
+}
+
+void run_stress_testing() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> sizes(1, matrix_size_max);
+  for (int test_id = 1; test_id <= number_of_tests; ++test_id) {
+    int size = sizes(gen);
+    if (!aberth_solver_check(make_matrix(size, test_id % 4, &gen), test_id)) {
+      return;
+    }
+  }
+  cout << "Passed AberthSolver stress testing\n";
+  cout << "Number of tests: " << number_of_tests << "\n";
+  cout << "Max matrix size: " << matrix_size_max << "\n";
+  cout << "Result precision: " << result_precision << "\n\n\n";
+}
+
+void run() { run_stress_testing(); }
+
+}  // namespace test_tridiagonal_nonsymmetric
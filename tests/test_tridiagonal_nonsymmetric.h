@@ -0,0 +1,3 @@
+namespace test_tridiagonal_nonsymmetric {
+void run();
+}  // namespace test_tridiagonal_nonsymmetric
@@ -1,8 +1,32 @@
+#include "test_batch_executor.h"
+#include "test_compact_eigenbasis.h"
+#include "test_diagonal_plus_low_rank.h"
 #include "test_givens_rotator.h"
+#include "test_hamiltonian_schur_decomposition.h"
 #include "test_hessenberg_reduction.h"
 #include "test_householder_reflector.h"
+#include "test_joint_diagonalization.h"
+#include "test_kronecker_operator.h"
+#include "test_memory_budget.h"
+#include "test_memory_policy.h"
+#include "test_metrics_registry.h"
+#include "test_pca_pipeline.h"
+#include "test_periodic_schur_decomposition.h"
+#include "test_pipelined_tridiagonal_qr.h"
+#include "test_quadratic_eigenvalue.h"
+#include "test_schur_continuation.h"
 #include "test_schur_decomposition.h"
+#include "test_schur_decomposition_skew_symmetric.h"
 #include "test_schur_decomposition_symmetric.h"
+#include "test_schur_dispatcher.h"
+#include "test_shift_invert.h"
+#include "test_solver_policy.h"
+#include "test_spectral_density.h"
+#include "test_streaming_hessenberg_reduction.h"
+#include "test_symmetric_driver.h"
+#include "test_trace_recorder.h"
+#include "test_tridiagonal_nonsymmetric.h"
+#include "test_transfer_function.h"
 
 void run_all_tests() {
   test_givens_rotator::run();
@@ -10,4 +34,28 @@ void run_all_tests() {
   test_hessenberg_reduction::run();
   test_schur_decomposition::run();
   test_schur_decomposition_symmetric::run();
+  test_memory_policy::run();
+  test_trace_recorder::run();
+  test_memory_budget::run();
+  test_schur_continuation::run();
+  test_spectral_density::run();
+  test_periodic_schur_decomposition::run();
+  test_hamiltonian_schur_decomposition::run();
+  test_schur_decomposition_skew_symmetric::run();
+  test_compact_eigenbasis::run();
+  test_pipelined_tridiagonal_qr::run();
+  test_metrics_registry::run();
+  test_solver_policy::run();
+  test_transfer_function::run();
+  test_streaming_hessenberg_reduction::run();
+  test_kronecker_operator::run();
+  test_pca_pipeline::run();
+  test_symmetric_driver::run();
+  test_schur_dispatcher::run();
+  test_tridiagonal_nonsymmetric::run();
+  test_batch_executor::run();
+  test_joint_diagonalization::run();
+  test_quadratic_eigenvalue::run();
+  test_diagonal_plus_low_rank::run();
+  test_shift_invert::run();
 }